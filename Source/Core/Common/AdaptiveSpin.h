@@ -0,0 +1,101 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// Spin-then-block helper for a thread waiting on an event that another thread sets.
+// Blocking costs a wakeup of tens of microseconds on some systems, which adds up when two threads
+// hand work back and forth many times per frame. So the waiting thread first spins for a while,
+// yielding its time slice in between, and only blocks when the other side takes longer.
+//
+// The spin limit never exceeds the measured wakeup latency, so a wait costs at most about twice
+// what blocking right away would. It grows whenever the event was set shortly after the thread
+// started blocking, and shrinks when the thread blocked for longer, so an idle thread quickly
+// goes back to blocking right away.
+//
+// Spin and Block must only be called by a single waiting thread at a time.
+class AdaptiveSpin
+{
+public:
+  // Spins until done() returns true or the spin limit runs out. Returns false in the latter case,
+  // after which the caller should Block.
+  template <typename Predicate>
+  bool Spin(Predicate done)
+  {
+    if (done())
+      return true;
+
+    const s64 start = Now();
+    bool success = false;
+    do
+    {
+      std::this_thread::yield();
+      success = done();
+    } while (!success && Now() - start < m_limit_ns);
+
+    m_wait_time_ns.fetch_add(static_cast<u64>(Now() - start), std::memory_order_relaxed);
+    return success;
+  }
+
+  // Calls block(), which has to wait for the event, and adapts the spin limit to how it went.
+  template <typename Function>
+  void Block(Function block)
+  {
+    const s64 start = Now();
+    block();
+    const s64 end = Now();
+    m_wait_time_ns.fetch_add(static_cast<u64>(end - start), std::memory_order_relaxed);
+
+    s64 idle = end - start;
+    const s64 notified = m_notify_time_ns.load(std::memory_order_relaxed);
+    if (notified >= start && notified <= end)
+    {
+      m_latency_ns += (end - notified - m_latency_ns) / 8;
+      idle = notified - start;
+    }
+
+    if (idle < m_latency_ns)
+    {
+      const s64 max_limit = std::min(m_latency_ns, s64{MAX_LIMIT_NS});
+      m_limit_ns = std::min(std::max(m_limit_ns * 2, s64{MIN_LIMIT_NS}), max_limit);
+    }
+    else
+    {
+      m_limit_ns /= 2;
+    }
+  }
+
+  // Has to be called by the other thread right before it sets the event, to measure the wakeup
+  // latency.
+  void Notify() { m_notify_time_ns.store(Now(), std::memory_order_relaxed); }
+
+  // Returns the time in microseconds spent in Spin and Block since the last call.
+  u64 TakeWaitTime() { return m_wait_time_ns.exchange(0, std::memory_order_relaxed) / 1000; }
+
+private:
+  static constexpr s64 MIN_LIMIT_NS = 1000;
+  static constexpr s64 MAX_LIMIT_NS = 100000;
+
+  static s64 Now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  s64 m_limit_ns = MIN_LIMIT_NS;
+  s64 m_latency_ns = 20000;
+  std::atomic<s64> m_notify_time_ns{0};
+  std::atomic<u64> m_wait_time_ns{0};
+};
+}  // namespace Common
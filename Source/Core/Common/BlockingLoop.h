@@ -8,6 +8,8 @@
 #include <mutex>
 #include <thread>
 
+#include "Common/AdaptiveSpin.h"
+#include "Common/CommonTypes.h"
 #include "Common/Event.h"
 #include "Common/Flag.h"
 
@@ -19,6 +21,7 @@ namespace Common
 // often.
 // Be careful when using Wait() and Wakeup() at the same time. Wait() may block forever while
 // Wakeup() is called regularly.
+// Both the worker and Wait() spin for a short while before they block, see AdaptiveSpin.
 class BlockingLoop
 {
 public:
@@ -46,6 +49,7 @@ public:
       return;
 
     // Else as the worker thread may sleep now, we have to set the event.
+    m_new_work_spin.Notify();
     m_new_work_event.Set();
   }
 
@@ -63,9 +67,14 @@ public:
     std::lock_guard<std::mutex> lk(m_wait_lock);
 
     // Wait for the worker thread to finish.
-    while (!IsDone())
+    if (!m_done_spin.Spin([this] { return IsDone(); }))
     {
-      m_done_event.Wait();
+      m_done_spin.Block([this] {
+        while (!IsDone())
+        {
+          m_done_event.Wait();
+        }
+      });
     }
 
     // As we wanted to wait for the other thread, there is likely no work remaining.
@@ -157,6 +166,7 @@ public:
         // Else we're likely in the STATE_DONE state now, so wakeup the waiting threads right now.
         // However, if we're not in the STATE_DONE state any more, the event should also be
         // triggered so that we'll skip the next waiting call quite fast.
+        m_done_spin.Notify();
         m_done_event.Set();
 
       case STATE_DONE:
@@ -175,17 +185,31 @@ public:
         }
 
       case STATE_SLEEPING:
-        // Just relax
-        if (timeout > 0)
-        {
-          m_new_work_event.WaitFor(std::chrono::milliseconds(timeout));
-        }
-        else
+      {
+        const auto sleep = [this, timeout] {
+          if (timeout > 0)
+          {
+            m_new_work_event.WaitFor(std::chrono::milliseconds(timeout));
+          }
+          else
+          {
+            m_new_work_event.Wait();
+          }
+        };
+
+        // Wakeup() leaves the sleeping state right before it sets the event. So if the state
+        // changes while spinning, the event only has to be consumed, which won't block for long.
+        if (m_new_work_spin.Spin([this] { return m_running_state.load() != STATE_SLEEPING; }))
         {
-          m_new_work_event.Wait();
+          sleep();
+          break;
         }
+
+        // Just relax
+        m_new_work_spin.Block(sleep);
         break;
       }
+      }
     }
 
     // Shutdown down, so get a safe state
@@ -193,6 +217,7 @@ public:
     m_stopped.Set();
 
     // Wake up the last Wait calls.
+    m_done_spin.Notify();
     m_done_event.Set();
   }
 
@@ -230,6 +255,10 @@ public:
   // This function should be triggered regularly over time so
   // that we will fall back from the busy loop to sleeping.
   void AllowSleep() { m_may_sleep.Set(); }
+  // Time in microseconds the worker spent waiting for new work since the last call.
+  u64 TakeWorkerWaitTime() { return m_new_work_spin.TakeWaitTime(); }
+  // Time in microseconds spent in Wait() since the last call.
+  u64 TakeWaitTime() { return m_done_spin.TakeWaitTime(); }
 private:
   std::mutex m_wait_lock;
   std::mutex m_prepare_lock;
@@ -239,6 +268,8 @@ private:
 
   Event m_new_work_event;
   Event m_done_event;
+  AdaptiveSpin m_new_work_spin;
+  AdaptiveSpin m_done_spin;
 
   enum RUNNING_TYPE
   {
@@ -8,9 +8,11 @@
 #include "Common/CPUDetect.h"
 #include "Common/CommonFuncs.h"
 #include "Common/Intrinsics.h"
+#include "Common/Swap.h"
 
 #ifdef _M_ARM_64
 #include <arm_acle.h>
+#include <arm_neon.h>
 #endif
 
 static u64 (*ptrHashFunction)(const u8* src, u32 len, u32 samples) = nullptr;
@@ -612,28 +614,430 @@ u64 GetHashHiresTexture(const u8* src, u32 len, u32 samples)
 }
 #endif
 
-u64 GetHash64(const u8* src, u32 len, u32 samples)
+// XXH3-style stripe hash.
+// Processes the input in 64-byte stripes with eight 64-bit accumulators, which maps directly onto
+// SSE2/AVX2/NEON registers. Every vector implementation below produces exactly the same result as
+// the generic one, so the chosen variant only affects speed, never the hash values.
+namespace
 {
-  return ptrHashFunction(src, len, samples);
+constexpr u32 XXH3_STRIPE_LEN = 64;
+constexpr u32 XXH3_STRIPES_PER_BLOCK = 16;
+constexpr u32 XXH3_SECRET_SIZE = 192;
+constexpr u32 XXH3_SCRAMBLE_SECRET_OFFSET = XXH3_SECRET_SIZE - XXH3_STRIPE_LEN;
+constexpr u32 XXH3_TAIL_SECRET_OFFSET = 121;
+constexpr u32 XXH3_MERGE_SECRET_OFFSET = 11;
+
+constexpr u32 XXH3_PRIME32_1 = 0x9E3779B1U;
+constexpr u32 XXH3_PRIME32_2 = 0x85EBCA77U;
+constexpr u32 XXH3_PRIME32_3 = 0xC2B2AE3DU;
+constexpr u64 XXH3_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr u64 XXH3_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr u64 XXH3_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr u64 XXH3_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr u64 XXH3_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+// Pseudo-random key material (splitmix64 output). Must never change, as it defines the hash.
+alignas(64) constexpr u8 s_xxh3_secret[XXH3_SECRET_SIZE] = {
+    0xc2, 0x5d, 0x99, 0xd1, 0x88, 0x3c, 0x13, 0x9a, 0x50, 0xab, 0x31, 0x1b, 0x93, 0x7b, 0xf0, 0x00,
+    0x89, 0x19, 0x90, 0xc4, 0x70, 0x02, 0x56, 0x5d, 0x42, 0x6d, 0xe5, 0x08, 0xf4, 0xae, 0xf2, 0x1f,
+    0x79, 0x4a, 0x73, 0x46, 0x2c, 0x9b, 0x1b, 0xee, 0x7d, 0xb2, 0x92, 0xe6, 0x5e, 0xaf, 0x2f, 0x05,
+    0x29, 0x9f, 0x32, 0x07, 0xe5, 0xd0, 0xa6, 0x92, 0xb3, 0x63, 0xa0, 0x76, 0x05, 0x05, 0x58, 0x30,
+    0x2c, 0x6e, 0x87, 0x1e, 0x05, 0xb4, 0xae, 0x62, 0xe1, 0x0b, 0x3f, 0x27, 0x7c, 0xb2, 0xa0, 0x27,
+    0x6b, 0xd5, 0x46, 0xc0, 0x84, 0xca, 0xc9, 0x80, 0x70, 0x48, 0xa2, 0xc6, 0x23, 0x50, 0x6d, 0xe5,
+    0x1c, 0xfa, 0x4a, 0x5e, 0x6a, 0x65, 0xfd, 0x36, 0x80, 0xa0, 0x73, 0xdf, 0x8d, 0x2f, 0x15, 0x05,
+    0xb0, 0x24, 0x09, 0xac, 0xc4, 0xb2, 0x49, 0x38, 0x6b, 0xff, 0x2a, 0x92, 0x94, 0xc7, 0x7d, 0xbc,
+    0x4c, 0xf1, 0x62, 0xfb, 0xba, 0x5b, 0x93, 0xe7, 0x62, 0xcc, 0x4b, 0xb8, 0xd1, 0x82, 0x8e, 0x59,
+    0x02, 0x5b, 0x67, 0x21, 0x97, 0x6a, 0xa0, 0x4b, 0x2e, 0xf5, 0x0f, 0x86, 0x69, 0x72, 0x77, 0xcd,
+    0x1e, 0xf1, 0x17, 0x9d, 0x09, 0x90, 0x99, 0x3b, 0xbe, 0x79, 0x87, 0x72, 0x51, 0x29, 0x2e, 0xec,
+    0xa8, 0x93, 0x40, 0x3d, 0xf4, 0x09, 0xf8, 0xaa, 0xd2, 0xe2, 0x30, 0xe4, 0x13, 0x12, 0xbf, 0x7f,
+};
+
+// Accumulates |count| stripes, |stride| bytes apart, using consecutive 8-byte secret offsets.
+using XXH3AccumulateFunction = void (*)(u64* acc, const u8* src, size_t stride, u32 count,
+                                        const u8* secret);
+using XXH3ScrambleFunction = void (*)(u64* acc, const u8* secret);
+
+inline u64 XXH3Read64(const u8* p)
+{
+  u64 value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
 }
 
-// sets the hash function used for the texture cache
-void SetHash64Function()
+inline u64 XXH3Mul128Fold64(u64 lhs, u64 rhs)
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+  return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#else
+  const u64 lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+  const u64 hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+  const u64 lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+  const u64 hi_hi = (lhs >> 32) * (rhs >> 32);
+  const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  const u64 upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  const u64 lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  return lower ^ upper;
+#endif
+}
+
+void XXH3AccumulateGeneric(u64* acc, const u8* src, size_t stride, u32 count, const u8* secret)
 {
-#if defined(_M_X86_64) || defined(_M_X86)
-  if (cpu_info.bSSE4_2)  // sse crc32 version
+  for (u32 n = 0; n < count; ++n, src += stride, secret += 8)
   {
-    ptrHashFunction = &GetCRC32;
+    for (u32 i = 0; i < 8; ++i)
+    {
+      const u64 data = XXH3Read64(src + i * 8);
+      const u64 key = data ^ XXH3Read64(secret + i * 8);
+      acc[i ^ 1] += data;
+      acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+    }
+  }
+}
+
+void XXH3ScrambleGeneric(u64* acc, const u8* secret)
+{
+  for (u32 i = 0; i < 8; ++i)
+  {
+    u64 a = acc[i];
+    a ^= a >> 47;
+    a ^= XXH3Read64(secret + i * 8);
+    a *= XXH3_PRIME32_1;
+    acc[i] = a;
+  }
+}
+
+#if defined(_M_X86)
+
+void XXH3AccumulateSSE2(u64* acc, const u8* src, size_t stride, u32 count, const u8* secret)
+{
+  __m128i xacc[4];
+  for (u32 i = 0; i < 4; ++i)
+    xacc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+
+  for (u32 n = 0; n < count; ++n, src += stride, secret += 8)
+  {
+    for (u32 i = 0; i < 4; ++i)
+    {
+      const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + i);
+      const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+      const __m128i data_key = _mm_xor_si128(data, key);
+      const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+      const __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+      const __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm_add_epi64(_mm_add_epi64(xacc[i], data_swap), product);
+    }
+  }
+
+  for (u32 i = 0; i < 4; ++i)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, xacc[i]);
+}
+
+void XXH3ScrambleSSE2(u64* acc, const u8* secret)
+{
+  const __m128i prime = _mm_set1_epi32(XXH3_PRIME32_1);
+  for (u32 i = 0; i < 4; ++i)
+  {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+    a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+    a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+    const __m128i lo = _mm_mul_epu32(a, prime);
+    const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+    a = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, a);
   }
-  else
+}
+
+FUNCTION_TARGET_AVX2
+void XXH3AccumulateAVX2(u64* acc, const u8* src, size_t stride, u32 count, const u8* secret)
+{
+  __m256i xacc[2];
+  for (u32 i = 0; i < 2; ++i)
+    xacc[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + i);
+
+  for (u32 n = 0; n < count; ++n, src += stride, secret += 8)
+  {
+    for (u32 i = 0; i < 2; ++i)
+    {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src) + i);
+      const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i);
+      const __m256i data_key = _mm256_xor_si256(data, key);
+      const __m256i data_key_hi = _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+      const __m256i product = _mm256_mul_epu32(data_key, data_key_hi);
+      const __m256i data_swap = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm256_add_epi64(_mm256_add_epi64(xacc[i], data_swap), product);
+    }
+  }
+
+  for (u32 i = 0; i < 2; ++i)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + i, xacc[i]);
+}
+
+FUNCTION_TARGET_AVX2
+void XXH3ScrambleAVX2(u64* acc, const u8* secret)
+{
+  const __m256i prime = _mm256_set1_epi32(XXH3_PRIME32_1);
+  for (u32 i = 0; i < 2; ++i)
+  {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + i);
+    a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+    a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+    const __m256i lo = _mm256_mul_epu32(a, prime);
+    const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+    a = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + i, a);
+  }
+}
+
 #elif defined(_M_ARM_64)
-  if (cpu_info.bCRC32)
+
+void XXH3AccumulateNEON(u64* acc, const u8* src, size_t stride, u32 count, const u8* secret)
+{
+  uint64x2_t xacc[4];
+  for (u32 i = 0; i < 4; ++i)
+    xacc[i] = vld1q_u64(acc + i * 2);
+
+  for (u32 n = 0; n < count; ++n, src += stride, secret += 8)
   {
-    ptrHashFunction = &GetCRC32;
+    for (u32 i = 0; i < 4; ++i)
+    {
+      const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(src + i * 16));
+      const uint64x2_t key = vreinterpretq_u64_u8(vld1q_u8(secret + i * 16));
+      const uint64x2_t data_key = veorq_u64(data, key);
+      const uint32x2_t data_key_lo = vmovn_u64(data_key);
+      const uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
+      xacc[i] = vaddq_u64(xacc[i], vextq_u64(data, data, 1));
+      xacc[i] = vmlal_u32(xacc[i], data_key_lo, data_key_hi);
+    }
   }
-  else
+
+  for (u32 i = 0; i < 4; ++i)
+    vst1q_u64(acc + i * 2, xacc[i]);
+}
+
+void XXH3ScrambleNEON(u64* acc, const u8* secret)
+{
+  const uint32x2_t prime = vdup_n_u32(XXH3_PRIME32_1);
+  for (u32 i = 0; i < 4; ++i)
+  {
+    uint64x2_t a = vld1q_u64(acc + i * 2);
+    a = veorq_u64(a, vshrq_n_u64(a, 47));
+    a = veorq_u64(a, vreinterpretq_u64_u8(vld1q_u8(secret + i * 16)));
+    const uint64x2_t hi = vshlq_n_u64(vmull_u32(vshrn_n_u64(a, 32), prime), 32);
+    a = vmlal_u32(hi, vmovn_u64(a), prime);
+    vst1q_u64(acc + i * 2, a);
+  }
+}
+
 #endif
+
+inline u32 XXH3Read32(const u8* p)
+{
+  u32 value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline u64 XXH3Avalanche(u64 h)
+{
+  h ^= h >> 37;
+  h *= 0x165667919E3779F9ULL;
+  h ^= h >> 32;
+  return h;
+}
+
+inline u64 XXH3Mix16(const u8* src, const u8* secret)
+{
+  return XXH3Mul128Fold64(XXH3Read64(src) ^ XXH3Read64(secret),
+                          XXH3Read64(src + 8) ^ XXH3Read64(secret + 8));
+}
+
+// Inputs up to 128 bytes do not go through the stripe loop at all, as setting up and merging the
+// accumulators would dominate. This path is shared by all variants and ignores samples.
+u64 GetXXH3Short(const u8* src, u32 len)
+{
+  const u8* secret = s_xxh3_secret;
+
+  if (len > 16)
+  {
+    u64 acc = len * XXH3_PRIME64_1;
+    if (len > 32)
+    {
+      if (len > 64)
+      {
+        if (len > 96)
+        {
+          acc += XXH3Mix16(src + 48, secret + 96);
+          acc += XXH3Mix16(src + len - 64, secret + 112);
+        }
+        acc += XXH3Mix16(src + 32, secret + 64);
+        acc += XXH3Mix16(src + len - 48, secret + 80);
+      }
+      acc += XXH3Mix16(src + 16, secret + 32);
+      acc += XXH3Mix16(src + len - 32, secret + 48);
+    }
+    acc += XXH3Mix16(src, secret);
+    acc += XXH3Mix16(src + len - 16, secret + 16);
+    return XXH3Avalanche(acc);
+  }
+
+  if (len > 8)
+  {
+    const u64 lo = XXH3Read64(src) ^ XXH3Read64(secret + 24);
+    const u64 hi = XXH3Read64(src + len - 8) ^ XXH3Read64(secret + 32);
+    return XXH3Avalanche(len + Common::swap64(lo) + hi + XXH3Mul128Fold64(lo, hi));
+  }
+
+  if (len >= 4)
+  {
+    const u64 combined = XXH3Read32(src) | (u64(XXH3Read32(src + len - 4)) << 32);
+    const u64 keyed = combined ^ XXH3Read64(secret + 8);
+    return XXH3Avalanche(XXH3Mul128Fold64(keyed, XXH3_PRIME64_1 + len) ^ len);
+  }
+
+  if (len > 0)
+  {
+    const u32 combined =
+        src[0] | (u32(src[len >> 1]) << 8) | (u32(src[len - 1]) << 16) | (len << 24);
+    return XXH3Avalanche((combined ^ XXH3Read32(secret)) * XXH3_PRIME64_1);
+  }
+
+  return XXH3Avalanche(XXH3Read64(secret + 56) ^ XXH3Read64(secret + 64));
+}
+
+// With samples != 0, only every n-th stripe is hashed so that roughly |samples| stripes are read,
+// like the other sampled hash functions. The last 64 bytes are always included.
+template <XXH3AccumulateFunction Accumulate, XXH3ScrambleFunction Scramble>
+u64 GetXXH3(const u8* src, u32 len, u32 samples)
+{
+  if (len <= 128)
+    return GetXXH3Short(src, len);
+
+  alignas(32) u64 acc[8] = {XXH3_PRIME32_3, XXH3_PRIME64_1, XXH3_PRIME64_2, XXH3_PRIME64_3,
+                            XXH3_PRIME64_4, XXH3_PRIME32_2, XXH3_PRIME64_5, XXH3_PRIME32_1};
+
+  const u32 num_stripes = len / XXH3_STRIPE_LEN;
+  const u32 step = samples ? std::max(num_stripes / samples, 1u) : 1;
+  const u32 visited = (num_stripes - 1) / step + 1;
+  const size_t stride = size_t(step) * XXH3_STRIPE_LEN;
+
+  u32 done = 0;
+  while (done < visited)
+  {
+    const u32 lane = done % XXH3_STRIPES_PER_BLOCK;
+    const u32 run = std::min(XXH3_STRIPES_PER_BLOCK - lane, visited - done);
+    Accumulate(acc, src + done * stride, stride, run, s_xxh3_secret + lane * 8);
+    done += run;
+    if (lane + run == XXH3_STRIPES_PER_BLOCK)
+      Scramble(acc, s_xxh3_secret + XXH3_SCRAMBLE_SECRET_OFFSET);
+  }
+
+  // The final stripe overlaps the previous one when the length is not a multiple of 64.
+  Accumulate(acc, src + len - XXH3_STRIPE_LEN, XXH3_STRIPE_LEN, 1,
+             s_xxh3_secret + XXH3_TAIL_SECRET_OFFSET);
+
+  u64 result = len * XXH3_PRIME64_1;
+  for (u32 i = 0; i < 4; ++i)
+  {
+    const u8* key = s_xxh3_secret + XXH3_MERGE_SECRET_OFFSET + i * 16;
+    result += XXH3Mul128Fold64(acc[i * 2] ^ XXH3Read64(key), acc[i * 2 + 1] ^ XXH3Read64(key + 8));
+  }
+  return XXH3Avalanche(result);
+}
+}  // Anonymous namespace
+
+u64 GetHash64(const u8* src, u32 len, u32 samples)
+{
+  return ptrHashFunction(src, len, samples);
+}
+
+bool IsHash64FunctionSupported(Hash64Function function)
+{
+  switch (function)
   {
+  case Hash64Function::MurmurHash3:
+  case Hash64Function::XXH3Generic:
+    return true;
+  case Hash64Function::CRC32:
+#if defined(_M_X86)
+    return cpu_info.bSSE4_2;
+#elif defined(_M_ARM_64)
+    return cpu_info.bCRC32;
+#else
+    return false;
+#endif
+  case Hash64Function::XXH3SSE2:
+#if defined(_M_X86)
+    return cpu_info.bSSE2;
+#else
+    return false;
+#endif
+  case Hash64Function::XXH3AVX2:
+#if defined(_M_X86)
+    return cpu_info.bAVX2;
+#else
+    return false;
+#endif
+  case Hash64Function::XXH3NEON:
+#if defined(_M_ARM_64)
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+void SetHash64Function(Hash64Function function)
+{
+  if (!IsHash64FunctionSupported(function))
+    function = Hash64Function::XXH3Generic;
+
+  switch (function)
+  {
+  case Hash64Function::MurmurHash3:
     ptrHashFunction = &GetMurmurHash3;
+    break;
+  case Hash64Function::CRC32:
+    ptrHashFunction = &GetCRC32;
+    break;
+#if defined(_M_X86)
+  case Hash64Function::XXH3SSE2:
+    ptrHashFunction = &GetXXH3<XXH3AccumulateSSE2, XXH3ScrambleSSE2>;
+    break;
+  case Hash64Function::XXH3AVX2:
+    ptrHashFunction = &GetXXH3<XXH3AccumulateAVX2, XXH3ScrambleAVX2>;
+    break;
+#elif defined(_M_ARM_64)
+  case Hash64Function::XXH3NEON:
+    ptrHashFunction = &GetXXH3<XXH3AccumulateNEON, XXH3ScrambleNEON>;
+    break;
+#endif
+  default:
+    ptrHashFunction = &GetXXH3<XXH3AccumulateGeneric, XXH3ScrambleGeneric>;
+    break;
   }
 }
+
+// sets the hash function used for the texture cache
+void SetHash64Function()
+{
+#if defined(_M_X86)
+  if (IsHash64FunctionSupported(Hash64Function::XXH3AVX2))
+  {
+    SetHash64Function(Hash64Function::XXH3AVX2);
+    return;
+  }
+  // The 4-way CRC32 is still faster than the 128-bit XXH3 loop, so keep it when it is available.
+  if (IsHash64FunctionSupported(Hash64Function::CRC32))
+  {
+    SetHash64Function(Hash64Function::CRC32);
+    return;
+  }
+  SetHash64Function(Hash64Function::XXH3SSE2);
+#elif defined(_M_ARM_64)
+  SetHash64Function(Hash64Function::XXH3NEON);
+#else
+  SetHash64Function(Hash64Function::MurmurHash3);
+#endif
+}
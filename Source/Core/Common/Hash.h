@@ -11,6 +11,27 @@
 u32 HashFletcher(const u8* data_u8, size_t length);  // FAST. Length & 1 == 0.
 u32 HashAdler32(const u8* data, size_t len);         // Fairly accurate, slightly slower
 u32 HashEctor(const u8* ptr, int length);            // JUNK. DO NOT USE FOR NEW THINGS
+
+// Used to name dumped and custom textures. The output of this function must never change, or
+// existing texture packs stop matching. It is deliberately independent of GetHash64.
 u64 GetHashHiresTexture(const u8* src, u32 len, u32 samples = 0);
+
+// Implementations selectable for GetHash64. The XXH3* variants all produce identical values and
+// only differ in the instruction set used. GetHash64 values are only ever used at runtime, so the
+// selected function may change between versions.
+enum class Hash64Function
+{
+  MurmurHash3,
+  CRC32,
+  XXH3Generic,
+  XXH3SSE2,
+  XXH3AVX2,
+  XXH3NEON,
+};
+
 u64 GetHash64(const u8* src, u32 len, u32 samples);
+bool IsHash64FunctionSupported(Hash64Function function);
+// Unsupported functions fall back to XXH3Generic.
+void SetHash64Function(Hash64Function function);
+// Picks the fastest supported function for the host CPU.
 void SetHash64Function();
@@ -0,0 +1,41 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Common
+{
+// Splits [0, count) into one range per host core, and calls function(begin, end) for each of them
+// on its own thread. The calling thread takes the first range, and waits for the others.
+// Ranges are at least min_range long, so small inputs don't pay for starting threads. The ranges
+// are never empty, so nothing is called when count is 0.
+template <typename Function>
+void ParallelFor(size_t count, size_t min_range, const Function& function)
+{
+  if (count == 0)
+    return;
+
+  const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  const size_t max_threads = count / std::max<size_t>(min_range, 1);
+  const size_t threads = std::max<size_t>(std::min(cores, max_threads), 1);
+  const size_t range = (count + threads - 1) / threads;
+
+  std::vector<std::thread> workers;
+  for (size_t begin = range; begin < count; begin += range)
+  {
+    const size_t end = std::min(begin + range, count);
+    workers.emplace_back([&function, begin, end] { function(begin, end); });
+  }
+
+  function(0, std::min(range, count));
+
+  for (std::thread& worker : workers)
+    worker.join();
+}
+}  // namespace Common
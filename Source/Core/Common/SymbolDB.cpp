@@ -2,10 +2,13 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -25,7 +28,7 @@ void SymbolDB::Clear(const char* prefix)
 {
   // TODO: honor prefix
   functions.clear();
-  checksumToFunction.clear();
+  InvalidateLookupTables();
 }
 
 void SymbolDB::Index()
@@ -35,36 +38,88 @@ void SymbolDB::Index()
   {
     func.second.index = i++;
   }
+  InvalidateLookupTables();
 }
 
-Symbol* SymbolDB::GetSymbolFromName(const std::string& name)
+void SymbolDB::InvalidateLookupTables()
+{
+  std::lock_guard<std::mutex> lk(m_lookup_mutex);
+  m_lookup_tables_valid = false;
+}
+
+// Has to be called with m_lookup_mutex held.
+void SymbolDB::UpdateLookupTables()
 {
+  if (m_lookup_tables_valid)
+    return;
+
+  m_name_to_functions.clear();
+  m_checksum_to_functions.clear();
+  m_address_ranges.clear();
+  m_address_ranges.reserve(functions.size());
+
+  u64 max_end = 0;
   for (auto& func : functions)
   {
-    if (func.second.function_name == name)
-      return &func.second;
+    Symbol& symbol = func.second;
+    m_name_to_functions[symbol.function_name].push_back(&symbol);
+    if (symbol.type == Symbol::Type::Function)
+      m_checksum_to_functions[symbol.hash].insert(&symbol);
+
+    max_end = std::max<u64>(max_end, u64{symbol.address} + std::max(symbol.size, 0));
+    m_address_ranges.push_back({symbol.address, max_end, &symbol});
   }
 
-  return nullptr;
+  m_lookup_tables_valid = true;
+}
+
+Symbol* SymbolDB::GetSymbolContaining(u32 address)
+{
+  std::lock_guard<std::mutex> lk(m_lookup_mutex);
+  UpdateLookupTables();
+
+  // No symbol before the first one which ends past the address contains it, and none after it
+  // starts any earlier.
+  const auto iter =
+      std::upper_bound(m_address_ranges.begin(), m_address_ranges.end(), address,
+                       [](u32 value, const AddressRange& range) { return value < range.max_end; });
+  if (iter == m_address_ranges.end() || iter->start > address)
+    return nullptr;
+
+  return iter->symbol;
+}
+
+Symbol* SymbolDB::GetSymbolFromName(const std::string& name)
+{
+  std::lock_guard<std::mutex> lk(m_lookup_mutex);
+  UpdateLookupTables();
+
+  const auto iter = m_name_to_functions.find(name);
+  if (iter == m_name_to_functions.end())
+    return nullptr;
+
+  return iter->second.front();
 }
 
 std::vector<Symbol*> SymbolDB::GetSymbolsFromName(const std::string& name)
 {
-  std::vector<Symbol*> symbols;
+  std::lock_guard<std::mutex> lk(m_lookup_mutex);
+  UpdateLookupTables();
 
-  for (auto& func : functions)
-  {
-    if (func.second.function_name == name)
-      symbols.push_back(&func.second);
-  }
+  const auto iter = m_name_to_functions.find(name);
+  if (iter == m_name_to_functions.end())
+    return {};
 
-  return symbols;
+  return iter->second;
 }
 
 Symbol* SymbolDB::GetSymbolFromHash(u32 hash)
 {
-  XFuncPtrMap::iterator iter = checksumToFunction.find(hash);
-  if (iter != checksumToFunction.end())
+  std::lock_guard<std::mutex> lk(m_lookup_mutex);
+  UpdateLookupTables();
+
+  XFuncPtrMap::iterator iter = m_checksum_to_functions.find(hash);
+  if (iter != m_checksum_to_functions.end())
     return *iter->second.begin();
   else
     return nullptr;
@@ -72,9 +127,12 @@ Symbol* SymbolDB::GetSymbolFromHash(u32 hash)
 
 std::vector<Symbol*> SymbolDB::GetSymbolsFromHash(u32 hash)
 {
-  const auto iter = checksumToFunction.find(hash);
+  std::lock_guard<std::mutex> lk(m_lookup_mutex);
+  UpdateLookupTables();
+
+  const auto iter = m_checksum_to_functions.find(hash);
 
-  if (iter == checksumToFunction.cend())
+  if (iter == m_checksum_to_functions.cend())
     return {};
 
   return {iter->second.cbegin(), iter->second.cend()};
@@ -83,4 +141,5 @@ std::vector<Symbol*> SymbolDB::GetSymbolsFromHash(u32 hash)
 void SymbolDB::AddCompleteSymbol(const Symbol& symbol)
 {
   functions.emplace(symbol.address, symbol);
+  InvalidateLookupTables();
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -62,7 +63,12 @@ public:
 
 protected:
   XFuncMap functions;
-  XFuncPtrMap checksumToFunction;
+
+  // Has to be called whenever symbols are added or removed, or their names, hashes, addresses or
+  // sizes change. The lookup tables are rebuilt on the next lookup.
+  void InvalidateLookupTables();
+  // Returns the first symbol by address which contains the address.
+  Symbol* GetSymbolContaining(u32 address);
 
 public:
   SymbolDB() {}
@@ -77,8 +83,30 @@ public:
   std::vector<Symbol*> GetSymbolsFromHash(u32 hash);
 
   const XFuncMap& Symbols() const { return functions; }
-  XFuncMap& AccessSymbols() { return functions; }
+  XFuncMap& AccessSymbols()
+  {
+    InvalidateLookupTables();
+    return functions;
+  }
   void Clear(const char* prefix = "");
   void List();
+  // Also has to be called after changing a symbol obtained through a lookup.
   void Index();
+
+private:
+  struct AddressRange
+  {
+    u32 start;
+    // The highest end address of this and all previous symbols.
+    u64 max_end;
+    Symbol* symbol;
+  };
+
+  void UpdateLookupTables();
+
+  std::mutex m_lookup_mutex;
+  bool m_lookup_tables_valid = false;
+  std::map<std::string, std::vector<Symbol*>> m_name_to_functions;
+  XFuncPtrMap m_checksum_to_functions;
+  std::vector<AddressRange> m_address_ranges;
 };
@@ -5,6 +5,7 @@
 #include "Common/Thread.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/Tracing.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -90,6 +91,8 @@ void SetCurrentThreadName(const char* szThreadName)
   __except (EXCEPTION_CONTINUE_EXECUTION)
   {
   }
+
+  Tracing::SetThreadName(szThreadName);
 }
 
 #else  // !WIN32, so must be POSIX threads
@@ -146,6 +149,8 @@ void SetCurrentThreadName(const char* szThreadName)
   // API.
   __itt_thread_set_name(szThreadName);
 #endif
+
+  Tracing::SetThreadName(szThreadName);
 }
 
 #endif
@@ -0,0 +1,175 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Tracing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/StringUtil.h"
+
+namespace Common
+{
+namespace Tracing
+{
+// Events per thread. Older events are overwritten, so a recording keeps the last few seconds of
+// the busiest threads.
+constexpr u64 BUFFER_SIZE = 64 * 1024;
+
+struct Event
+{
+  const char* name;
+  u64 start;
+  u64 end;
+};
+
+struct ThreadBuffer
+{
+  std::vector<Event> events = std::vector<Event>(BUFFER_SIZE);
+  // Only written by the owning thread.
+  std::atomic<u64> count{0};
+  // The value of count when the recording started.
+  u64 first = 0;
+  std::string thread_name;
+  u32 thread_id = 0;
+  bool in_use = false;
+};
+
+std::atomic<bool> g_recording{false};
+
+// Guards everything but the events and count of the buffers, which belong to their threads.
+static std::mutex s_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static u64 s_start_time;
+
+// Hands the buffer back when its thread exits, so short-lived threads don't pile up buffers.
+struct ThreadState
+{
+  ~ThreadState()
+  {
+    if (buffer)
+    {
+      std::lock_guard<std::mutex> lk(s_mutex);
+      buffer->in_use = false;
+    }
+  }
+
+  ThreadBuffer* buffer = nullptr;
+  std::string name;
+};
+
+static thread_local ThreadState t_state;
+
+static ThreadBuffer* GetThreadBuffer()
+{
+  if (t_state.buffer)
+    return t_state.buffer;
+
+  std::lock_guard<std::mutex> lk(s_mutex);
+  auto iter = std::find_if(s_buffers.begin(), s_buffers.end(),
+                           [](const auto& buffer) { return !buffer->in_use; });
+  if (iter == s_buffers.end())
+  {
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    iter = s_buffers.end() - 1;
+  }
+
+  ThreadBuffer* buffer = iter->get();
+  buffer->first = buffer->count.load(std::memory_order_relaxed);
+  buffer->thread_id = static_cast<u32>(iter - s_buffers.begin()) + 1;
+  buffer->thread_name = t_state.name.empty() ?
+                            StringFromFormat("Thread %u", buffer->thread_id) :
+                            t_state.name;
+  buffer->in_use = true;
+  t_state.buffer = buffer;
+  return buffer;
+}
+
+u64 GetTimestamp()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void AddZone(const char* name, u64 start, u64 end)
+{
+  if (!g_recording.load(std::memory_order_relaxed))
+    return;
+
+  ThreadBuffer* buffer = GetThreadBuffer();
+  const u64 count = buffer->count.load(std::memory_order_relaxed);
+  buffer->events[count % BUFFER_SIZE] = {name, start, end};
+  buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void SetThreadName(const char* name)
+{
+  t_state.name = name;
+  if (t_state.buffer)
+  {
+    std::lock_guard<std::mutex> lk(s_mutex);
+    t_state.buffer->thread_name = name;
+  }
+}
+
+void Start()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  for (auto& buffer : s_buffers)
+    buffer->first = buffer->count.load(std::memory_order_acquire);
+  s_start_time = GetTimestamp();
+  g_recording.store(true);
+}
+
+bool IsRecording()
+{
+  return g_recording.load();
+}
+
+bool Stop(const std::string& path)
+{
+  g_recording.store(false);
+
+  std::lock_guard<std::mutex> lk(s_mutex);
+  std::string json = "{\"traceEvents\":[\n";
+  const char* separator = "";
+  for (const auto& buffer : s_buffers)
+  {
+    const u64 count = buffer->count.load(std::memory_order_acquire);
+    if (count == buffer->first)
+      continue;
+
+    // A zone that was already past the recording check when it stopped may still overwrite the
+    // oldest event of a full buffer, so skip that one.
+    const u64 first = count - buffer->first > BUFFER_SIZE ? count - BUFFER_SIZE + 1 : buffer->first;
+
+    json += StringFromFormat("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,"
+                             "\"args\":{\"name\":\"%s\"}}",
+                             separator, buffer->thread_id, buffer->thread_name.c_str());
+    separator = ",\n";
+
+    for (u64 i = first; i < count; i++)
+    {
+      const Event& event = buffer->events[i % BUFFER_SIZE];
+      const u64 start = std::max(event.start, s_start_time);
+      json += StringFromFormat(
+          ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+          event.name, buffer->thread_id, (start - s_start_time) / 1000.0,
+          (std::max(event.end, start) - start) / 1000.0);
+    }
+  }
+  json += "\n]}\n";
+
+  File::IOFile file(path, "wb");
+  return file.WriteBytes(json.data(), json.size());
+}
+}  // namespace Tracing
+}  // namespace Common
@@ -0,0 +1,74 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Records where wall-clock time goes across the emulation threads. Scoped zones are written to
+// per-thread ring buffers while a recording runs, and written out in the Chrome trace event
+// format (chrome://tracing or https://ui.perfetto.dev) when it stops.
+//
+// When no recording runs, a zone costs a relaxed atomic load on entry and a branch on exit.
+namespace Common
+{
+namespace Tracing
+{
+void Start();
+// Stops recording and writes the events still held in the ring buffers to path.
+bool Stop(const std::string& path);
+bool IsRecording();
+
+// Names the current thread in traces. Called by Common::SetCurrentThreadName.
+void SetThreadName(const char* name);
+
+extern std::atomic<bool> g_recording;
+
+u64 GetTimestamp();
+void AddZone(const char* name, u64 start, u64 end);
+
+class Zone
+{
+public:
+  // name has to be a string literal, or otherwise outlive the recording.
+  explicit Zone(const char* name, bool enabled = true)
+      : m_name(name),
+        m_start(enabled && g_recording.load(std::memory_order_relaxed) ? GetTimestamp() : 0)
+  {
+  }
+  ~Zone()
+  {
+    if (m_start != 0)
+      AddZone(m_name, m_start, GetTimestamp());
+  }
+
+  Zone(const Zone&) = delete;
+  Zone& operator=(const Zone&) = delete;
+
+private:
+  const char* m_name;
+  u64 m_start;
+};
+}  // namespace Tracing
+}  // namespace Common
+
+// Comment this out to compile all trace zones out.
+#define TRACING
+
+#ifdef TRACING
+// Each zone gets its own variable, so that nested zones don't shadow each other.
+#define TRACE_ZONE_CONCAT_(a, b) a##b
+#define TRACE_ZONE_VARIABLE_(line) TRACE_ZONE_CONCAT_(trace_zone_, line)
+// Records the time until the end of the enclosing scope.
+#define TRACE_ZONE(name) Common::Tracing::Zone TRACE_ZONE_VARIABLE_(__LINE__)(name)
+// Same, but only records anything if condition is true. For loops which mostly run idle.
+#define TRACE_ZONE_IF(name, condition)                                                             \
+  Common::Tracing::Zone TRACE_ZONE_VARIABLE_(__LINE__)(name, condition)
+#else
+#define TRACE_ZONE(name)
+#define TRACE_ZONE_IF(name, condition)
+#endif
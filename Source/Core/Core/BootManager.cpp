@@ -77,6 +77,8 @@ private:
   bool bFPRF;
   bool bAccurateNaNs;
   bool bMMU;
+  int iICacheMode;
+  bool bDetectIdleLoops;
   bool bDCBZOFF;
   bool bLowDCBZHack;
   bool m_EnableJIT;
@@ -112,6 +114,8 @@ void ConfigCache::SaveConfig(const SConfig& config)
   bFPRF = config.bFPRF;
   bAccurateNaNs = config.bAccurateNaNs;
   bMMU = config.bMMU;
+  iICacheMode = config.iICacheMode;
+  bDetectIdleLoops = config.bDetectIdleLoops;
   bDCBZOFF = config.bDCBZOFF;
   m_EnableJIT = config.m_DSPEnableJIT;
   bSyncGPU = config.bSyncGPU;
@@ -156,6 +160,8 @@ void ConfigCache::RestoreConfig(SConfig* config)
   config->bFPRF = bFPRF;
   config->bAccurateNaNs = bAccurateNaNs;
   config->bMMU = bMMU;
+  config->iICacheMode = iICacheMode;
+  config->bDetectIdleLoops = bDetectIdleLoops;
   config->bDCBZOFF = bDCBZOFF;
   config->bLowDCBZHack = bLowDCBZHack;
   config->m_DSPEnableJIT = m_EnableJIT;
@@ -265,6 +271,8 @@ bool BootCore(std::unique_ptr<BootParameters> boot)
     core_section->Get("FPRF", &StartUp.bFPRF, StartUp.bFPRF);
     core_section->Get("AccurateNaNs", &StartUp.bAccurateNaNs, StartUp.bAccurateNaNs);
     core_section->Get("MMU", &StartUp.bMMU, StartUp.bMMU);
+    core_section->Get("ICacheMode", &StartUp.iICacheMode, StartUp.iICacheMode);
+    core_section->Get("DetectIdleLoops", &StartUp.bDetectIdleLoops, StartUp.bDetectIdleLoops);
     core_section->Get("DCBZ", &StartUp.bDCBZOFF, StartUp.bDCBZOFF);
     core_section->Get("LowDCBZHack", &StartUp.bLowDCBZHack, StartUp.bLowDCBZHack);
     core_section->Get("SyncGPU", &StartUp.bSyncGPU, StartUp.bSyncGPU);
@@ -70,6 +70,7 @@ static const INIToLocationMap& GetINIToLocationMap()
       {{"Video_Settings", "CacheHiresTextures"}, {Config::GFX_CACHE_HIRES_TEXTURES.location}},
       {{"Video_Settings", "EnablePixelLighting"}, {Config::GFX_ENABLE_PIXEL_LIGHTING.location}},
       {{"Video_Settings", "FastDepthCalc"}, {Config::GFX_FAST_DEPTH_CALC.location}},
+      {{"Video_Settings", "DeduplicateVertices"}, {Config::GFX_DEDUPLICATE_VERTICES.location}},
       {{"Video_Settings", "MSAA"}, {Config::GFX_MSAA.location}},
       {{"Video_Settings", "SSAA"}, {Config::GFX_SSAA.location}},
       {{"Video_Settings", "ForceTrueColor"}, {Config::GFX_ENHANCE_FORCE_TRUE_COLOR.location}},
@@ -100,6 +101,8 @@ static const INIToLocationMap& GetINIToLocationMap()
       {{"Video_Hacks", "EFBEmulateFormatChanges"},
        {Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES.location}},
       {{"Video_Hacks", "VertexRounding"}, {Config::GFX_HACK_VERTEX_ROUDING.location}},
+      {{"Video_Hacks", "TrackTextureWrites"}, {Config::GFX_HACK_TRACK_TEXTURE_WRITES.location}},
+      {{"Video_Hacks", "DisplayListCache"}, {Config::GFX_HACK_DISPLAY_LIST_CACHE.location}},
 
       {{"Video", "ProjectionHack"}, {Config::GFX_PROJECTION_HACK.location}},
       {{"Video", "PH_SZNear"}, {Config::GFX_PROJECTION_HACK_SZNEAR.location}},
@@ -238,6 +238,10 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("TimingVariance", iTimingVariance);
   core->Set("CPUCore", iCPUCore);
   core->Set("Fastmem", bFastmem);
+  core->Set("JITKeepRegistersInLoops", bJITKeepRegistersInLoops);
+  core->Set("JITTieredCompilation", bJITTieredCompilation);
+  core->Set("ICacheMode", iICacheMode);
+  core->Set("DetectIdleLoops", bDetectIdleLoops);
   core->Set("CPUThread", bCPUThread);
   core->Set("DSPHLE", bDSPHLE);
   core->Set("SyncOnSkipIdle", bSyncGPUOnSkipIdleHack);
@@ -558,6 +562,10 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("CPUCore", &iCPUCore, PowerPC::CORE_INTERPRETER);
 #endif
   core->Get("Fastmem", &bFastmem, true);
+  core->Get("JITKeepRegistersInLoops", &bJITKeepRegistersInLoops, false);
+  core->Get("JITTieredCompilation", &bJITTieredCompilation, false);
+  core->Get("ICacheMode", &iICacheMode, 0);
+  core->Get("DetectIdleLoops", &bDetectIdleLoops, false);
   core->Get("DSPHLE", &bDSPHLE, true);
   core->Get("TimingVariance", &iTimingVariance, 40);
   core->Get("CPUThread", &bCPUThread, true);
@@ -819,6 +827,8 @@ void SConfig::LoadDefaults()
   bRunCompareServer = false;
   bDSPHLE = true;
   bFastmem = true;
+  iICacheMode = 0;
+  bDetectIdleLoops = false;
   bFPRF = false;
   bAccurateNaNs = false;
   bMMU = false;
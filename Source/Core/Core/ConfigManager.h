@@ -94,6 +94,10 @@ struct SConfig : NonCopyable
   bool bJITBranchOff = false;
 
   bool bFastmem;
+  bool bJITKeepRegistersInLoops = false;
+  bool bJITTieredCompilation = false;
+  int iICacheMode = 0;  // Uses the values of PowerPC::ICacheMode
+  bool bDetectIdleLoops = false;
   bool bFPRF = false;
   bool bAccurateNaNs = false;
 
@@ -30,6 +30,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Tracing.h"
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
@@ -60,6 +61,7 @@
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 #include "Core/State.h"
 #include "Core/WiiRoot.h"
 
@@ -386,9 +388,13 @@ static void CpuThread()
   MemoryWatcher::Init();
 #endif
 
+  SamplingProfiler::SetCPUThread();
+
   // Enter CPU run loop. When we leave it - we are done.
   CPU::Run();
 
+  SamplingProfiler::ClearCPUThread();
+
   s_is_started = false;
 
   if (!_CoreParameter.bCPUThread)
@@ -754,6 +760,30 @@ void SaveScreenShot(const std::string& name, bool wait_for_completion)
     SetState(State::Running);
 }
 
+void ToggleTraceRecording()
+{
+  if (!Common::Tracing::IsRecording())
+  {
+    Common::Tracing::Start();
+    DisplayMessage("Started recording a trace", 2000);
+    return;
+  }
+
+  std::string path = File::GetUserPath(D_DUMP_IDX) + "Traces" DIR_SEP;
+  File::CreateFullPath(path);
+  path += SConfig::GetInstance().GetGameID();
+
+  std::string name;
+  for (int i = 1; File::Exists(name = StringFromFormat("%s-%d.json", path.c_str(), i)); ++i)
+  {
+  }
+
+  if (Common::Tracing::Stop(name))
+    DisplayMessage("Saved trace to " + name, 4000);
+  else
+    DisplayMessage("Failed to save trace to " + name, 4000);
+}
+
 void RequestRefreshInfo()
 {
   s_request_refresh_info = true;
@@ -58,6 +58,9 @@ State GetState();
 void SaveScreenShot(bool wait_for_completion = false);
 void SaveScreenShot(const std::string& name, bool wait_for_completion = false);
 
+// Starts recording a trace of the emulation threads, or stops and saves it to the dump folder.
+void ToggleTraceRecording();
+
 void Callback_WiimoteInterruptChannel(int _number, u16 _channelID, const void* _pData, u32 _Size);
 
 // This displays messages in a user-visible way.
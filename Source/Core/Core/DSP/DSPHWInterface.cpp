@@ -327,6 +327,7 @@ static const u8* gdsp_ddma_out(u16 dsp_addr, u32 addr, u32 size)
           Common::swap16(*(const u16*)&src[dsp_addr + i]);
     }
   }
+  Host::MainMemoryWritten(addr & 0x7FFFFFFF, size);
 
   DEBUG_LOG(DSPLLE, "*** ddma_out DRAM_DSP (0x%04x) -> RAM (0x%08x) : size (0x%08x)", dsp_addr / 2,
             addr, size);
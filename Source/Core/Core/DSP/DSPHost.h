@@ -19,6 +19,8 @@ namespace Host
 {
 u8 ReadHostMemory(u32 addr);
 void WriteHostMemory(u8 value, u32 addr);
+// Called after the DSP wrote to main memory through g_dsp.cpu_ram.
+void MainMemoryWritten(u32 addr, u32 size);
 void OSD_AddMessage(const std::string& str, u32 ms);
 bool OnThread();
 bool IsWiiHost();
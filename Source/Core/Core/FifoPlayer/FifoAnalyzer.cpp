@@ -194,6 +194,32 @@ void LoadCPReg(u32 subCmd, u32 value, CPMemory& cpMem)
   }
 }
 
+FifoCPState SaveCPState(const CPMemory& cpMem)
+{
+  FifoCPState state;
+  state.vtxDesc[0] = static_cast<u32>(cpMem.vtxDesc.Hex & 0x1FFFF);
+  state.vtxDesc[1] = static_cast<u32>(cpMem.vtxDesc.Hex >> 17);
+  for (int i = 0; i < 8; ++i)
+  {
+    state.vtxAttr[i][0] = cpMem.vtxAttr[i].g0.Hex;
+    state.vtxAttr[i][1] = cpMem.vtxAttr[i].g1.Hex;
+    state.vtxAttr[i][2] = cpMem.vtxAttr[i].g2.Hex;
+  }
+  return state;
+}
+
+void LoadCPState(const FifoCPState& state, CPMemory& cpMem)
+{
+  LoadCPReg(0x50, state.vtxDesc[0], cpMem);
+  LoadCPReg(0x60, state.vtxDesc[1], cpMem);
+  for (int i = 0; i < 8; ++i)
+  {
+    LoadCPReg(0x70 + i, state.vtxAttr[i][0], cpMem);
+    LoadCPReg(0x80 + i, state.vtxAttr[i][1], cpMem);
+    LoadCPReg(0x90 + i, state.vtxAttr[i][2], cpMem);
+  }
+}
+
 void CalculateVertexElementSizes(int sizes[], int vatIndex, const CPMemory& cpMem)
 {
   const TVtxDesc& vtxDesc = cpMem.vtxDesc;
@@ -6,6 +6,7 @@
 
 #include "Common/CommonTypes.h"
 
+#include "Core/FifoPlayer/FifoDataFile.h"
 #include "VideoCommon/CPMemory.h"
 
 namespace FifoAnalyzer
@@ -33,6 +34,9 @@ struct CPMemory
 };
 
 void LoadCPReg(u32 subCmd, u32 value, CPMemory& cpMem);
+// Converts between the analyzer's CP state and the one stored with each frame.
+FifoCPState SaveCPState(const CPMemory& cpMem);
+void LoadCPState(const FifoCPState& state, CPMemory& cpMem);
 
 void CalculateVertexElementSizes(int sizes[], int vatIndex, const CPMemory& cpMem);
 
@@ -6,19 +6,29 @@
 
 #include <algorithm>
 #include <cstring>
+#include <lzo/lzo1x.h>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "Common/CommonPaths.h"
 #include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
 
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 4,
-  MIN_LOADER_VERSION = 1,
+  VERSION_NUMBER = 5,
+  // Version 5 stores frames as compressed chunks, which older loaders can't read.
+  MIN_LOADER_VERSION = 5,
 };
 
+// Upper bound for the uncompressed size of a frame chunk. A frame's memory updates can't cover
+// more than all of RAM and texture memory, so anything larger is a corrupt file.
+constexpr u32 MAX_UNCOMPRESSED_FRAME_SIZE = 256 * 1024 * 1024;
+
 #pragma pack(push, 1)
 
 struct FileHeader
@@ -43,6 +53,7 @@ struct FileHeader
 };
 static_assert(sizeof(FileHeader) == 128, "FileHeader should be 128 bytes");
 
+// Frame list entry up to version 4.
 struct FileFrameInfo
 {
   u64 fifoDataOffset;
@@ -55,6 +66,25 @@ struct FileFrameInfo
 };
 static_assert(sizeof(FileFrameInfo) == 64, "FileFrameInfo should be 64 bytes");
 
+// Frame list entry since version 5. Each frame is an LZO compressed chunk, which holds the FIFO
+// data, then the FileMemoryUpdates of the frame, then their data. The dataOffset of the memory
+// updates is relative to the start of the uncompressed chunk. cpState is only set if the file has
+// FLAG_HAS_FRAME_CP_STATE.
+struct FileFrameChunk
+{
+  u64 chunkOffset;
+  u32 chunkSize;
+  u32 uncompressedSize;
+  u32 fifoDataSize;
+  u32 fifoStart;
+  u32 fifoEnd;
+  u32 numMemoryUpdates;
+  u64 memoryUpdateSize;
+  FifoCPState cpState;
+  u8 reserved[16];
+};
+static_assert(sizeof(FileFrameChunk) == 160, "FileFrameChunk should be 160 bytes");
+
 struct FileMemoryUpdate
 {
   u32 fifoPosition;
@@ -68,15 +98,121 @@ static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 byt
 
 #pragma pack(pop)
 
-FifoDataFile::FifoDataFile() = default;
+static u64 SumMemoryUpdateSizes(const std::vector<MemoryUpdate>& memUpdates)
+{
+  u64 size = 0;
+  for (const MemoryUpdate& memUpdate : memUpdates)
+    size += memUpdate.data.size();
+  return size;
+}
+
+static std::vector<u8> EncodeFrame(const FifoFrameInfo& frame)
+{
+  const size_t updateListSize = frame.memoryUpdates.size() * sizeof(FileMemoryUpdate);
+  std::vector<u8> chunk(frame.fifoData.size() + updateListSize +
+                        SumMemoryUpdateSizes(frame.memoryUpdates));
+  std::copy(frame.fifoData.begin(), frame.fifoData.end(), chunk.begin());
+
+  size_t updateOffset = frame.fifoData.size();
+  size_t dataOffset = updateOffset + updateListSize;
+  for (const MemoryUpdate& srcUpdate : frame.memoryUpdates)
+  {
+    FileMemoryUpdate dstUpdate = {};
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.dataOffset = dataOffset;
+    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
+    dstUpdate.type = srcUpdate.type;
+    std::memcpy(&chunk[updateOffset], &dstUpdate, sizeof(FileMemoryUpdate));
+    updateOffset += sizeof(FileMemoryUpdate);
+
+    std::copy(srcUpdate.data.begin(), srcUpdate.data.end(), chunk.begin() + dataOffset);
+    dataOffset += srcUpdate.data.size();
+  }
+
+  return chunk;
+}
+
+static bool DecodeFrame(const std::vector<u8>& chunk, u32 fifoDataSize, u32 numMemoryUpdates,
+                        FifoFrameInfo* frame)
+{
+  const u64 updateListEnd = u64{fifoDataSize} + u64{numMemoryUpdates} * sizeof(FileMemoryUpdate);
+  if (chunk.size() < updateListEnd)
+    return false;
+
+  frame->fifoData.assign(chunk.begin(), chunk.begin() + fifoDataSize);
+  frame->memoryUpdates.resize(numMemoryUpdates);
+  for (u32 i = 0; i < numMemoryUpdates; ++i)
+  {
+    FileMemoryUpdate srcUpdate;
+    std::memcpy(&srcUpdate, &chunk[fifoDataSize + i * sizeof(FileMemoryUpdate)],
+                sizeof(FileMemoryUpdate));
+    if (srcUpdate.dataOffset > chunk.size() ||
+        srcUpdate.dataSize > chunk.size() - srcUpdate.dataOffset)
+    {
+      return false;
+    }
+
+    MemoryUpdate& dstUpdate = frame->memoryUpdates[i];
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
+    dstUpdate.data.assign(chunk.begin() + srcUpdate.dataOffset,
+                          chunk.begin() + srcUpdate.dataOffset + srcUpdate.dataSize);
+  }
+
+  return true;
+}
+
+static std::vector<u8> Compress(const std::vector<u8>& data)
+{
+  std::vector<u8> workMemory(LZO1X_1_MEM_COMPRESS);
+  std::vector<u8> compressed(data.size() + data.size() / 16 + 64 + 3);
+  lzo_uint compressedSize = 0;
+  lzo1x_1_compress(data.data(), data.size(), compressed.data(), &compressedSize,
+                   workMemory.data());
+  compressed.resize(compressedSize);
+  return compressed;
+}
+
+static bool Decompress(const std::vector<u8>& compressed, u32 size, std::vector<u8>* data)
+{
+  if (size > MAX_UNCOMPRESSED_FRAME_SIZE)
+    return false;
+
+  data->resize(size);
+  lzo_uint decompressedSize = size;
+  return lzo1x_decompress_safe(compressed.data(), compressed.size(), data->data(),
+                               &decompressedSize, nullptr) == LZO_E_OK &&
+         decompressedSize == size;
+}
+
+static bool IsRangeInFile(u64 offset, u64 size, u64 fileSize)
+{
+  return offset <= fileSize && size <= fileSize - offset;
+}
 
-FifoDataFile::~FifoDataFile() = default;
+FifoDataFile::FifoDataFile() : m_Version(VERSION_NUMBER)
+{
+}
+
+FifoDataFile::~FifoDataFile()
+{
+  m_DataFile.reset();
+  if (!m_ScratchDir.empty())
+    File::DeleteDirRecursively(m_ScratchDir);
+}
 
 bool FifoDataFile::HasBrokenEFBCopies() const
 {
   return m_Version < 2;
 }
 
+bool FifoDataFile::HasFrameCPState() const
+{
+  return GetFlag(FLAG_HAS_FRAME_CP_STATE);
+}
+
 void FifoDataFile::SetIsWii(bool isWii)
 {
   SetFlag(FLAG_IS_WII, isWii);
@@ -89,21 +225,139 @@ bool FifoDataFile::GetIsWii() const
 
 void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  const std::vector<u8> uncompressed = EncodeFrame(frameInfo);
+  const std::vector<u8> chunk = Compress(uncompressed);
+
+  std::lock_guard<std::mutex> lk(m_Lock);
+  if (!m_DataFile && !OpenScratchFile())
+  {
+    ERROR_LOG(CORE, "Could not create a scratch file for the FIFO log");
+    return;
+  }
+  // Frames are only added while recording, which always stores the CP state.
+  SetFlag(FLAG_HAS_FRAME_CP_STATE, true);
+
+  FrameIndexEntry entry = {};
+  m_DataFile->Seek(0, SEEK_END);
+  entry.dataOffset = m_DataFile->Tell();
+  entry.dataSize = static_cast<u32>(chunk.size());
+  entry.uncompressedSize = static_cast<u32>(uncompressed.size());
+  entry.fifoDataSize = static_cast<u32>(frameInfo.fifoData.size());
+  entry.fifoStart = frameInfo.fifoStart;
+  entry.fifoEnd = frameInfo.fifoEnd;
+  entry.numMemoryUpdates = static_cast<u32>(frameInfo.memoryUpdates.size());
+  entry.memoryUpdateSize = SumMemoryUpdateSizes(frameInfo.memoryUpdates);
+  entry.cpState = frameInfo.cpState;
+
+  if (!m_DataFile->WriteBytes(chunk.data(), chunk.size()))
+  {
+    ERROR_LOG(CORE, "Could not write frame %u of the FIFO log",
+              static_cast<u32>(m_FrameIndex.size()));
+    m_DataFile->Clear();
+    return;
+  }
+
+  m_FrameIndex.push_back(entry);
+}
+
+FifoFrameInfo FifoDataFile::GetFrame(u32 frame) const
+{
+  FifoFrameInfo frameInfo;
+  std::vector<u8> chunk;
+  FrameIndexEntry entry;
+  bool success;
+  {
+    std::lock_guard<std::mutex> lk(m_Lock);
+    entry = m_FrameIndex[frame];
+    if (m_Version >= 5)
+    {
+      success = ReadChunk(entry, &chunk);
+    }
+    else
+    {
+      frameInfo.fifoData.resize(entry.fifoDataSize);
+      success = m_DataFile->Seek(entry.dataOffset, SEEK_SET) &&
+                m_DataFile->ReadBytes(frameInfo.fifoData.data(), entry.fifoDataSize);
+      ReadMemoryUpdates(entry.memoryUpdatesOffset, entry.numMemoryUpdates,
+                        frameInfo.memoryUpdates, *m_DataFile);
+      m_DataFile->Clear();
+    }
+  }
+
+  // Decompress without holding the lock, the CPU and UI threads may both read frames.
+  if (success && m_Version >= 5)
+  {
+    std::vector<u8> uncompressed;
+    success = Decompress(chunk, entry.uncompressedSize, &uncompressed) &&
+              DecodeFrame(uncompressed, entry.fifoDataSize, entry.numMemoryUpdates, &frameInfo);
+  }
+
+  frameInfo.fifoStart = entry.fifoStart;
+  frameInfo.fifoEnd = entry.fifoEnd;
+  frameInfo.cpState = entry.cpState;
+  if (!success)
+  {
+    ERROR_LOG(CORE, "Could not read frame %u of the FIFO log", frame);
+    frameInfo.fifoData.clear();
+    frameInfo.memoryUpdates.clear();
+  }
+
+  return frameInfo;
+}
+
+u32 FifoDataFile::GetFrameCount() const
+{
+  std::lock_guard<std::mutex> lk(m_Lock);
+  return static_cast<u32>(m_FrameIndex.size());
+}
+
+u64 FifoDataFile::GetFifoDataSize() const
+{
+  std::lock_guard<std::mutex> lk(m_Lock);
+  u64 size = 0;
+  for (const FrameIndexEntry& entry : m_FrameIndex)
+    size += entry.fifoDataSize;
+  return size;
+}
+
+u64 FifoDataFile::GetMemoryUpdateSize() const
+{
+  std::lock_guard<std::mutex> lk(m_Lock);
+  u64 size = 0;
+  for (const FrameIndexEntry& entry : m_FrameIndex)
+    size += entry.memoryUpdateSize;
+  return size;
 }
 
 bool FifoDataFile::Save(const std::string& filename)
 {
+  // The frames are copied from the loaded file, which may be the one being replaced, so the new
+  // file is only moved over it once it has been written completely.
+  const std::string tempFilename = filename + ".tmp";
   File::IOFile file;
-  if (!file.Open(filename, "wb"))
+  if (!file.Open(tempFilename, "wb"))
     return false;
 
+  if (!WriteTo(file) || !file.Close() || !File::Rename(tempFilename, filename))
+  {
+    file.Close();
+    File::Delete(tempFilename);
+    return false;
+  }
+
+  return true;
+}
+
+bool FifoDataFile::WriteTo(File::IOFile& file)
+{
+  const u32 frameCount = GetFrameCount();
+
   // Add space for header
   PadFile(sizeof(FileHeader), file);
 
   // Add space for frame list
   u64 frameListOffset = file.Tell();
-  PadFile(m_Frames.size() * sizeof(FileFrameInfo), file);
+  PadFile(frameCount * sizeof(FileFrameChunk), file);
 
   u64 bpMemOffset = file.Tell();
   file.WriteArray(m_BPMem, BP_MEM_SIZE);
@@ -142,60 +396,70 @@ bool FifoDataFile::Save(const std::string& filename)
   header.texMemSize = TEX_MEM_SIZE;
 
   header.frameListOffset = frameListOffset;
-  header.frameCount = (u32)m_Frames.size();
+  header.frameCount = frameCount;
 
   header.flags = m_Flags;
 
   file.Seek(0, SEEK_SET);
   file.WriteBytes(&header, sizeof(FileHeader));
 
-  // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
+  // Write frames list. Frames of older versions are converted, the others are copied as they are.
+  std::vector<u8> chunk;
+  for (u32 i = 0; i < frameCount; ++i)
   {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
-
-    // Write FIFO data
+    FrameIndexEntry entry;
+    if (m_Version >= 5)
+    {
+      std::lock_guard<std::mutex> lk(m_Lock);
+      entry = m_FrameIndex[i];
+      if (!ReadChunk(entry, &chunk))
+        return false;
+    }
+    else
+    {
+      const FifoFrameInfo frame = GetFrame(i);
+      const std::vector<u8> uncompressed = EncodeFrame(frame);
+      chunk = Compress(uncompressed);
+
+      std::lock_guard<std::mutex> lk(m_Lock);
+      entry = m_FrameIndex[i];
+      entry.uncompressedSize = static_cast<u32>(uncompressed.size());
+    }
+
+    // Write the chunk
     file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
-
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
-    dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-    dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
+    FileFrameChunk dstFrame = {};
+    dstFrame.chunkOffset = file.Tell();
+    dstFrame.chunkSize = static_cast<u32>(chunk.size());
+    dstFrame.uncompressedSize = entry.uncompressedSize;
+    dstFrame.fifoDataSize = entry.fifoDataSize;
+    dstFrame.fifoStart = entry.fifoStart;
+    dstFrame.fifoEnd = entry.fifoEnd;
+    dstFrame.numMemoryUpdates = entry.numMemoryUpdates;
+    dstFrame.memoryUpdateSize = entry.memoryUpdateSize;
+    dstFrame.cpState = entry.cpState;
+    file.WriteBytes(chunk.data(), chunk.size());
 
     // Write frame info
-    u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
+    u64 frameOffset = frameListOffset + (i * sizeof(FileFrameChunk));
     file.Seek(frameOffset, SEEK_SET);
-    file.WriteBytes(&dstFrame, sizeof(FileFrameInfo));
+    file.WriteBytes(&dstFrame, sizeof(FileFrameChunk));
   }
 
-  if (!file.Close())
-    return false;
-
-  return true;
+  return file.IsGood();
 }
 
 std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bool flagsOnly)
 {
-  File::IOFile file;
-  file.Open(filename, "rb");
-  if (!file)
+  auto file = std::make_unique<File::IOFile>(filename, "rb");
+  if (!*file)
     return nullptr;
 
   FileHeader header;
-  file.ReadBytes(&header, sizeof(header));
+  file->ReadBytes(&header, sizeof(header));
 
   if (header.fileId != FILE_ID || header.min_loader_version > VERSION_NUMBER)
-  {
-    file.Close();
     return nullptr;
-  }
 
   auto dataFile = std::make_unique<FifoDataFile>();
 
@@ -203,61 +467,130 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
   dataFile->m_Version = header.file_version;
 
   if (flagsOnly)
-  {
-    file.Close();
     return dataFile;
-  }
 
   u32 size = std::min<u32>(BP_MEM_SIZE, header.bpMemSize);
-  file.Seek(header.bpMemOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_BPMem, size);
+  file->Seek(header.bpMemOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_BPMem, size);
 
   size = std::min<u32>(CP_MEM_SIZE, header.cpMemSize);
-  file.Seek(header.cpMemOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_CPMem, size);
+  file->Seek(header.cpMemOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_CPMem, size);
 
   size = std::min<u32>(XF_MEM_SIZE, header.xfMemSize);
-  file.Seek(header.xfMemOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_XFMem, size);
+  file->Seek(header.xfMemOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_XFMem, size);
 
   size = std::min<u32>(XF_REGS_SIZE, header.xfRegsSize);
-  file.Seek(header.xfRegsOffset, SEEK_SET);
-  file.ReadArray(dataFile->m_XFRegs, size);
+  file->Seek(header.xfRegsOffset, SEEK_SET);
+  file->ReadArray(dataFile->m_XFRegs, size);
 
   // Texture memory saving was added in version 4.
   std::memset(dataFile->m_TexMem, 0, TEX_MEM_SIZE);
   if (dataFile->m_Version >= 4)
   {
     size = std::min<u32>(TEX_MEM_SIZE, header.texMemSize);
-    file.Seek(header.texMemOffset, SEEK_SET);
-    file.ReadArray(dataFile->m_TexMem, size);
+    file->Seek(header.texMemOffset, SEEK_SET);
+    file->ReadArray(dataFile->m_TexMem, size);
   }
 
-  // Read frames
-  for (u32 i = 0; i < header.frameCount; ++i)
+  // Read the frame index. The frames themselves are read when needed, so the sizes in the index
+  // are checked against the file now.
+  const u64 fileSize = file->GetSize();
+  const u64 frameListEntrySize =
+      dataFile->m_Version >= 5 ? sizeof(FileFrameChunk) : sizeof(FileFrameInfo);
+  if (!IsRangeInFile(header.frameListOffset, u64{header.frameCount} * frameListEntrySize, fileSize))
+    return nullptr;
+
+  dataFile->m_FrameIndex.resize(header.frameCount);
+  if (dataFile->m_Version >= 5)
   {
-    u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
-    FileFrameInfo srcFrame;
-    file.ReadBytes(&srcFrame, sizeof(FileFrameInfo));
+    std::vector<FileFrameChunk> srcFrames(header.frameCount);
+    file->Seek(header.frameListOffset, SEEK_SET);
+    if (!file->ReadArray(srcFrames.data(), srcFrames.size()))
+      return nullptr;
+
+    for (u32 i = 0; i < header.frameCount; ++i)
+    {
+      const FileFrameChunk& srcFrame = srcFrames[i];
+      if (!IsRangeInFile(srcFrame.chunkOffset, srcFrame.chunkSize, fileSize) ||
+          srcFrame.uncompressedSize > MAX_UNCOMPRESSED_FRAME_SIZE ||
+          srcFrame.fifoDataSize > srcFrame.uncompressedSize)
+      {
+        return nullptr;
+      }
+
+      FrameIndexEntry& dstFrame = dataFile->m_FrameIndex[i];
+      dstFrame.dataOffset = srcFrame.chunkOffset;
+      dstFrame.dataSize = srcFrame.chunkSize;
+      dstFrame.uncompressedSize = srcFrame.uncompressedSize;
+      dstFrame.fifoDataSize = srcFrame.fifoDataSize;
+      dstFrame.fifoStart = srcFrame.fifoStart;
+      dstFrame.fifoEnd = srcFrame.fifoEnd;
+      dstFrame.numMemoryUpdates = srcFrame.numMemoryUpdates;
+      dstFrame.memoryUpdateSize = srcFrame.memoryUpdateSize;
+      dstFrame.cpState = srcFrame.cpState;
+    }
+  }
+  else
+  {
+    for (u32 i = 0; i < header.frameCount; ++i)
+    {
+      u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
+      file->Seek(frameOffset, SEEK_SET);
+      FileFrameInfo srcFrame;
+      if (!file->ReadBytes(&srcFrame, sizeof(FileFrameInfo)) ||
+          !IsRangeInFile(srcFrame.fifoDataOffset, srcFrame.fifoDataSize, fileSize) ||
+          !IsRangeInFile(srcFrame.memoryUpdatesOffset,
+                         u64{srcFrame.numMemoryUpdates} * sizeof(FileMemoryUpdate), fileSize))
+      {
+        return nullptr;
+      }
+
+      FrameIndexEntry& dstFrame = dataFile->m_FrameIndex[i];
+      dstFrame.dataOffset = srcFrame.fifoDataOffset;
+      dstFrame.memoryUpdatesOffset = srcFrame.memoryUpdatesOffset;
+      dstFrame.fifoDataSize = srcFrame.fifoDataSize;
+      dstFrame.fifoStart = srcFrame.fifoStart;
+      dstFrame.fifoEnd = srcFrame.fifoEnd;
+      dstFrame.numMemoryUpdates = srcFrame.numMemoryUpdates;
+
+      // Only the sizes are needed here, not the data.
+      std::vector<FileMemoryUpdate> memUpdates(srcFrame.numMemoryUpdates);
+      file->Seek(srcFrame.memoryUpdatesOffset, SEEK_SET);
+      file->ReadArray(memUpdates.data(), memUpdates.size());
+      dstFrame.memoryUpdateSize = 0;
+      for (const FileMemoryUpdate& memUpdate : memUpdates)
+        dstFrame.memoryUpdateSize += memUpdate.dataSize;
+    }
+  }
 
-    FifoFrameInfo dstFrame;
-    dstFrame.fifoData.resize(srcFrame.fifoDataSize);
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
+  dataFile->m_DataFile = std::move(file);
+  return dataFile;
+}
 
-    file.Seek(srcFrame.fifoDataOffset, SEEK_SET);
-    file.ReadBytes(dstFrame.fifoData.data(), srcFrame.fifoDataSize);
+bool FifoDataFile::OpenScratchFile()
+{
+  m_ScratchDir = File::CreateTempDir();
+  if (m_ScratchDir.empty())
+    return false;
 
-    ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
-                      dstFrame.memoryUpdates, file);
+  m_DataFile = std::make_unique<File::IOFile>(m_ScratchDir + DIR_SEP "frames.bin", "w+b");
+  return m_DataFile->IsOpen();
+}
 
-    dataFile->AddFrame(dstFrame);
+bool FifoDataFile::ReadChunk(const FrameIndexEntry& entry, std::vector<u8>* chunk) const
+{
+  chunk->resize(entry.dataSize);
+  if (!m_DataFile || !m_DataFile->Seek(entry.dataOffset, SEEK_SET) ||
+      !m_DataFile->ReadBytes(chunk->data(), chunk->size()))
+  {
+    if (m_DataFile)
+      m_DataFile->Clear();
+    return false;
   }
 
-  file.Close();
-
-  return dataFile;
+  return true;
 }
 
 void FifoDataFile::PadFile(size_t numBytes, File::IOFile& file)
@@ -279,37 +612,6 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
-{
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
-
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
-  {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
-
-    // Write memory
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
-
-    FileMemoryUpdate dstUpdate;
-    dstUpdate.address = srcUpdate.address;
-    dstUpdate.dataOffset = dataOffset;
-    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
-    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.type = srcUpdate.type;
-
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
-  }
-
-  return updateListOffset;
-}
-
 void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                      std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
 {
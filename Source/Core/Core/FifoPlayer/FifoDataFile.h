@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -31,12 +32,21 @@ struct MemoryUpdate
   Type type;
 };
 
+// The CP registers the FIFO analyzer needs to find the objects in a frame, as they are at the start
+// of the frame. Stored with each frame, so that frames can be analyzed without the ones before.
+struct FifoCPState
+{
+  u32 vtxDesc[2];     // CP registers 0x50 and 0x60
+  u32 vtxAttr[8][3];  // CP registers 0x70, 0x80 and 0x90 for each VAT
+};
+
 struct FifoFrameInfo
 {
   std::vector<u8> fifoData;
 
   u32 fifoStart;
   u32 fifoEnd;
+  FifoCPState cpState = {};
 
   // Must be sorted by fifoPosition
   std::vector<MemoryUpdate> memoryUpdates;
@@ -60,15 +70,24 @@ public:
   void SetIsWii(bool isWii);
   bool GetIsWii() const;
   bool HasBrokenEFBCopies() const;
+  // Whether the frames hold the CP state they start with. Files from before version 5, and files
+  // converted from them, only have the one at the start of the file.
+  bool HasFrameCPState() const;
 
   u32* GetBPMem() { return m_BPMem; }
   u32* GetCPMem() { return m_CPMem; }
   u32* GetXFMem() { return m_XFMem; }
   u32* GetXFRegs() { return m_XFRegs; }
   u8* GetTexMem() { return m_TexMem; }
+  // Compresses the frame and appends it to a scratch file, so that recordings don't need to fit
+  // in memory.
   void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
-  u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
+  // Reads the frame from the file. Only the frame index is kept in memory.
+  FifoFrameInfo GetFrame(u32 frame) const;
+  u32 GetFrameCount() const;
+  // Totals over all frames, taken from the frame index.
+  u64 GetFifoDataSize() const;
+  u64 GetMemoryUpdateSize() const;
   bool Save(const std::string& filename);
 
   static std::unique_ptr<FifoDataFile> Load(const std::string& filename, bool flagsOnly);
@@ -76,15 +95,37 @@ public:
 private:
   enum
   {
-    FLAG_IS_WII = 1
+    FLAG_IS_WII = 1,
+    FLAG_HAS_FRAME_CP_STATE = 2,
+  };
+
+  struct FrameIndexEntry
+  {
+    // Version 5 and later: the compressed frame. Older versions: the FIFO data.
+    u64 dataOffset;
+    u32 dataSize;
+    // Version 5 and later only.
+    u32 uncompressedSize;
+    // Older versions only.
+    u64 memoryUpdatesOffset;
+
+    u32 fifoDataSize;
+    u32 fifoStart;
+    u32 fifoEnd;
+    u32 numMemoryUpdates;
+    u64 memoryUpdateSize;
+    FifoCPState cpState;
   };
 
-  void PadFile(size_t numBytes, File::IOFile& file);
+  bool OpenScratchFile();
+  bool WriteTo(File::IOFile& file);
+  bool ReadChunk(const FrameIndexEntry& entry, std::vector<u8>* chunk) const;
+
+  static void PadFile(size_t numBytes, File::IOFile& file);
 
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
   static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                 std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
 
@@ -95,7 +136,12 @@ private:
   u8 m_TexMem[TEX_MEM_SIZE];
 
   u32 m_Flags = 0;
-  u32 m_Version = 0;
-
-  std::vector<FifoFrameInfo> m_Frames;
+  u32 m_Version;
+
+  // Guards the frame index and the data file, which are shared by the CPU, video and UI threads.
+  mutable std::mutex m_Lock;
+  std::vector<FrameIndexEntry> m_FrameIndex;
+  // The file that was loaded, or the scratch file of a recording.
+  std::unique_ptr<File::IOFile> m_DataFile;
+  std::string m_ScratchDir;
 };
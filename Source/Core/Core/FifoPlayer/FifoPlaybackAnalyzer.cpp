@@ -21,8 +21,7 @@ struct CmdData
   const u8* ptr;
 };
 
-void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
-                                         std::vector<AnalyzedFrameInfo>& frameInfo)
+void FifoPlaybackAnalyzer::Init(FifoDataFile* file)
 {
   u32* cpMem = file->GetCPMem();
   FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], s_CpMem);
@@ -34,69 +33,61 @@ void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
     FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], s_CpMem);
     FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], s_CpMem);
   }
+}
 
-  frameInfo.clear();
-  frameInfo.resize(file->GetFrameCount());
-
-  for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
-  {
-    const FifoFrameInfo& frame = file->GetFrame(frameIdx);
-    AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
+void FifoPlaybackAnalyzer::AnalyzeFrameWithCPState(const FifoFrameInfo& frame,
+                                                   AnalyzedFrameInfo& analyzed)
+{
+  FifoAnalyzer::LoadCPState(frame.cpState, s_CpMem);
+  AnalyzeFrame(frame, analyzed);
+}
 
-    s_DrawingObject = false;
+void FifoPlaybackAnalyzer::AnalyzeFrame(const FifoFrameInfo& frame, AnalyzedFrameInfo& analyzed)
+{
+  s_DrawingObject = false;
 
-    u32 cmdStart = 0;
-    u32 nextMemUpdate = 0;
+  u32 cmdStart = 0;
 
 #if LOG_FIFO_CMDS
-    // Debugging
-    std::vector<CmdData> prevCmds;
+  // Debugging
+  std::vector<CmdData> prevCmds;
 #endif
 
-    while (cmdStart < frame.fifoData.size())
-    {
-      // Add memory updates that have occurred before this point in the frame
-      while (nextMemUpdate < frame.memoryUpdates.size() &&
-             frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
-      {
-        analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
-        ++nextMemUpdate;
-      }
-
-      bool wasDrawing = s_DrawingObject;
+  while (cmdStart < frame.fifoData.size())
+  {
+    bool wasDrawing = s_DrawingObject;
 
-      u32 cmdSize = FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DECODE_PLAYBACK);
+    u32 cmdSize = FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DECODE_PLAYBACK);
 
 #if LOG_FIFO_CMDS
-      CmdData cmdData;
-      cmdData.offset = cmdStart;
-      cmdData.ptr = &frame.fifoData[cmdStart];
-      cmdData.size = cmdSize;
-      prevCmds.push_back(cmdData);
+    CmdData cmdData;
+    cmdData.offset = cmdStart;
+    cmdData.ptr = &frame.fifoData[cmdStart];
+    cmdData.size = cmdSize;
+    prevCmds.push_back(cmdData);
 #endif
 
-      // Check for error
-      if (cmdSize == 0)
-      {
-        // Clean up frame analysis
-        analyzed.objectStarts.clear();
-        analyzed.objectEnds.clear();
-
-        return;
-      }
-
-      if (wasDrawing != s_DrawingObject)
-      {
-        if (s_DrawingObject)
-          analyzed.objectStarts.push_back(cmdStart);
-        else
-          analyzed.objectEnds.push_back(cmdStart);
-      }
-
-      cmdStart += cmdSize;
+    // Check for error
+    if (cmdSize == 0)
+    {
+      // Clean up frame analysis
+      analyzed.objectStarts.clear();
+      analyzed.objectEnds.clear();
+
+      return;
     }
 
-    if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
-      analyzed.objectEnds.push_back(cmdStart);
+    if (wasDrawing != s_DrawingObject)
+    {
+      if (s_DrawingObject)
+        analyzed.objectStarts.push_back(cmdStart);
+      else
+        analyzed.objectEnds.push_back(cmdStart);
+    }
+
+    cmdStart += cmdSize;
   }
+
+  if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
+    analyzed.objectEnds.push_back(cmdStart);
 }
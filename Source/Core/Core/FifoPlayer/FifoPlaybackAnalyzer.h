@@ -13,10 +13,16 @@ struct AnalyzedFrameInfo
 {
   std::vector<u32> objectStarts;
   std::vector<u32> objectEnds;
-  std::vector<MemoryUpdate> memoryUpdates;
 };
 
 namespace FifoPlaybackAnalyzer
 {
-void AnalyzeFrames(FifoDataFile* file, std::vector<AnalyzedFrameInfo>& frameInfo);
+// Loads the CP state at the start of the file.
+void Init(FifoDataFile* file);
+// Finds the objects drawn in the frame. Frames can change the CP state the next ones are decoded
+// with, so without the CP state stored with the frame they have to be analyzed in order after
+// Init.
+void AnalyzeFrame(const FifoFrameInfo& frame, AnalyzedFrameInfo& analyzed);
+// Same, starting with the CP state stored with the frame.
+void AnalyzeFrameWithCPState(const FifoFrameInfo& frame, AnalyzedFrameInfo& analyzed);
 }  // namespace FifoPlaybackAnalyzer
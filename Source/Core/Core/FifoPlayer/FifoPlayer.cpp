@@ -47,8 +47,12 @@ bool FifoPlayer::Open(const std::string& filename)
 
   if (m_File)
   {
+    std::lock_guard<std::mutex> lk(m_FrameInfoLock);
     FifoAnalyzer::Init();
-    FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), m_FrameInfo);
+    FifoPlaybackAnalyzer::Init(m_File.get());
+    m_FrameInfo.assign(m_File->GetFrameCount(), {});
+    m_FrameAnalyzed.assign(m_File->GetFrameCount(), false);
+    m_NextAnalyzedFrame = 0;
 
     m_FrameRangeEnd = m_File->GetFrameCount();
   }
@@ -127,8 +131,15 @@ CPU::State FifoPlayer::AdvanceFrame()
 {
   if (m_CurrentFrame >= m_FrameRangeEnd)
   {
-    if (!m_Loop)
+    if (m_LoopCount != 0)
+    {
+      if (++m_LoopsPlayed >= m_LoopCount)
+        return CPU::State::PowerDown;
+    }
+    else if (!m_Loop)
+    {
       return CPU::State::PowerDown;
+    }
     // If there are zero frames in the range then sleep instead of busy spinning
     if (m_FrameRangeStart >= m_FrameRangeEnd)
       return CPU::State::Stepping;
@@ -148,7 +159,8 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  const FifoFrameInfo frame = m_File->GetFrame(m_CurrentFrame);
+  WriteFrame(frame, AnalyzeFrame(m_CurrentFrame, frame));
 
   ++m_CurrentFrame;
   return CPU::State::Running;
@@ -162,16 +174,55 @@ std::unique_ptr<CPUCoreBase> FifoPlayer::GetCPUCore()
   return std::make_unique<CPUCore>(this);
 }
 
-u32 FifoPlayer::GetFrameObjectCount() const
+u32 FifoPlayer::GetFrameObjectCount()
 {
-  if (m_CurrentFrame < m_FrameInfo.size())
+  if (m_File && m_CurrentFrame < m_File->GetFrameCount())
   {
-    return (u32)(m_FrameInfo[m_CurrentFrame].objectStarts.size());
+    return (u32)(GetAnalyzedFrameInfo(m_CurrentFrame).objectStarts.size());
   }
 
   return 0;
 }
 
+const AnalyzedFrameInfo& FifoPlayer::GetAnalyzedFrameInfo(u32 frame)
+{
+  {
+    std::lock_guard<std::mutex> lk(m_FrameInfoLock);
+    if (m_FrameAnalyzed[frame])
+      return m_FrameInfo[frame];
+  }
+
+  return AnalyzeFrame(frame, m_File->GetFrame(frame));
+}
+
+const AnalyzedFrameInfo& FifoPlayer::AnalyzeFrame(u32 frame, const FifoFrameInfo& frameInfo)
+{
+  std::lock_guard<std::mutex> lk(m_FrameInfoLock);
+  if (m_FrameAnalyzed[frame])
+    return m_FrameInfo[frame];
+
+  if (m_File->HasFrameCPState())
+  {
+    FifoPlaybackAnalyzer::AnalyzeFrameWithCPState(frameInfo, m_FrameInfo[frame]);
+    m_FrameAnalyzed[frame] = true;
+    return m_FrameInfo[frame];
+  }
+
+  // Without it, the analyzer carries the CP state over from one frame to the next, so every frame
+  // before the requested one has to be analyzed first.
+  for (; m_NextAnalyzedFrame < frame; ++m_NextAnalyzedFrame)
+  {
+    FifoPlaybackAnalyzer::AnalyzeFrame(m_File->GetFrame(m_NextAnalyzedFrame),
+                                       m_FrameInfo[m_NextAnalyzedFrame]);
+    m_FrameAnalyzed[m_NextAnalyzedFrame] = true;
+  }
+
+  FifoPlaybackAnalyzer::AnalyzeFrame(frameInfo, m_FrameInfo[frame]);
+  m_FrameAnalyzed[frame] = true;
+  ++m_NextAnalyzedFrame;
+  return m_FrameInfo[frame];
+}
+
 void FifoPlayer::SetFrameRangeStart(u32 start)
 {
   if (m_File)
@@ -285,7 +336,7 @@ void FifoPlayer::WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate,
 
   while (nextMemUpdate < frame.memoryUpdates.size() && dataStart < dataEnd)
   {
-    const MemoryUpdate& memUpdate = info.memoryUpdates[nextMemUpdate];
+    const MemoryUpdate& memUpdate = frame.memoryUpdates[nextMemUpdate];
 
     if (memUpdate.fifoPosition < dataEnd)
     {
@@ -316,7 +367,7 @@ void FifoPlayer::WriteAllMemoryUpdates()
 
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
+    const FifoFrameInfo frame = m_File->GetFrame(frameNum);
     for (auto& update : frame.memoryUpdates)
     {
       WriteMemory(update);
@@ -334,6 +385,7 @@ void FifoPlayer::WriteMemory(const MemoryUpdate& memUpdate)
     mem = &Memory::m_pRAM[memUpdate.address & Memory::RAM_MASK];
 
   std::copy(memUpdate.data.begin(), memUpdate.data.end(), mem);
+  Memory::NotifyWrite(memUpdate.address, memUpdate.data.size());
 }
 
 void FifoPlayer::WriteFifo(const u8* data, u32 start, u32 end)
@@ -372,7 +424,7 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  const FifoFrameInfo frame = m_File->GetFrame(m_CurrentFrame);
 
   // Set fifo bounds
   WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -71,9 +72,11 @@ public:
   std::unique_ptr<CPUCoreBase> GetCPUCore();
 
   FifoDataFile* GetFile() const { return m_File.get(); }
-  u32 GetFrameObjectCount() const;
+  u32 GetFrameObjectCount();
   u32 GetCurrentFrameNum() const { return m_CurrentFrame; }
-  const AnalyzedFrameInfo& GetAnalyzedFrameInfo(u32 frame) const { return m_FrameInfo[frame]; }
+  // Frames are analyzed when they are first played or asked for, so that opening a file or
+  // starting at a later frame doesn't read all of it.
+  const AnalyzedFrameInfo& GetAnalyzedFrameInfo(u32 frame);
   // Frame range
   u32 GetFrameRangeStart() const { return m_FrameRangeStart; }
   void SetFrameRangeStart(u32 start);
@@ -89,6 +92,12 @@ public:
   // If enabled then all memory updates happen at once before the first frame
   // Default is disabled
   void SetEarlyMemoryUpdates(bool enabled) { m_EarlyMemoryUpdates = enabled; }
+  // Plays the frame range count times and then powers down. 0 follows the LoopFifoReplay setting.
+  void SetLoopCount(u32 count)
+  {
+    m_LoopCount = count;
+    m_LoopsPlayed = 0;
+  }
   // Callbacks
   void SetFileLoadedCallback(CallbackFunc callback) { m_FileLoadedCb = callback; }
   void SetFrameWrittenCallback(CallbackFunc callback) { m_FrameWrittenCb = callback; }
@@ -101,6 +110,8 @@ private:
 
   CPU::State AdvanceFrame();
 
+  const AnalyzedFrameInfo& AnalyzeFrame(u32 frame, const FifoFrameInfo& frameInfo);
+
   void WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo& info);
   void WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate, const FifoFrameInfo& frame,
                       const AnalyzedFrameInfo& info);
@@ -134,6 +145,8 @@ private:
   static bool IsHighWatermarkSet();
 
   bool m_Loop;
+  u32 m_LoopCount = 0;
+  u32 m_LoopsPlayed = 0;
 
   u32 m_CurrentFrame = 0;
   u32 m_FrameRangeStart = 0;
@@ -153,5 +166,11 @@ private:
 
   std::unique_ptr<FifoDataFile> m_File;
 
+  // Accessed from both the CPU and the UI thread.
+  std::mutex m_FrameInfoLock;
   std::vector<AnalyzedFrameInfo> m_FrameInfo;
+  std::vector<bool> m_FrameAnalyzed;
+  // Frames of files without the CP state of each frame are analyzed in order. Those before this
+  // one have been, and the analyzer's CP state is the one at the start of this frame.
+  u32 m_NextAnalyzedFrame = 0;
 };
@@ -106,6 +106,8 @@ void FifoRecorder::WriteGPCommand(const u8* data, u32 size)
     }
 
     m_CurrentFrame.memoryUpdates.clear();
+    // The next frame starts with the CP state after the last command of this one.
+    m_CurrentFrame.cpState = FifoAnalyzer::SaveCPState(FifoAnalyzer::s_CpMem);
     m_FifoData.clear();
     m_FrameEnded = false;
   }
@@ -211,6 +213,7 @@ void FifoRecorder::SetVideoMemory(const u32* bpMem, const u32* cpMem, const u32*
   }
 
   FifoRecordAnalyzer::Initialize(cpMem);
+  m_CurrentFrame.cpState = FifoAnalyzer::SaveCPState(FifoAnalyzer::s_CpMem);
 }
 
 FifoRecorder& FifoRecorder::GetInstance()
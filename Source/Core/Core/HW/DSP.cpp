@@ -472,6 +472,13 @@ void UpdateAudioDMA()
   }
 }
 
+// On Wii, ARAM is MEM2, so writes to it have to be tracked like any other write to guest memory.
+static void NotifyARAMWrite(u32 address, u32 size)
+{
+  if (s_ARAM.wii_mode)
+    Memory::NotifyWrite(0x10000000 | (address & s_ARAM.mask), size);
+}
+
 static void Do_ARAM_DMA()
 {
   s_dspState.DMAState = 1;
@@ -553,6 +560,7 @@ static void Do_ARAM_DMA()
           {
             *(u64*)&s_ARAM.ptr[(s_arDMA.ARAddr + 0x400000) & s_ARAM.mask] =
                 Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
+            NotifyARAMWrite(s_arDMA.ARAddr + 0x400000, 8);
           }
           *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
               Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
@@ -562,6 +570,7 @@ static void Do_ARAM_DMA()
           *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
               Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
         }
+        NotifyARAMWrite(s_arDMA.ARAddr, 8);
 
         s_arDMA.MMAddr += 8;
         s_arDMA.ARAddr += 8;
@@ -601,6 +610,7 @@ void WriteARAM(u8 value, u32 address)
 {
   // TODO: verify this on Wii
   s_ARAM.ptr[address & s_ARAM.mask] = value;
+  NotifyARAMWrite(address, sizeof(value));
 }
 
 u8* GetARAMPtr()
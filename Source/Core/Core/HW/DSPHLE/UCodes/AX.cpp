@@ -15,6 +15,7 @@
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+#include "Core/HW/Memmap.h"
 
 #define AX_GC
 #include "Core/HW/DSPHLE/UCodes/AXVoice.h"
@@ -486,6 +487,7 @@ void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
     for (auto& buffer : buffers)
       for (u32 j = 0; j < 5 * 32; ++j)
         *ptr++ = Common::swap32(buffer[j]);
+    Memory::NotifyWrite(write_addr, sizeof(int) * 3 * 5 * 32);
   }
 
   // Then, we read the new temp from the CPU and add to our current
@@ -510,6 +512,7 @@ void AXUCode::UploadLRS(u32 dst_addr)
     buffers[2][i] = Common::swap32(m_samples_surround[i]);
   }
   memcpy(HLEMemory_Get_Pointer(dst_addr), buffers, sizeof(buffers));
+  Memory::NotifyWrite(dst_addr, sizeof(buffers));
 }
 
 void AXUCode::SetMainLR(u32 src_addr)
@@ -531,6 +534,7 @@ void AXUCode::OutputSamples(u32 lr_addr, u32 surround_addr)
   for (u32 i = 0; i < 5 * 32; ++i)
     surround_buffer[i] = Common::swap32(m_samples_surround[i]);
   memcpy(HLEMemory_Get_Pointer(surround_addr), surround_buffer, sizeof(surround_buffer));
+  Memory::NotifyWrite(surround_addr, sizeof(surround_buffer));
 
   // 32 samples per ms, 5 ms, 2 channels
   short buffer[5 * 32 * 2];
@@ -546,6 +550,7 @@ void AXUCode::OutputSamples(u32 lr_addr, u32 surround_addr)
   }
 
   memcpy(HLEMemory_Get_Pointer(lr_addr), buffer, sizeof(buffer));
+  Memory::NotifyWrite(lr_addr, sizeof(buffer));
 }
 
 void AXUCode::MixAUXBLR(u32 ul_addr, u32 dl_addr)
@@ -556,6 +561,7 @@ void AXUCode::MixAUXBLR(u32 ul_addr, u32 dl_addr)
     *ptr++ = Common::swap32(sample);
   for (auto& sample : m_samples_auxB_right)
     *ptr++ = Common::swap32(sample);
+  Memory::NotifyWrite(ul_addr, sizeof(int) * 2 * 5 * 32);
 
   // Mix AUXB L/R to MAIN L/R, and replace AUXB L/R
   ptr = (int*)HLEMemory_Get_Pointer(dl_addr);
@@ -596,11 +602,13 @@ void AXUCode::SendAUXAndMix(u32 main_auxa_up, u32 auxb_s_up, u32 main_l_dl, u32
   for (auto& up_buffer : up_buffers)
     for (u32 j = 0; j < 32 * 5; ++j)
       *ptr++ = Common::swap32(up_buffer[j]);
+  Memory::NotifyWrite(main_auxa_up, sizeof(int) * 3 * 5 * 32);
 
   // Upload AUXB S
   ptr = (int*)HLEMemory_Get_Pointer(auxb_s_up);
   for (auto& sample : m_samples_auxB_surround)
     *ptr++ = Common::swap32(sample);
+  Memory::NotifyWrite(auxb_s_up, sizeof(int) * 5 * 32);
 
   // Download buffers and addresses
   int* dl_buffers[] = {m_samples_left, m_samples_right, m_samples_auxB_left, m_samples_auxB_right};
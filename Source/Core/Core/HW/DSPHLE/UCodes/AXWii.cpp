@@ -16,6 +16,7 @@
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
 #include "Core/HW/DSPHLE/UCodes/AXVoice.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
+#include "Core/HW/Memmap.h"
 
 namespace DSP
 {
@@ -518,6 +519,7 @@ void AXWiiUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr, u16 vo
     for (auto& buffer : buffers)
       for (u32 j = 0; j < 3 * 32; ++j)
         *ptr++ = Common::swap32(buffer[j]);
+    Memory::NotifyWrite(write_addr, sizeof(int) * 3 * 3 * 32);
   }
 
   // Then read the buffers from the CPU and add to our main buffers.
@@ -545,10 +547,12 @@ void AXWiiUCode::UploadAUXMixLRSC(int aux_id, u32* addresses, u16 volume)
     *upload_ptr++ = Common::swap32(aux_right[i]);
   for (u32 i = 0; i < 96; ++i)
     *upload_ptr++ = Common::swap32(aux_surround[i]);
+  Memory::NotifyWrite(addresses[0], sizeof(int) * 3 * 96);
 
   upload_ptr = (int*)HLEMemory_Get_Pointer(addresses[1]);
   for (u32 i = 0; i < 96; ++i)
     *upload_ptr++ = Common::swap32(auxc_buffer[i]);
+  Memory::NotifyWrite(addresses[1], sizeof(int) * 96);
 
   u16 volume_ramp[96];
   GenerateVolumeRamp(volume_ramp, m_last_aux_volumes[aux_id], volume, 96);
@@ -581,6 +585,7 @@ void AXWiiUCode::OutputSamples(u32 lr_addr, u32 surround_addr, u16 volume, bool
   for (u32 i = 0; i < 3 * 32; ++i)
     upload_buffer[i] = Common::swap32(m_samples_surround[i]);
   memcpy(HLEMemory_Get_Pointer(surround_addr), upload_buffer, sizeof(upload_buffer));
+  Memory::NotifyWrite(surround_addr, sizeof(upload_buffer));
 
   if (upload_auxc)
   {
@@ -588,6 +593,7 @@ void AXWiiUCode::OutputSamples(u32 lr_addr, u32 surround_addr, u16 volume, bool
     for (u32 i = 0; i < 3 * 32; ++i)
       upload_buffer[i] = Common::swap32(m_samples_auxC_left[i]);
     memcpy(HLEMemory_Get_Pointer(surround_addr), upload_buffer, sizeof(upload_buffer));
+    Memory::NotifyWrite(surround_addr, sizeof(upload_buffer));
   }
 
   short buffer[3 * 32 * 2];
@@ -613,6 +619,7 @@ void AXWiiUCode::OutputSamples(u32 lr_addr, u32 surround_addr, u16 volume, bool
   }
 
   memcpy(HLEMemory_Get_Pointer(lr_addr), buffer, sizeof(buffer));
+  Memory::NotifyWrite(lr_addr, sizeof(buffer));
   m_mail_handler.PushMail(DSP_SYNC, true);
 }
 
@@ -629,6 +636,7 @@ void AXWiiUCode::OutputWMSamples(u32* addresses)
       int sample = MathUtil::Clamp(in[j], -32767, 32767);
       out[j] = Common::swap16((u16)sample);
     }
+    Memory::NotifyWrite(addresses[i], sizeof(u16) * 3 * 6);
   }
 }
 
@@ -52,6 +52,8 @@ void HLEMemory_Write_U8(u32 address, u8 value)
     Memory::m_pEXRAM[address & Memory::EXRAM_MASK] = value;
   else
     Memory::m_pRAM[address & Memory::RAM_MASK] = value;
+
+  Memory::NotifyWrite(address, sizeof(u8));
 }
 
 u16 HLEMemory_Read_U16LE(u32 address)
@@ -77,6 +79,8 @@ void HLEMemory_Write_U16LE(u32 address, u16 value)
     std::memcpy(&Memory::m_pEXRAM[address & Memory::EXRAM_MASK], &value, sizeof(u16));
   else
     std::memcpy(&Memory::m_pRAM[address & Memory::RAM_MASK], &value, sizeof(u16));
+
+  Memory::NotifyWrite(address, sizeof(u16));
 }
 
 void HLEMemory_Write_U16(u32 address, u16 value)
@@ -107,6 +111,8 @@ void HLEMemory_Write_U32LE(u32 address, u32 value)
     std::memcpy(&Memory::m_pEXRAM[address & Memory::EXRAM_MASK], &value, sizeof(u32));
   else
     std::memcpy(&Memory::m_pRAM[address & Memory::RAM_MASK], &value, sizeof(u32));
+
+  Memory::NotifyWrite(address, sizeof(u32));
 }
 
 void HLEMemory_Write_U32(u32 address, u32 value)
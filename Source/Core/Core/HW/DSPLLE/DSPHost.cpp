@@ -16,6 +16,7 @@
 #include "Core/DSP/Jit/DSPEmitter.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPLLE/DSPSymbols.h"
+#include "Core/HW/Memmap.h"
 #include "Core/Host.h"
 #include "VideoCommon/OnScreenDisplay.h"
 
@@ -38,6 +39,11 @@ void WriteHostMemory(u8 value, u32 addr)
   DSP::WriteARAM(value, addr);
 }
 
+void MainMemoryWritten(u32 addr, u32 size)
+{
+  Memory::NotifyWrite(addr, size);
+}
+
 void OSD_AddMessage(const std::string& str, u32 ms)
 {
   OSD::AddMessage(str, ms);
@@ -22,6 +22,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -371,6 +372,8 @@ static void DVDThread()
     ReadRequest request;
     while (s_request_queue.Pop(request))
     {
+      TRACE_ZONE("DVDThread::Read");
+
       FileMonitor::Log(request.dvd_offset, request.partition);
 
       std::vector<u8> buffer(request.length);
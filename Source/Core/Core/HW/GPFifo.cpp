@@ -77,6 +77,7 @@ static void UpdateGatherPipe()
   {
     // copy the GatherPipe
     memcpy(cur_mem, s_gather_pipe + processed, GATHER_PIPE_SIZE);
+    Memory::NotifyWrite(ProcessorInterface::Fifo_CPUWritePointer, GATHER_PIPE_SIZE);
     pipe_count -= GATHER_PIPE_SIZE;
 
     // increase the CPUWritePointer
@@ -10,6 +10,7 @@
 #include "Core/HW/Memmap.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 
@@ -18,6 +19,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
 #include "Common/Swap.h"
+#include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
@@ -59,6 +61,13 @@ u8* m_pFakeVMEM;
 // MMIO mapping object.
 std::unique_ptr<MMIO::Mapping> mmio_mapping;
 
+// Write tracking state. One stamp per page of MEM1 followed by MEM2.
+bool write_tracking_enabled = false;
+static constexpr u32 WRITE_TRACKING_PAGE_COUNT =
+    (RAM_SIZE + EXRAM_SIZE) >> WRITE_TRACKING_PAGE_SHIFT;
+static std::unique_ptr<std::atomic<u32>[]> s_page_write_epochs;
+static std::atomic<u32> s_write_epoch{1};
+
 static std::unique_ptr<MMIO::Mapping> InitMMIO()
 {
   auto mmio = std::make_unique<MMIO::Mapping>();
@@ -216,6 +225,13 @@ void Init()
   else
     mmio_mapping = InitMMIO();
 
+  write_tracking_enabled = Config::Get(Config::GFX_HACK_TRACK_TEXTURE_WRITES);
+  if (write_tracking_enabled)
+  {
+    s_page_write_epochs = std::make_unique<std::atomic<u32>[]>(WRITE_TRACKING_PAGE_COUNT);
+    s_write_epoch.store(1);
+  }
+
   Clear();
 
   INFO_LOG(MEMMAP, "Memory system initialized. RAM at %p", m_pRAM);
@@ -275,6 +291,12 @@ void DoState(PointerWrap& p)
   if (wii)
     p.DoArray(m_pEXRAM, EXRAM_SIZE);
   p.DoMarker("Memory EXRAM");
+
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    NotifyWrite(0, RAM_SIZE);
+    NotifyWrite(0x10000000, EXRAM_SIZE);
+  }
 }
 
 void Shutdown()
@@ -297,6 +319,8 @@ void Shutdown()
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  write_tracking_enabled = false;
+  s_page_write_epochs.reset();
   g_arena.ReleaseSHMSegment();
   physical_base = nullptr;
   logical_base = nullptr;
@@ -314,6 +338,9 @@ void Clear()
     memset(m_pFakeVMEM, 0, FAKEVMEM_SIZE);
   if (m_pEXRAM)
     memset(m_pEXRAM, 0, EXRAM_SIZE);
+
+  NotifyWrite(0, RAM_SIZE);
+  NotifyWrite(0x10000000, EXRAM_SIZE);
 }
 
 static inline u8* GetPointerForRange(u32 address, size_t size)
@@ -356,6 +383,7 @@ void CopyToEmu(u32 address, const void* data, size_t size)
     return;
   }
   memcpy(pointer, data, size);
+  NotifyWrite(address, size);
 }
 
 void Memset(u32 address, u8 value, size_t size)
@@ -370,6 +398,7 @@ void Memset(u32 address, u8 value, size_t size)
     return;
   }
   memset(pointer, value, size);
+  NotifyWrite(address, size);
 }
 
 std::string GetString(u32 em_address, size_t size)
@@ -431,34 +460,92 @@ u64 Read_U64(u32 address)
 void Write_U8(u8 value, u32 address)
 {
   *GetPointer(address) = value;
+  NotifyWrite(address, sizeof(u8));
 }
 
 void Write_U16(u16 value, u32 address)
 {
   u16 swapped_value = Common::swap16(value);
   std::memcpy(GetPointer(address), &swapped_value, sizeof(u16));
+  NotifyWrite(address, sizeof(u16));
 }
 
 void Write_U32(u32 value, u32 address)
 {
   u32 swapped_value = Common::swap32(value);
   std::memcpy(GetPointer(address), &swapped_value, sizeof(u32));
+  NotifyWrite(address, sizeof(u32));
 }
 
 void Write_U64(u64 value, u32 address)
 {
   u64 swapped_value = Common::swap64(value);
   std::memcpy(GetPointer(address), &swapped_value, sizeof(u64));
+  NotifyWrite(address, sizeof(u64));
 }
 
 void Write_U32_Swap(u32 value, u32 address)
 {
   std::memcpy(GetPointer(address), &value, sizeof(u32));
+  NotifyWrite(address, sizeof(u32));
 }
 
 void Write_U64_Swap(u64 value, u32 address)
 {
   std::memcpy(GetPointer(address), &value, sizeof(u64));
+  NotifyWrite(address, sizeof(u64));
+}
+
+static std::atomic<u32>* GetPageWriteEpoch(u32 address)
+{
+  address &= 0x3FFFFFFF;
+  if ((address & 0xF8000000) == 0)
+    return &s_page_write_epochs[(address & RAM_MASK) >> WRITE_TRACKING_PAGE_SHIFT];
+  if ((address >> 28) == 0x1 && (address & 0x0FFFFFFF) < EXRAM_SIZE)
+    return &s_page_write_epochs[(RAM_SIZE + (address & EXRAM_MASK)) >> WRITE_TRACKING_PAGE_SHIFT];
+  return nullptr;
+}
+
+void MarkRangeWritten(u32 address, size_t size)
+{
+  if (size == 0)
+    return;
+
+  const u32 epoch = s_write_epoch.load(std::memory_order_relaxed);
+  const u32 last_address = address + static_cast<u32>(size - 1);
+  for (u32 page = address >> WRITE_TRACKING_PAGE_SHIFT;
+       page <= last_address >> WRITE_TRACKING_PAGE_SHIFT; ++page)
+  {
+    std::atomic<u32>* stamp = GetPageWriteEpoch(page << WRITE_TRACKING_PAGE_SHIFT);
+    if (stamp)
+      stamp->store(epoch, std::memory_order_release);
+  }
+}
+
+u32 GetWriteEpoch()
+{
+  return s_write_epoch.load(std::memory_order_acquire);
+}
+
+void AdvanceWriteEpoch()
+{
+  s_write_epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool WasRangeWrittenSince(u32 address, size_t size, u32 epoch)
+{
+  if (!write_tracking_enabled || size == 0)
+    return true;
+
+  const u32 last_address = address + static_cast<u32>(size - 1);
+  for (u32 page = address >> WRITE_TRACKING_PAGE_SHIFT;
+       page <= last_address >> WRITE_TRACKING_PAGE_SHIFT; ++page)
+  {
+    const std::atomic<u32>* stamp = GetPageWriteEpoch(page << WRITE_TRACKING_PAGE_SHIFT);
+    if (!stamp || stamp->load(std::memory_order_acquire) >= epoch)
+      return true;
+  }
+  return false;
 }
 
 }  // namespace
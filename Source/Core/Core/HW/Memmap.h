@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -86,6 +87,36 @@ void Write_U64(u64 var, u32 address);
 void Write_U32_Swap(u32 var, u32 address);
 void Write_U64_Swap(u64 var, u32 address);
 
+// Write tracking
+//
+// When enabled (Graphics.Hacks.TrackTextureWrites, read at Init), stores to MEM1/MEM2 that go
+// through the MMU and through the device helpers above stamp the pages they touch with the
+// current write epoch. Consumers such as the texture cache remember the epoch at which they last
+// read a range, and can then skip re-reading it as long as no page in it has a newer stamp.
+// Device code that writes through GetPointer() directly must call NotifyWrite() itself, except
+// for IOS devices, whose request buffers are all marked when the request is replied to. JIT
+// fastmem stores bypass the MMU entirely, so fastmem is disabled while tracking is enabled.
+constexpr u32 WRITE_TRACKING_PAGE_SHIFT = 12;
+constexpr u32 WRITE_TRACKING_PAGE_SIZE = 1 << WRITE_TRACKING_PAGE_SHIFT;
+
+extern bool write_tracking_enabled;
+
+inline bool IsWriteTrackingEnabled()
+{
+  return write_tracking_enabled;
+}
+void MarkRangeWritten(u32 address, size_t size);
+inline void NotifyWrite(u32 address, size_t size)
+{
+  if (write_tracking_enabled)
+    MarkRangeWritten(address, size);
+}
+// Pages written during the current epoch compare equal to it, so a range which was read during
+// epoch N is unmodified as long as WasRangeWrittenSince(address, size, N) returns false.
+u32 GetWriteEpoch();
+void AdvanceWriteEpoch();
+bool WasRangeWrittenSince(u32 address, size_t size, u32 epoch);
+
 // Templated functions for byteswapped copies.
 template <typename T>
 void CopyFromEmuSwapped(T* data, u32 address, size_t size)
@@ -109,5 +140,7 @@ void CopyToEmuSwapped(u32 address, const T* data, size_t size)
 
   for (size_t i = 0; i < size / sizeof(T); i++)
     dest[i] = Common::FromBigEndian(data[i]);
+
+  NotifyWrite(address, size);
 }
 }
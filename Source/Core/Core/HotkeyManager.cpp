@@ -29,6 +29,7 @@ const std::string hotkey_labels[] = {
     _trans("Reset"),
     _trans("Toggle Fullscreen"),
     _trans("Take Screenshot"),
+    _trans("Toggle Trace Recording"),
     _trans("Exit"),
 
     _trans("Volume Down"),
@@ -27,6 +27,7 @@ enum Hotkey
   HK_RESET,
   HK_FULLSCREEN,
   HK_SCREENSHOT,
+  HK_TOGGLE_TRACE,
   HK_EXIT,
 
   HK_VOLUME_DOWN,
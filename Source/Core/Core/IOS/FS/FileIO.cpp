@@ -223,6 +223,7 @@ IPCCommandResult FileIO::Read(const ReadWriteRequest& request)
   m_file->Seek(m_SeekPos, SEEK_SET);  // File might be opened twice, need to seek before we read
   const u32 number_of_bytes_read = static_cast<u32>(
       fread(Memory::GetPointer(request.buffer), 1, requested_read_length, m_file->GetHandle()));
+  Memory::NotifyWrite(request.buffer, number_of_bytes_read);
 
   if (number_of_bytes_read != requested_read_length && ferror(m_file->GetHandle()))
     return GetDefaultReply(FS_EACCESS);
@@ -491,9 +491,46 @@ void Kernel::EnqueueIPCRequest(u32 address)
 }
 
 // Called to send a reply to an IOS syscall
+// Device handlers fill their output buffers through Memory::GetPointer(), which write tracking
+// can't see, so every buffer the request could have written is marked when it is replied to.
+static void NotifyRequestBuffersWritten(const Request& request)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  switch (request.command)
+  {
+  case IPC_CMD_READ:
+  {
+    const ReadWriteRequest read_request{request.address};
+    Memory::NotifyWrite(read_request.buffer, read_request.size);
+    break;
+  }
+  case IPC_CMD_IOCTL:
+  {
+    const IOCtlRequest ioctl_request{request.address};
+    Memory::NotifyWrite(ioctl_request.buffer_in, ioctl_request.buffer_in_size);
+    Memory::NotifyWrite(ioctl_request.buffer_out, ioctl_request.buffer_out_size);
+    break;
+  }
+  case IPC_CMD_IOCTLV:
+  {
+    const IOCtlVRequest ioctlv_request{request.address};
+    for (const auto& vector : ioctlv_request.in_vectors)
+      Memory::NotifyWrite(vector.address, vector.size);
+    for (const auto& vector : ioctlv_request.io_vectors)
+      Memory::NotifyWrite(vector.address, vector.size);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
 void Kernel::EnqueueIPCReply(const Request& request, const s32 return_value, int cycles_in_future,
                              CoreTiming::FromThread from)
 {
+  NotifyRequestBuffersWritten(request);
   Memory::Write_U32(static_cast<u32>(return_value), request.address + 4);
   // IOS writes back the command that was responded to in the FD field.
   Memory::Write_U32(request.command, request.address + 8);
@@ -175,7 +175,13 @@ void MemChecks::Add(const TMemCheck& memory_check)
   {
     bool had_any = HasAny();
     bool lock = Core::PauseAndLock(true);
-    m_mem_checks.push_back(memory_check);
+    auto position = std::upper_bound(m_mem_checks.begin(), m_mem_checks.end(),
+                                     memory_check.start_address,
+                                     [](u32 address, const TMemCheck& mc) {
+                                       return address < mc.start_address;
+                                     });
+    m_mem_checks.insert(position, memory_check);
+    UpdateMaxEndAddresses();
     // If this is the first one, clear the JIT cache so it can switch to
     // watchpoint-compatible code.
     if (!had_any && g_jit)
@@ -193,6 +199,7 @@ void MemChecks::Remove(u32 address)
     {
       bool lock = Core::PauseAndLock(true);
       m_mem_checks.erase(i);
+      UpdateMaxEndAddresses();
       if (!HasAny() && g_jit)
         g_jit->ClearCache();
       PowerPC::DBATUpdated();
@@ -202,14 +209,31 @@ void MemChecks::Remove(u32 address)
   }
 }
 
+void MemChecks::UpdateMaxEndAddresses()
+{
+  m_max_end_addresses.resize(m_mem_checks.size());
+  u32 max_end_address = 0;
+  for (size_t i = 0; i < m_mem_checks.size(); ++i)
+  {
+    max_end_address = std::max(max_end_address, m_mem_checks[i].end_address);
+    m_max_end_addresses[i] = max_end_address;
+  }
+}
+
 TMemCheck* MemChecks::GetMemCheck(u32 address, size_t size)
 {
-  for (TMemCheck& mc : m_mem_checks)
+  const u32 last_address = address + static_cast<u32>(size) - 1;
+
+  // Only the memory checks starting at or before the last byte can overlap the access.
+  auto first_after = std::upper_bound(
+      m_mem_checks.begin(), m_mem_checks.end(), last_address,
+      [](u32 value, const TMemCheck& mc) { return value < mc.start_address; });
+  for (size_t i = first_after - m_mem_checks.begin(); i > 0; --i)
   {
-    if (mc.end_address >= address && address + size - 1 >= mc.start_address)
-    {
-      return &mc;
-    }
+    if (m_max_end_addresses[i - 1] < address)
+      break;
+    if (m_mem_checks[i - 1].end_address >= address)
+      return &m_mem_checks[i - 1];
   }
 
   // none found
@@ -218,21 +242,7 @@ TMemCheck* MemChecks::GetMemCheck(u32 address, size_t size)
 
 bool MemChecks::OverlapsMemcheck(u32 address, u32 length)
 {
-  if (!HasAny())
-    return false;
-  u32 page_end_suffix = length - 1;
-  u32 page_end_address = address | page_end_suffix;
-  for (TMemCheck memcheck : m_mem_checks)
-  {
-    if (((memcheck.start_address | page_end_suffix) == page_end_address ||
-         (memcheck.end_address | page_end_suffix) == page_end_address) ||
-        ((memcheck.start_address | page_end_suffix) < page_end_address &&
-         (memcheck.end_address | page_end_suffix) > page_end_address))
-    {
-      return true;
-    }
-  }
-  return false;
+  return GetMemCheck(address & ~(length - 1), length) != nullptr;
 }
 
 bool TMemCheck::Action(DebugInterface* debug_interface, u32 value, u32 addr, bool write,
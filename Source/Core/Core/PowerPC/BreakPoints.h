@@ -74,9 +74,15 @@ private:
 };
 
 // Memory breakpoints
+//
+// Only the accesses which can hit a memory check have to go through the slow memory path: pages
+// overlapping one aren't mapped in the fastmem arena, so fastmem accesses to them fault and get
+// backpatched, and the other pages stay fast. Lookups are done with a binary search, so the
+// number of memory checks doesn't slow down the accesses which don't hit any of them.
 class MemChecks
 {
 public:
+  // Sorted by start address.
   using TMemChecks = std::vector<TMemCheck>;
   using TMemChecksStr = std::vector<std::string>;
 
@@ -88,13 +94,24 @@ public:
 
   // memory breakpoint
   TMemCheck* GetMemCheck(u32 address, size_t size = 1);
+  // Whether any memory check overlaps the length aligned page containing address. length has to
+  // be a power of two.
   bool OverlapsMemcheck(u32 address, u32 length);
   void Remove(u32 address);
 
-  void Clear() { m_mem_checks.clear(); }
+  void Clear()
+  {
+    m_mem_checks.clear();
+    m_max_end_addresses.clear();
+  }
   bool HasAny() const { return !m_mem_checks.empty(); }
 private:
+  void UpdateMaxEndAddresses();
+
   TMemChecks m_mem_checks;
+  // The highest end address among the memory checks up to and including each index, which lets
+  // GetMemCheck stop looking once no earlier memory check can reach the address.
+  std::vector<u32> m_max_end_addresses;
 };
 
 class Watches
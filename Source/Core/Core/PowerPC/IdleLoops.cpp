@@ -0,0 +1,78 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/IdleLoops.h"
+
+#include <cinttypes>
+#include <map>
+#include <string>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+
+namespace IdleLoops
+{
+struct LoopStats
+{
+  u64 skips = 0;
+  u64 cycles = 0;
+};
+
+// Only touched by the CPU thread, and by Report once it is gone.
+static std::map<u32, LoopStats> s_loops;
+
+void AddLoop(u32 address)
+{
+  // Blocks get recompiled after cache flushes, only log the first time.
+  if (s_loops.emplace(address, LoopStats()).second)
+    INFO_LOG(POWERPC, "Idle loop detected at %08x", address);
+}
+
+void Skip(u32 address)
+{
+  const u64 idle_ticks = CoreTiming::GetIdleTicks();
+  CoreTiming::Idle();
+
+  LoopStats& stats = s_loops[address];
+  stats.skips++;
+  stats.cycles += CoreTiming::GetIdleTicks() - idle_ticks;
+}
+
+void Report()
+{
+  if (s_loops.empty())
+    return;
+
+  std::string text;
+  for (const auto& entry : s_loops)
+  {
+    const LoopStats& stats = entry.second;
+    const std::string name = g_symbolDB.GetDescription(entry.first);
+    NOTICE_LOG(POWERPC, "Idle loop at %08x (%s): skipped %" PRIu64 " times, %" PRIu64 " cycles",
+               entry.first, name.c_str(), stats.skips, stats.cycles);
+    text += StringFromFormat("%08x %" PRIu64 " %" PRIu64 " %s\n", entry.first, stats.skips,
+                             stats.cycles, name.c_str());
+  }
+  s_loops.clear();
+
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  if (game_id.empty())
+    return;
+
+  std::string path = File::GetUserPath(D_DUMP_IDX) + "IdleLoops" DIR_SEP;
+  File::CreateFullPath(path);
+  path += game_id + ".txt";
+
+  File::IOFile file(path, "w");
+  if (!file.WriteBytes(text.data(), text.size()))
+    WARN_LOG(POWERPC, "Failed to write the idle loop report to %s", path.c_str());
+}
+}
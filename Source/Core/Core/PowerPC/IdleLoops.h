@@ -0,0 +1,23 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Bookkeeping for the loops found by PPCAnalyst::OPTION_IDLE_LOOP_DETECTION. When such a loop
+// branches back to its start, the JITs call Skip instead of running it again, so the time until
+// the next event isn't spent polling. Which loops were found, and how many cycles they skipped, is
+// written to a per-game report when emulation stops.
+namespace IdleLoops
+{
+// Called when a block starting with an idle loop is compiled.
+void AddLoop(u32 address);
+
+// Called from JIT code each time the loop at address would go around again.
+void Skip(u32 address);
+
+// Logs the loops found since the last report and writes them to the dump directory.
+void Report();
+}
@@ -30,6 +30,21 @@
 namespace
 {
 u32 last_pc;
+
+// Finding the handler of an instruction walks up to two levels of opcode tables, and finding its
+// GekkoOPInfo walks them again. Both only depend on the instruction word, so they're kept in a
+// direct-mapped cache keyed by it. Instructions are still fetched through the instruction cache
+// model every time, so self-modifying code and fetch exceptions behave exactly as before.
+struct DecodedInstruction
+{
+  u32 hex;
+  Interpreter::Instruction handler;
+  GekkoOPInfo* opinfo;
+  bool uses_fpu;
+};
+
+constexpr u32 DECODE_CACHE_BITS = 14;
+std::array<DecodedInstruction, 1 << DECODE_CACHE_BITS> s_decode_cache;
 }
 
 bool Interpreter::m_end_block;
@@ -66,6 +81,7 @@ void Interpreter::RunTable63(UGeckoInstruction inst)
 void Interpreter::Init()
 {
   InitializeInstructionTables();
+  s_decode_cache.fill({});
   m_reserve = false;
   m_end_block = false;
 }
@@ -99,9 +115,43 @@ static void Trace(UGeckoInstruction& inst)
             ppc_inst.c_str());
 }
 
+static Interpreter::Instruction GetHandler(UGeckoInstruction inst)
+{
+  switch (inst.OPCD)
+  {
+  case 4:
+    return Interpreter::m_op_table4[inst.SUBOP10];
+  case 19:
+    return Interpreter::m_op_table19[inst.SUBOP10];
+  case 31:
+    return Interpreter::m_op_table31[inst.SUBOP10];
+  case 59:
+    return Interpreter::m_op_table59[inst.SUBOP5];
+  case 63:
+    return Interpreter::m_op_table63[inst.SUBOP10];
+  default:
+    return Interpreter::m_op_table[inst.OPCD];
+  }
+}
+
+// inst must not be 0, which marks empty entries.
+static const DecodedInstruction& Decode(UGeckoInstruction inst)
+{
+  DecodedInstruction& entry = s_decode_cache[(inst.hex * 0x9E3779B1) >> (32 - DECODE_CACHE_BITS)];
+  if (entry.hex != inst.hex)
+  {
+    entry.hex = inst.hex;
+    entry.handler = GetHandler(inst);
+    entry.opinfo = GetOpInfo(inst);
+    entry.uses_fpu = entry.opinfo && (entry.opinfo->flags & FL_USE_FPU) != 0;
+  }
+  return entry;
+}
+
 int Interpreter::SingleStepInner()
 {
   static UGeckoInstruction instCode;
+  GekkoOPInfo* opinfo = nullptr;
   u32 function = HLE::GetFirstFunctionIndex(PC);
   if (function != 0)
   {
@@ -153,10 +203,15 @@ int Interpreter::SingleStepInner()
 
     if (instCode.hex != 0)
     {
+      const DecodedInstruction& decoded = Decode(instCode);
+      opinfo = decoded.opinfo;
+
       UReg_MSR& msr = (UReg_MSR&)MSR;
-      if (msr.FP)  // If FPU is enabled, just execute
+      // If FPU is enabled, just execute. Otherwise check if we have to generate a FPU unavailable
+      // exception.
+      if (msr.FP || !decoded.uses_fpu)
       {
-        m_op_table[instCode.OPCD](instCode);
+        decoded.handler(instCode);
         if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
         {
           PowerPC::CheckExceptions();
@@ -165,22 +220,9 @@ int Interpreter::SingleStepInner()
       }
       else
       {
-        // check if we have to generate a FPU unavailable exception
-        if (!PPCTables::UsesFPU(instCode))
-        {
-          m_op_table[instCode.OPCD](instCode);
-          if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
-          {
-            PowerPC::CheckExceptions();
-            m_end_block = true;
-          }
-        }
-        else
-        {
-          PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
-          PowerPC::CheckExceptions();
-          m_end_block = true;
-        }
+        PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
+        PowerPC::CheckExceptions();
+        m_end_block = true;
       }
     }
     else
@@ -193,7 +235,8 @@ int Interpreter::SingleStepInner()
   last_pc = PC;
   PC = NPC;
 
-  GekkoOPInfo* opinfo = GetOpInfo(instCode);
+  if (!opinfo)
+    opinfo = GetOpInfo(instCode);
   return opinfo->numCycles;
 }
 
@@ -25,6 +25,7 @@
 #include "Core/HW/GPFifo.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/IdleLoops.h"
 #include "Core/PowerPC/Jit64/JitAsm.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
 #include "Core/PowerPC/Jit64Common/FarCodeCache.h"
@@ -388,6 +389,54 @@ void Jit64::FakeBLCall(u32 after)
   SetJumpTarget(skip_exit);
 }
 
+// Branches back to the head of the loop the block forms, with the loop's registers still in host
+// registers. Returns false without emitting anything if the register state has drifted from the
+// one at the loop head, in which case the caller exits the block as usual.
+bool Jit64::WriteLoopBackEdge()
+{
+  if (m_idle_loop && !js.carryFlagSet)
+  {
+    // Another iteration would see the same memory and do the same thing, so let time pass until
+    // the next event instead, which may be the one the loop waits for.
+    gpr.Flush(RegCache::FlushMode::MaintainState);
+    fpr.Flush(RegCache::FlushMode::MaintainState);
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionC(IdleLoops::Skip, js.blockStart);
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+    WriteExceptionExit();
+    return true;
+  }
+
+  if (!m_loop_head || js.carryFlagSet || !gpr.CanJumpToLoopHead(m_gpr_loop_state) ||
+      !fpr.CanJumpToLoopHead(m_fpr_loop_state))
+  {
+    return false;
+  }
+
+  gpr.FlushForLoopHead(m_gpr_loop_state);
+  fpr.FlushForLoopHead(m_fpr_loop_state);
+
+  // Same as in Cleanup, but without clobbering the registers we keep.
+  if (jo.optimizeGatherPipe && js.fifoBytesSinceCheck > 0)
+  {
+    BitSet32 registersInUse = CallerSavedRegistersInUse();
+    ABI_PushRegistersAndAdjustStack(registersInUse, 0);
+    ABI_CallFunction(GPFifo::FastCheckGatherPipe);
+    ABI_PopRegistersAndAdjustStack(registersInUse, 0);
+  }
+
+  SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
+  J_CC(CC_G, m_loop_head);
+
+  // Out of cycles, so leave the loop the way checkedEntry would.
+  gpr.Flush(RegCache::FlushMode::MaintainState);
+  fpr.Flush(RegCache::FlushMode::MaintainState);
+  MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+  JMP(asm_routines.doTiming, true);
+  return true;
+}
+
 void Jit64::WriteExit(u32 destination, bool bl, u32 after)
 {
   if (!m_enable_blr_optimization)
@@ -586,16 +635,37 @@ void Jit64::Jit(u32 em_address)
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+        analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOP_DETECTION);
       }
       Trace();
     }
   }
 
+  // With tiered compilation, blocks are first compiled without following branches or merging
+  // instructions, which keeps them short and quick to compile. Those which keep running are
+  // recompiled with all optimizations, and with the speculative constants and GQRs seen by then.
+  // CompileExceptionCheck ignores PC 0, so a block there couldn't be promoted.
+  m_quick_tier = SConfig::GetInstance().bJITTieredCompilation &&
+                 !SConfig::GetInstance().bEnableDebugging && !Profiler::g_ProfileBlocks &&
+                 em_address != 0 &&
+                 js.hotBlockAddresses.find(em_address) == js.hotBlockAddresses.end();
+  if (m_quick_tier)
+  {
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  }
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
   u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
 
+  if (m_quick_tier)
+    EnableOptimization();
+
   if (code_block.m_memory_exception)
   {
     // Address of instruction could not be translated
@@ -658,6 +728,24 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
     // get start tic
     PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
   }
+
+  // Count the runs of first tier blocks, and have them recompiled once they get hot.
+  if (m_quick_tier)
+  {
+    MOV(64, R(RSCRATCH), ImmPtr(&b->runCount));
+    ADD(32, MatR(RSCRATCH), Imm8(1));
+    CMP(32, MatR(RSCRATCH), Imm32(HOT_BLOCK_RUN_COUNT));
+    FixupBranch hot = J_CC(CC_AE, true);
+    SwitchToFarCode();
+    SetJumpTarget(hot);
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionC(JitInterface::CompileExceptionCheck,
+                      static_cast<u32>(JitInterface::ExceptionType::HotBlock));
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    JMP(asm_routines.dispatcherNoCheck, true);
+    SwitchToNearCode();
+  }
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -712,6 +800,39 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
     IntializeSpeculativeConstants();
   }
 
+  // For blocks which loop back to their start, load the registers the loop reads most before the
+  // loop head, and keep them in host registers across iterations. They're marked as dirty, so any
+  // exit from the loop writes them back. First tier blocks leave through their normal exit, so
+  // that each iteration is counted.
+  m_idle_loop = code_block.m_idle_loop;
+  if (m_idle_loop)
+    IdleLoops::AddLoop(em_address);
+
+  m_loop_head = nullptr;
+  m_loop_gprs = BitSet32(0);
+  m_loop_fprs = BitSet32(0);
+  if (SConfig::GetInstance().bJITKeepRegistersInLoops && !m_idle_loop &&
+      !SConfig::GetInstance().bEnableDebugging && !Profiler::g_ProfileBlocks && !m_quick_tier &&
+      !(MMCR0.Hex || MMCR1.Hex) &&
+      PPCAnalyst::IsLoop(ops, code_block.m_num_instructions, em_address))
+  {
+    for (int reg : PPCAnalyst::GetMostReadRegisters(ops, code_block.m_num_instructions, false, 6))
+    {
+      if (gpr.R(reg).IsImm())
+        continue;
+      gpr.BindToRegister(reg, true, true);
+      m_loop_gprs[reg] = true;
+    }
+    for (int reg : PPCAnalyst::GetMostReadRegisters(ops, code_block.m_num_instructions, true, 4))
+    {
+      fpr.BindToRegister(reg, true, true);
+      m_loop_fprs[reg] = true;
+    }
+    m_gpr_loop_state = gpr.GetLoopState();
+    m_fpr_loop_state = fpr.GetLoopState();
+    m_loop_head = GetCodePtr();
+  }
+
   // Translate instructions
   for (u32 i = 0; i < code_block.m_num_instructions; i++)
   {
@@ -920,10 +1041,11 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
         SwitchToNearCode();
       }
 
-      // If we have a register that will never be used again, flush it.
-      for (int j : ~ops[i].gprInUse)
+      // If we have a register that will never be used again, flush it. The loop registers are
+      // used again in the next iteration.
+      for (int j : ~ops[i].gprInUse & ~m_loop_gprs)
         gpr.StoreFromRegister(j);
-      for (int j : ~ops[i].fprInUse)
+      for (int j : ~ops[i].fprInUse & ~m_loop_fprs)
         fpr.StoreFromRegister(j);
 
       if (opinfo->flags & FL_LOADSTORE)
@@ -993,6 +1115,10 @@ void Jit64::EnableOptimization()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  if (SConfig::GetInstance().bDetectIdleLoops)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOP_DETECTION);
+  if (SConfig::GetInstance().bDetectIdleLoops || SConfig::GetInstance().bJITKeepRegistersInLoops)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_KEEP_LOOP_BACK_EDGE);
 }
 
 void Jit64::IntializeSpeculativeConstants()
@@ -74,6 +74,7 @@ public:
   void WriteExceptionExit();
   void WriteExternalExceptionExit();
   void WriteRfiExitDestInRSCRATCH();
+  bool WriteLoopBackEdge();
   bool Cleanup();
 
   void GenerateConstantOverflow(bool overflow);
@@ -248,4 +249,17 @@ private:
   bool m_enable_blr_optimization;
   bool m_cleanup_after_stackfault;
   u8* m_stack;
+
+  // Whether the block being compiled is a first tier one, see Jit64::Jit.
+  bool m_quick_tier = false;
+
+  // Whether the block being compiled starts with an idle loop, see IdleLoops.
+  bool m_idle_loop = false;
+
+  // Only set while compiling a block which branches back to its start.
+  const u8* m_loop_head = nullptr;
+  BitSet32 m_loop_gprs;
+  BitSet32 m_loop_fprs;
+  RegCache::LoopState m_gpr_loop_state;
+  RegCache::LoopState m_fpr_loop_state;
 };
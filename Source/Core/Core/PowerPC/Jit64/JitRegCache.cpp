@@ -157,6 +157,31 @@ int RegCache::SanityCheck() const
   return 0;
 }
 
+RegCache::LoopState RegCache::GetLoopState() const
+{
+  return m_regs;
+}
+
+bool RegCache::CanJumpToLoopHead(const LoopState& state) const
+{
+  for (size_t i = 0; i < m_regs.size(); i++)
+  {
+    if (state[i].location == GetDefaultLocation(i))
+      continue;
+    if (m_regs[i].away != state[i].away || !(m_regs[i].location == state[i].location))
+      return false;
+  }
+  return true;
+}
+
+void RegCache::FlushForLoopHead(const LoopState& state)
+{
+  BitSet32 regs;
+  for (size_t i = 0; i < m_regs.size(); i++)
+    regs[i] = state[i].location == GetDefaultLocation(i);
+  Flush(FlushMode::MaintainState, regs);
+}
+
 void RegCache::KillImmediate(size_t preg, bool doLoad, bool makeDirty)
 {
   if (m_regs[preg].away)
@@ -38,6 +38,9 @@ public:
 
   static constexpr size_t NUM_XREGS = 16;
 
+  // The register state at the head of a loop within a block, see Jit64::WriteLoopBackEdge.
+  using LoopState = std::array<PPCCachedReg, 32>;
+
   explicit RegCache(Jit64& jit);
   virtual ~RegCache() = default;
 
@@ -59,6 +62,12 @@ public:
   void FlushLockX(Gen::X64Reg reg1, Gen::X64Reg reg2);
 
   int SanityCheck() const;
+
+  LoopState GetLoopState() const;
+  // Whether every register which is bound or constant at the loop head still is, in the same way.
+  bool CanJumpToLoopHead(const LoopState& state) const;
+  // Writes back the registers which are in memory at the loop head, keeping the cached state.
+  void FlushForLoopHead(const LoopState& state);
   void KillImmediate(size_t preg, bool doLoad, bool makeDirty);
 
   // TODO - instead of doload, use "read", "write"
@@ -183,14 +183,19 @@ void Jit64::lXXx(UGeckoInstruction inst)
   }
   else
   {
-    if ((inst.OPCD != 31) && gpr.R(a).IsImm() && !jo.memcheck)
+    // With memory checks enabled, a constant address is only safe to use as long as no check can
+    // hit it, since a hit has to leave rA untouched for the instruction to run again.
+    if ((inst.OPCD != 31) && gpr.R(a).IsImm() &&
+        (!jo.memcheck || PowerPC::IsOptimizableRAMAddress(gpr.R(a).Imm32() + inst.SIMM_16)))
     {
       u32 val = gpr.R(a).Imm32() + inst.SIMM_16;
       opAddress = Imm32(val);
       if (update)
         gpr.SetImmediate32(a, val);
     }
-    else if ((inst.OPCD == 31) && gpr.R(a).IsImm() && gpr.R(b).IsImm() && !jo.memcheck)
+    else if ((inst.OPCD == 31) && gpr.R(a).IsImm() && gpr.R(b).IsImm() &&
+             (!jo.memcheck ||
+              PowerPC::IsOptimizableRAMAddress(gpr.R(a).Imm32() + gpr.R(b).Imm32())))
     {
       u32 val = gpr.R(a).Imm32() + gpr.R(b).Imm32();
       opAddress = Imm32(val);
@@ -206,8 +211,9 @@ void Jit64::lXXx(UGeckoInstruction inst)
       if (use_constant_offset)
         offset = inst.OPCD == 31 ? gpr.R(b).SImm32() : (s32)inst.SIMM_16;
       // Depending on whether we have an immediate and/or update, find the optimum way to calculate
-      // the load address.
-      if ((update || use_constant_offset) && !jo.memcheck)
+      // the load address. Updating rA before the load isn't allowed with memory checks, as it
+      // couldn't be undone if one hits.
+      if ((update && !jo.memcheck) || (!update && use_constant_offset))
       {
         gpr.BindToRegister(a, true, update);
         opAddress = gpr.R(a);
@@ -342,7 +348,9 @@ void Jit64::dcbz(UGeckoInstruction inst)
     ADD(32, R(RSCRATCH), gpr.R(a));
   AND(32, R(RSCRATCH), Imm32(~31));
 
-  if (UReg_MSR(MSR).DR)
+  // The fast path writes to memory directly, which write tracking wouldn't see.
+  const bool use_fast_path = UReg_MSR(MSR).DR && !Memory::IsWriteTrackingEnabled();
+  if (use_fast_path)
   {
     // Perform lookup to see if we can use fast path.
     MOV(64, R(RSCRATCH2), ImmPtr(&PowerPC::dbat_table[0]));
@@ -367,7 +375,7 @@ void Jit64::dcbz(UGeckoInstruction inst)
   ABI_CallFunctionR(PowerPC::ClearCacheLine, RSCRATCH);
   ABI_PopRegistersAndAdjustStack(registersInUse, 0);
 
-  if (UReg_MSR(MSR).DR)
+  if (use_fast_path)
   {
     FixupBranch end = J(true);
     SwitchToNearCode();
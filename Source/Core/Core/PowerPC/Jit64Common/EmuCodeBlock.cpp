@@ -542,7 +542,8 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 
   FixupBranch exit;
   bool dr_set = (flags & SAFE_LOADSTORE_DR_ON) || UReg_MSR(MSR).DR;
-  bool fast_check_address = !slowmem && dr_set;
+  // Unchecked stores would bypass write tracking, so always take the slow path while it's enabled.
+  bool fast_check_address = !slowmem && dr_set && !Memory::IsWriteTrackingEnabled();
   if (fast_check_address)
   {
     FixupBranch slow = CheckIfSafeAddress(reg_value, reg_addr, registersInUse);
@@ -21,6 +21,7 @@
 #include "Core/HW/Memmap.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/IdleLoops.h"
 #include "Core/PowerPC/JitArm64/JitArm64_RegCache.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/Profiler.h"
@@ -62,9 +63,7 @@ void JitArm64::Init()
   code_block.m_stats = &js.st;
   code_block.m_gpa = &js.gpa;
   code_block.m_fpa = &js.fpa;
-  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
-  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
-  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  EnableOptimization();
 
   m_enable_blr_optimization = jo.enableBlocklink && SConfig::GetInstance().bFastmem &&
                               !SConfig::GetInstance().bEnableDebugging;
@@ -136,6 +135,17 @@ void JitArm64::ClearCache()
   GenerateAsm();
 }
 
+void JitArm64::EnableOptimization()
+{
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  if (SConfig::GetInstance().bDetectIdleLoops)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOP_DETECTION);
+  if (SConfig::GetInstance().bDetectIdleLoops || SConfig::GetInstance().bJITKeepRegistersInLoops)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_KEEP_LOOP_BACK_EDGE);
+}
+
 void JitArm64::Shutdown()
 {
   FreeCodeSpace();
@@ -188,25 +198,31 @@ void JitArm64::FallBackToInterpreter(UGeckoInstruction inst)
     }
   }
 
-  if (jo.memcheck && (js.op->opinfo->flags & FL_LOADSTORE))
-  {
-    ARM64Reg WA = gpr.GetReg();
-    LDR(INDEX_UNSIGNED, WA, PPC_REG, PPCSTATE_OFF(Exceptions));
-    FixupBranch noException = TBZ(WA, IntLog2(EXCEPTION_DSI));
+  if (js.op->opinfo->flags & FL_LOADSTORE)
+    MemoryExceptionCheck();
+}
 
-    FixupBranch handleException = B();
-    SwitchToFarCode();
-    SetJumpTarget(handleException);
+void JitArm64::MemoryExceptionCheck()
+{
+  if (!jo.memcheck)
+    return;
 
-    gpr.Flush(FLUSH_MAINTAIN_STATE);
-    fpr.Flush(FLUSH_MAINTAIN_STATE);
+  ARM64Reg WA = gpr.GetReg();
+  LDR(INDEX_UNSIGNED, WA, PPC_REG, PPCSTATE_OFF(Exceptions));
+  FixupBranch noException = TBZ(WA, IntLog2(EXCEPTION_DSI));
 
-    WriteExceptionExit(js.compilerPC);
+  FixupBranch handleException = B();
+  SwitchToFarCode();
+  SetJumpTarget(handleException);
 
-    SwitchToNearCode();
-    SetJumpTarget(noException);
-    gpr.Unlock(WA);
-  }
+  gpr.Flush(FLUSH_MAINTAIN_STATE);
+  fpr.Flush(FLUSH_MAINTAIN_STATE);
+
+  WriteExceptionExit(js.compilerPC);
+
+  SwitchToNearCode();
+  SetJumpTarget(noException);
+  gpr.Unlock(WA);
 }
 
 void JitArm64::HLEFunction(UGeckoInstruction inst)
@@ -475,6 +491,62 @@ void JitArm64::WriteExceptionExit(u32 destination, bool only_external)
   B(dispatcher);
 }
 
+bool JitArm64::CanCompileWithMemcheck(bool update, bool clobbers_address) const
+{
+  return !jo.memcheck || (!SConfig::GetInstance().bMMU && !update && !clobbers_address);
+}
+
+// Replaces the branch back to the start of an idle loop. The registers have to be flushed.
+void JitArm64::WriteIdleLoopExit()
+{
+  MOVI2R(W0, js.blockStart);
+  MOVP2R(X30, &IdleLoops::Skip);
+  BLR(X30);
+
+  WriteExceptionExit(js.blockStart);
+}
+
+// Branches back to the head of the loop the block forms, with the loop's registers still in host
+// registers. Returns false without emitting anything if the register state has drifted from the
+// one at the loop head, in which case the caller exits the block as usual.
+bool JitArm64::WriteLoopBackEdge()
+{
+  if (!m_loop_head || js.carryFlagSet || !gpr.CanJumpToLoopHead(m_gpr_loop_state) ||
+      !fpr.CanJumpToLoopHead(m_fpr_loop_state))
+  {
+    return false;
+  }
+
+  gpr.FlushForLoopHead(m_gpr_loop_state);
+  fpr.FlushForLoopHead(m_fpr_loop_state);
+
+  // Same as in Cleanup, but without clobbering the registers we keep.
+  if (jo.optimizeGatherPipe && js.fifoBytesSinceCheck > 0)
+  {
+    BitSet32 regs_in_use = gpr.GetCallerSavedUsed();
+    BitSet32 fprs_in_use = fpr.GetCallerSavedUsed();
+    ABI_PushRegisters(regs_in_use);
+    m_float_emit.ABI_PushRegisters(fprs_in_use, X30);
+    MOVP2R(X30, &GPFifo::FastCheckGatherPipe);
+    BLR(X30);
+    m_float_emit.ABI_PopRegisters(fprs_in_use, X30);
+    ABI_PopRegisters(regs_in_use);
+  }
+
+  // The loop head may be out of reach of a conditional branch from the far code.
+  DoDownCount();
+  FixupBranch out_of_cycles = B(CC_MI);
+  B(m_loop_head);
+  SetJumpTarget(out_of_cycles);
+
+  // Out of cycles, so leave the loop the way checkedEntry would.
+  gpr.Flush(FLUSH_MAINTAIN_STATE);
+  fpr.Flush(FLUSH_MAINTAIN_STATE);
+  MOVI2R(DISPATCHER_PC, js.blockStart);
+  B(doTiming);
+  return true;
+}
+
 void JitArm64::WriteExceptionExit(ARM64Reg dest, bool only_external)
 {
   Cleanup();
@@ -614,11 +686,29 @@ void JitArm64::Jit(u32)
     blockSize = 1;
   }
 
+  // With tiered compilation, blocks are first compiled without following branches or merging
+  // instructions, which keeps them short and quick to compile. Those which keep running are
+  // recompiled with all optimizations. CompileExceptionCheck ignores PC 0, so a block there
+  // couldn't be promoted.
+  m_quick_tier = SConfig::GetInstance().bJITTieredCompilation &&
+                 !SConfig::GetInstance().bEnableDebugging && !Profiler::g_ProfileBlocks &&
+                 em_address != 0 &&
+                 js.hotBlockAddresses.find(em_address) == js.hotBlockAddresses.end();
+  if (m_quick_tier)
+  {
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  }
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
   u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
 
+  if (m_quick_tier)
+    EnableOptimization();
+
   if (code_block.m_memory_exception)
   {
     // Address of instruction could not be translated
@@ -686,6 +776,31 @@ void JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock*
     BeginTimeProfile(b);
   }
 
+  // Count the runs of first tier blocks, and have them recompiled once they get hot.
+  if (m_quick_tier)
+  {
+    ARM64Reg WA = gpr.GetReg();
+    ARM64Reg WB = gpr.GetReg();
+    MOVP2R(EncodeRegTo64(WA), &b->runCount);
+    LDR(INDEX_UNSIGNED, WB, EncodeRegTo64(WA), 0);
+    ADD(WB, WB, 1);
+    STR(INDEX_UNSIGNED, WB, EncodeRegTo64(WA), 0);
+    CMP(WB, HOT_BLOCK_RUN_COUNT);
+    FixupBranch cold = B(CC_LO);
+    FixupBranch hot = B();
+    SwitchToFarCode();
+    SetJumpTarget(hot);
+    MOVI2R(DISPATCHER_PC, js.blockStart);
+    STR(INDEX_UNSIGNED, DISPATCHER_PC, PPC_REG, PPCSTATE_OFF(pc));
+    MOVI2R(W0, static_cast<u32>(JitInterface::ExceptionType::HotBlock));
+    MOVP2R(X1, &JitInterface::CompileExceptionCheck);
+    BLR(X1);
+    B(dispatcher);
+    SwitchToNearCode();
+    SetJumpTarget(cold);
+    gpr.Unlock(WA, WB);
+  }
+
   if (code_block.m_gqr_used.Count() == 1 &&
       js.pairedQuantizeAddresses.find(js.blockStart) == js.pairedQuantizeAddresses.end())
   {
@@ -713,6 +828,47 @@ void JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock*
   gpr.Start(js.gpa);
   fpr.Start(js.fpa);
 
+  m_idle_loop = code_block.m_idle_loop;
+  if (m_idle_loop)
+    IdleLoops::AddLoop(em_address);
+
+  // For blocks which loop back to their start, load the registers the loop reads most before the
+  // loop head, and keep them in host registers across iterations. They're marked as dirty, so any
+  // exit from the loop writes them back. FPRs used by paired instructions are loaded as pairs, as
+  // the back edge is only taken if every loop register still has the type it has at the head.
+  m_loop_head = nullptr;
+  m_loop_gprs = BitSet32(0);
+  m_loop_fprs = BitSet32(0);
+  if (SConfig::GetInstance().bJITKeepRegistersInLoops && !m_idle_loop &&
+      !SConfig::GetInstance().bEnableDebugging && !Profiler::g_ProfileBlocks && !m_quick_tier &&
+      PPCAnalyst::IsLoop(ops, code_block.m_num_instructions, em_address))
+  {
+    BitSet32 paired_fprs;
+    for (u32 i = 0; i < code_block.m_num_instructions; i++)
+    {
+      const int type = ops[i].opinfo->type;
+      if (type != OPTYPE_PS && type != OPTYPE_LOADPS && type != OPTYPE_STOREPS)
+        continue;
+      paired_fprs |= ops[i].fregsIn;
+      if (ops[i].fregOut >= 0)
+        paired_fprs[ops[i].fregOut] = true;
+    }
+
+    for (int reg : PPCAnalyst::GetMostReadRegisters(ops, code_block.m_num_instructions, false, 6))
+    {
+      gpr.BindToRegister(reg, true);
+      m_loop_gprs[reg] = true;
+    }
+    for (int reg : PPCAnalyst::GetMostReadRegisters(ops, code_block.m_num_instructions, true, 4))
+    {
+      fpr.BindToRegister(reg, paired_fprs[reg] ? REG_REG : REG_LOWER_PAIR);
+      m_loop_fprs[reg] = true;
+    }
+    m_gpr_loop_state = gpr.GetLoopState();
+    m_fpr_loop_state = fpr.GetLoopState();
+    m_loop_head = GetCodePtr();
+  }
+
   // Translate instructions
   for (u32 i = 0; i < code_block.m_num_instructions; i++)
   {
@@ -838,9 +994,10 @@ void JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock*
       if (!CanMergeNextInstructions(1) || js.op[1].opinfo->type != OPTYPE_INTEGER)
         FlushCarry();
 
-      // If we have a register that will never be used again, flush it.
-      gpr.StoreRegisters(~ops[i].gprInUse);
-      fpr.StoreRegisters(~ops[i].fprInUse);
+      // If we have a register that will never be used again, flush it. The loop registers are
+      // used again in the next iteration.
+      gpr.StoreRegisters(~ops[i].gprInUse & ~m_loop_gprs);
+      fpr.StoreRegisters(~ops[i].fprInUse & ~m_loop_fprs);
     }
 
     i += js.skipInstructions;
@@ -34,6 +34,7 @@ public:
   bool HandleFastmemFault(uintptr_t access_address, SContext* ctx);
 
   void ClearCache() override;
+  void EnableOptimization();
 
   CommonAsmRoutinesBase* GetAsmRoutines() override { return this; }
   void Run() override;
@@ -224,6 +225,17 @@ private:
   void WriteExit(Arm64Gen::ARM64Reg dest, bool LK = false, u32 exit_address_after_return = 0);
   void WriteExceptionExit(u32 destination, bool only_external = false);
   void WriteExceptionExit(Arm64Gen::ARM64Reg dest, bool only_external = false);
+  void WriteIdleLoopExit();
+  bool WriteLoopBackEdge();
+
+  // Whether a load or store can be compiled while jo.memcheck is set. A memory check hit raises
+  // its exception after the access, MemoryExceptionCheck leaves the block at the instruction, and
+  // it runs again once emulation resumes, which is only correct if it didn't change the registers
+  // its address comes from. MMU exceptions aren't handled this way, so everything falls back to
+  // the interpreter with the MMU enabled.
+  bool CanCompileWithMemcheck(bool update, bool clobbers_address) const;
+  // With jo.memcheck set, has to follow every load and store which can raise a DSI.
+  void MemoryExceptionCheck();
   void FakeLKExit(u32 exit_address_after_return);
   void WriteBLRExit(Arm64Gen::ARM64Reg dest);
 
@@ -258,6 +270,19 @@ private:
 
   bool m_enable_blr_optimization;
   bool m_cleanup_after_stackfault = false;
+
+  // Whether the block being compiled is a first tier one, see JitArm64::Jit.
+  bool m_quick_tier = false;
+
+  // Whether the block being compiled starts with an idle loop, see IdleLoops.
+  bool m_idle_loop = false;
+
+  // Only set while compiling a block which branches back to its start.
+  const u8* m_loop_head = nullptr;
+  BitSet32 m_loop_gprs;
+  BitSet32 m_loop_fprs;
+  Arm64RegCache::LoopState m_gpr_loop_state;
+  Arm64RegCache::LoopState m_fpr_loop_state;
   u8* m_stack_base = nullptr;
   u8* m_stack_pointer = nullptr;
   u8* m_saved_stack_pointer = nullptr;
@@ -105,6 +105,12 @@ void JitArm64::bx(UGeckoInstruction inst)
     return;
   }
 
+  if (destination == js.blockStart && destination != js.compilerPC && !inst.LK &&
+      WriteLoopBackEdge())
+  {
+    return;
+  }
+
   gpr.Flush(FlushMode::FLUSH_ALL);
   fpr.Flush(FlushMode::FLUSH_ALL);
 
@@ -122,6 +128,12 @@ void JitArm64::bx(UGeckoInstruction inst)
     return;
   }
 
+  if (m_idle_loop && destination == js.blockStart && !inst.LK)
+  {
+    WriteIdleLoopExit();
+    return;
+  }
+
   WriteExit(destination, inst.LK, js.compilerPC + 4);
 }
 
@@ -171,10 +183,16 @@ void JitArm64::bcx(UGeckoInstruction inst)
   else
     destination = js.compilerPC + SignExt16(inst.BD << 2);
 
-  gpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
-  fpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
+  if (destination != js.blockStart || inst.LK || !WriteLoopBackEdge())
+  {
+    gpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
+    fpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
 
-  WriteExit(destination, inst.LK, js.compilerPC + 4);
+    if (m_idle_loop && destination == js.blockStart && !inst.LK)
+      WriteIdleLoopExit();
+    else
+      WriteExit(destination, inst.LK, js.compilerPC + 4);
+  }
 
   SwitchToNearCode();
 
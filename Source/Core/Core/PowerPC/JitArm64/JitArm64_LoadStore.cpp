@@ -289,7 +289,6 @@ void JitArm64::lXX(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITLoadStoreOff);
-  FALLBACK_IF(jo.memcheck);
 
   u32 a = inst.RA, b = inst.RB, d = inst.RD;
   s32 offset = inst.SIMM_16;
@@ -353,7 +352,11 @@ void JitArm64::lXX(UGeckoInstruction inst)
     break;
   }
 
+  FALLBACK_IF(!CanCompileWithMemcheck(
+      update, (a && d == a) || (offsetReg != -1 && d == static_cast<u32>(offsetReg))));
+
   SafeLoadToReg(d, update ? a : (a ? a : -1), offsetReg, flags, offset, update);
+  MemoryExceptionCheck();
 
   // LWZ idle skipping
   if (inst.OPCD == 32 && CanMergeNextInstructions(2) &&
@@ -391,7 +394,6 @@ void JitArm64::stX(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITLoadStoreOff);
-  FALLBACK_IF(jo.memcheck);
 
   u32 a = inst.RA, b = inst.RB, s = inst.RS;
   s32 offset = inst.SIMM_16;
@@ -440,7 +442,10 @@ void JitArm64::stX(UGeckoInstruction inst)
     break;
   }
 
+  FALLBACK_IF(!CanCompileWithMemcheck(update, false));
+
   SafeStoreFromReg(update ? a : (a ? a : -1), s, regOffset, flags, offset);
+  MemoryExceptionCheck();
 
   if (update)
   {
@@ -640,7 +645,8 @@ void JitArm64::dcbz(UGeckoInstruction inst)
   JITDISABLE(bJITLoadStoreOff);
   if (SConfig::GetInstance().bDCBZOFF)
     return;
-  FALLBACK_IF(jo.memcheck);
+  // The slow path doesn't check for memory checks, just like the interpreter's.
+  FALLBACK_IF(!CanCompileWithMemcheck(false, false));
   FALLBACK_IF(SConfig::GetInstance().bLowDCBZHack);
 
   int a = inst.RA, b = inst.RB;
@@ -696,8 +702,8 @@ void JitArm64::dcbz(UGeckoInstruction inst)
   BitSet32 fprs_to_push = fpr.GetCallerSavedUsed();
   gprs_to_push[W0] = 0;
 
-  EmitBackpatchRoutine(BackPatchInfo::FLAG_ZERO_256, true, true, W0, EncodeRegTo64(addr_reg),
-                       gprs_to_push, fprs_to_push);
+  EmitBackpatchRoutine(BackPatchInfo::FLAG_ZERO_256, jo.fastmem, jo.fastmem, W0,
+                       EncodeRegTo64(addr_reg), gprs_to_push, fprs_to_push);
 
   gpr.Unlock(W0);
 }
@@ -22,7 +22,6 @@ void JitArm64::lfXX(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITLoadStoreFloatingOff);
-  FALLBACK_IF(jo.memcheck);
 
   u32 a = inst.RA, b = inst.RB;
 
@@ -72,6 +71,8 @@ void JitArm64::lfXX(UGeckoInstruction inst)
     break;
   }
 
+  FALLBACK_IF(!CanCompileWithMemcheck(update, false));
+
   u32 imm_addr = 0;
   bool is_immediate = false;
 
@@ -178,13 +179,13 @@ void JitArm64::lfXX(UGeckoInstruction inst)
 
   gpr.Unlock(W0, W30);
   fpr.Unlock(Q0);
+  MemoryExceptionCheck();
 }
 
 void JitArm64::stfXX(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITLoadStoreFloatingOff);
-  FALLBACK_IF(jo.memcheck);
 
   u32 a = inst.RA, b = inst.RB;
 
@@ -238,6 +239,8 @@ void JitArm64::stfXX(UGeckoInstruction inst)
     break;
   }
 
+  FALLBACK_IF(!CanCompileWithMemcheck(update, false));
+
   u32 imm_addr = 0;
   bool is_immediate = false;
 
@@ -400,4 +403,5 @@ void JitArm64::stfXX(UGeckoInstruction inst)
   }
   gpr.Unlock(W0, W1, W30);
   fpr.Unlock(Q0);
+  MemoryExceptionCheck();
 }
@@ -91,6 +91,31 @@ void Arm64RegCache::FlushMostStaleRegister()
   FlushRegister(most_stale_preg, false);
 }
 
+bool Arm64RegCache::CanJumpToLoopHead(const LoopState& state) const
+{
+  for (size_t i = 0; i < m_guest_registers.size(); ++i)
+  {
+    const OpArg& head = state[i];
+    const OpArg& reg = m_guest_registers[i];
+    if (head.GetType() == REG_NOTLOADED)
+      continue;
+    if (reg.GetType() != head.GetType())
+      return false;
+    if (head.GetType() == REG_IMM ? reg.GetImm() != head.GetImm() : reg.GetReg() != head.GetReg())
+      return false;
+  }
+  return true;
+}
+
+void Arm64RegCache::FlushForLoopHead(const LoopState& state)
+{
+  for (size_t i = 0; i < m_guest_registers.size(); ++i)
+  {
+    if (state[i].GetType() == REG_NOTLOADED)
+      FlushRegister(i, true);
+  }
+}
+
 // GPR Cache
 constexpr size_t GUEST_GPR_COUNT = 32;
 constexpr size_t GUEST_CR_COUNT = 8;
@@ -547,6 +572,12 @@ ARM64Reg Arm64FPRCache::RW(size_t preg, RegType type)
   return reg.GetReg();
 }
 
+void Arm64FPRCache::BindToRegister(size_t preg, RegType type)
+{
+  R(preg, type);
+  m_guest_registers[preg].SetDirty(true);
+}
+
 void Arm64FPRCache::GetAllocationOrder()
 {
   static constexpr std::array<ARM64Reg, 32> allocation_order{{
@@ -131,6 +131,9 @@ private:
 class Arm64RegCache
 {
 public:
+  // The register state at the head of a loop within a block, see JitArm64::WriteLoopBackEdge.
+  using LoopState = std::vector<OpArg>;
+
   explicit Arm64RegCache(size_t guest_reg_count)
       : m_emit(nullptr), m_float_emit(nullptr), m_guest_registers(guest_reg_count),
         m_reg_stats(nullptr){};
@@ -144,6 +147,12 @@ public:
 
   virtual BitSet32 GetCallerSavedUsed() = 0;
 
+  LoopState GetLoopState() const { return m_guest_registers; }
+  // Whether every register which is loaded at the loop head still is, in the same way.
+  bool CanJumpToLoopHead(const LoopState& state) const;
+  // Writes back the registers which aren't loaded at the loop head, keeping the cached state.
+  void FlushForLoopHead(const LoopState& state);
+
   // Returns a temporary register for use
   // Requires unlocking after done
   ARM64Reg GetReg();
@@ -292,6 +301,9 @@ public:
 
   ARM64Reg RW(size_t preg, RegType type = REG_LOWER_PAIR);
 
+  // Loads a guest register and marks it as dirty, so that it's written back on every exit
+  void BindToRegister(size_t preg, RegType type);
+
   BitSet32 GetCallerSavedUsed() override;
 
   bool IsSingle(size_t preg, bool lower_only = false);
@@ -99,8 +99,13 @@ protected:
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    // Blocks which ran often enough to be recompiled with all optimizations.
+    std::unordered_set<u32> hotBlockAddresses;
   };
 
+  // Number of runs after which a first tier block is recompiled with all optimizations.
+  static constexpr u32 HOT_BLOCK_RUN_COUNT = 256;
+
   PPCAnalyst::CodeBlock code_block;
   PPCAnalyst::PPCAnalyzer analyzer;
 
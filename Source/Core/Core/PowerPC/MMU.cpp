@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <string>
@@ -163,6 +164,149 @@ static void EFB_Write(u32 data, u32 addr)
 BatTable ibat_table;
 BatTable dbat_table;
 
+// Host pointers to the guest pages used by recent loads and stores with data translation enabled,
+// which let accesses to memory skip translation. Pages only get an entry while they are mapped by
+// a DBAT or held in the data TLB, and lose it when either changes, so a hit never disagrees with
+// what a full translation would give.
+// Loads and stores have separate caches. A page's first store has to go through the TLB, which
+// sets the changed bit of its page table entry.
+constexpr u32 HOST_PAGE_CACHE_SIZE = 256;
+
+struct HostPageCacheEntry
+{
+  // Page aligned guest virtual address, so INVALID_TAG never matches.
+  static constexpr u32 INVALID_TAG = 1;
+
+  u32 tag = INVALID_TAG;
+  u8* host_page;
+  u32 physical_page;
+  // Whether stores have to be reported to write tracking.
+  bool track_writes;
+};
+
+using HostPageCache = std::array<HostPageCacheEntry, HOST_PAGE_CACHE_SIZE>;
+
+static HostPageCache s_read_page_cache;
+static HostPageCache s_write_page_cache;
+static HostPageCacheStats s_host_page_cache_stats;
+
+static HostPageCacheEntry& GetHostPageCacheEntry(HostPageCache& cache, u32 address)
+{
+  return cache[(address >> HW_PAGE_INDEX_SHIFT) % HOST_PAGE_CACHE_SIZE];
+}
+
+static bool FitsInPage(u32 address, size_t size)
+{
+  return (address & (HW_PAGE_SIZE - 1)) <= HW_PAGE_SIZE - size;
+}
+
+static void AddToHostPageCache(HostPageCache& cache, u32 address, u32 physical_address)
+{
+  const u32 physical_page = physical_address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  u8* host_page;
+  bool track_writes = false;
+
+  // Same mapping as the memory cases of ReadFromHardware and WriteToHardware.
+  if ((physical_page & 0xF8000000) == 0x00000000)
+  {
+    host_page = &Memory::m_pRAM[physical_page & Memory::RAM_MASK];
+    track_writes = true;
+  }
+  else if (Memory::m_pEXRAM && (physical_page >> 28) == 0x1 &&
+           (physical_page & 0x0FFFFFFF) < Memory::EXRAM_SIZE)
+  {
+    host_page = &Memory::m_pEXRAM[physical_page & 0x0FFFFFFF];
+    track_writes = true;
+  }
+  else if ((physical_page >> 28) == 0xE && physical_page < 0xE0000000 + Memory::L1_CACHE_SIZE)
+  {
+    host_page = &Memory::m_pL1Cache[physical_page & 0x0FFFFFFF];
+  }
+  else if (Memory::m_pFakeVMEM && (physical_page & 0xFE000000) == 0x7E000000)
+  {
+    host_page = &Memory::m_pFakeVMEM[physical_page & Memory::RAM_MASK];
+  }
+  else
+  {
+    return;
+  }
+
+  HostPageCacheEntry& entry = GetHostPageCacheEntry(cache, address);
+  entry.tag = address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  entry.host_page = host_page;
+  entry.physical_page = physical_page;
+  entry.track_writes = track_writes;
+}
+
+static void InvalidateHostPageCacheEntry(u32 address)
+{
+  const u32 tag = address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  for (HostPageCache* cache : {&s_read_page_cache, &s_write_page_cache})
+  {
+    HostPageCacheEntry& entry = GetHostPageCacheEntry(*cache, address);
+    if (entry.tag == tag)
+      entry.tag = HostPageCacheEntry::INVALID_TAG;
+  }
+}
+
+static void InvalidateHostPageCache()
+{
+  for (HostPageCache* cache : {&s_read_page_cache, &s_write_page_cache})
+  {
+    for (HostPageCacheEntry& entry : *cache)
+      entry.tag = HostPageCacheEntry::INVALID_TAG;
+  }
+}
+
+template <typename T>
+static bool ReadFromHostPageCache(u32 address, T* value)
+{
+  if (!FitsInPage(address, sizeof(T)))
+    return false;
+
+  const HostPageCacheEntry& entry = GetHostPageCacheEntry(s_read_page_cache, address);
+  if (entry.tag != (address & ~static_cast<u32>(HW_PAGE_SIZE - 1)))
+  {
+    s_host_page_cache_stats.misses++;
+    return false;
+  }
+
+  s_host_page_cache_stats.hits++;
+  std::memcpy(value, &entry.host_page[address & (HW_PAGE_SIZE - 1)], sizeof(T));
+  return true;
+}
+
+template <typename T>
+static bool WriteToHostPageCache(u32 address, T swapped_data)
+{
+  if (!FitsInPage(address, sizeof(T)))
+    return false;
+
+  const HostPageCacheEntry& entry = GetHostPageCacheEntry(s_write_page_cache, address);
+  if (entry.tag != (address & ~static_cast<u32>(HW_PAGE_SIZE - 1)))
+  {
+    s_host_page_cache_stats.misses++;
+    return false;
+  }
+
+  s_host_page_cache_stats.hits++;
+  const u32 offset = address & (HW_PAGE_SIZE - 1);
+  std::memcpy(&entry.host_page[offset], &swapped_data, sizeof(T));
+  if (entry.track_writes)
+    Memory::NotifyWrite(entry.physical_page | offset, sizeof(T));
+  return true;
+}
+
+HostPageCacheStats GetHostPageCacheStats()
+{
+  return s_host_page_cache_stats;
+}
+
+void ResetHostPageCacheStats()
+{
+  s_host_page_cache_stats = {};
+}
+
 static void GenerateDSIException(u32 _EffectiveAddress, bool _bWrite);
 
 template <XCheckTLBFlag flag, typename T, bool never_translate = false>
@@ -170,6 +314,10 @@ static T ReadFromHardware(u32 em_address)
 {
   if (!never_translate && UReg_MSR(MSR).DR)
   {
+    T cached_value;
+    if (flag == FLAG_READ && ReadFromHostPageCache(em_address, &cached_value))
+      return bswap(cached_value);
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -177,6 +325,8 @@ static T ReadFromHardware(u32 em_address)
         GenerateDSIException(em_address, false);
       return 0;
     }
+    if (flag == FLAG_READ)
+      AddToHostPageCache(s_read_page_cache, em_address, translated_addr.address);
     if ((em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
     {
       // This could be unaligned down to the byte level... hopefully this is rare, so doing it this
@@ -258,6 +408,9 @@ static void WriteToHardware(u32 em_address, const T data)
 {
   if (!never_translate && UReg_MSR(MSR).DR)
   {
+    if (flag == FLAG_WRITE && WriteToHostPageCache(em_address, bswap(data)))
+      return;
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -265,6 +418,8 @@ static void WriteToHardware(u32 em_address, const T data)
         GenerateDSIException(em_address, true);
       return;
     }
+    if (flag == FLAG_WRITE)
+      AddToHostPageCache(s_write_page_cache, em_address, translated_addr.address);
     if ((em_address & (sizeof(T) - 1)) &&
         (em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
     {
@@ -302,6 +457,7 @@ static void WriteToHardware(u32 em_address, const T data)
     // TODO: Only the first REALRAM_SIZE is supposed to be backed by actual memory.
     const T swapped_data = bswap(data);
     std::memcpy(&Memory::m_pRAM[em_address & Memory::RAM_MASK], &swapped_data, sizeof(T));
+    Memory::NotifyWrite(em_address, sizeof(T));
     return;
   }
 
@@ -310,6 +466,7 @@ static void WriteToHardware(u32 em_address, const T data)
   {
     const T swapped_data = bswap(data);
     std::memcpy(&Memory::m_pEXRAM[em_address & 0x0FFFFFFF], &swapped_data, sizeof(T));
+    Memory::NotifyWrite(em_address, sizeof(T));
     return;
   }
 
@@ -619,7 +776,8 @@ std::string HostGetString(u32 address, size_t size)
 
 bool IsOptimizableRAMAddress(const u32 address)
 {
-  if (PowerPC::memchecks.HasAny())
+  // Unchecked accesses bypass WriteToHardware, and with it write tracking.
+  if (Memory::IsWriteTrackingEnabled())
     return false;
 
   if (!UReg_MSR(MSR).DR)
@@ -628,7 +786,7 @@ bool IsOptimizableRAMAddress(const u32 address)
   // TODO: This API needs to take an access size
   //
   // We store whether an access can be optimized to an unchecked access
-  // in dbat_table.
+  // in dbat_table. This also excludes the pages overlapping memchecks.
   u32 bat_result = dbat_table[address >> BAT_INDEX_SHIFT];
   return (bat_result & BAT_PHYSICAL_BIT) != 0;
 }
@@ -702,6 +860,7 @@ void DMA_LCToMemory(const u32 memAddr, const u32 cacheAddr, const u32 numBlocks)
     return;
 
   memcpy(dst, src, 32 * numBlocks);
+  Memory::NotifyWrite(memAddr, 32 * numBlocks);
 }
 
 void DMA_MemoryToLC(const u32 cacheAddr, const u32 memAddr, const u32 numBlocks)
@@ -769,7 +928,7 @@ void ClearCacheLine(u32 address)
 
 u32 IsOptimizableMMIOAccess(u32 address, u32 accessSize)
 {
-  if (PowerPC::memchecks.HasAny())
+  if (PowerPC::memchecks.GetMemCheck(address, accessSize >> 3))
     return 0;
 
   if (!UReg_MSR(MSR).DR)
@@ -791,7 +950,7 @@ u32 IsOptimizableMMIOAccess(u32 address, u32 accessSize)
 
 bool IsOptimizableGatherPipeWrite(u32 address)
 {
-  if (PowerPC::memchecks.HasAny())
+  if (PowerPC::memchecks.GetMemCheck(address, 8))
     return false;
 
   if (!UReg_MSR(MSR).DR)
@@ -958,6 +1117,7 @@ void SDRUpdated()
   }
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+  InvalidateHostPageCache();
 }
 
 enum TLBLookupResult
@@ -1027,6 +1187,8 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, const u32 addre
   const int tag = address >> HW_PAGE_INDEX_SHIFT;
   TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
   const int index = tlbe.recent == 0 && tlbe.tag[0] != TLBEntry::INVALID_TAG;
+  if (tlbe.tag[index] != TLBEntry::INVALID_TAG)
+    InvalidateHostPageCacheEntry(tlbe.tag[index] << HW_PAGE_INDEX_SHIFT);
   tlbe.recent = index;
   tlbe.paddr[index] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = PTE2.Hex;
@@ -1038,6 +1200,11 @@ void InvalidateTLBEntry(u32 address)
   const u32 entry_index = (address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK;
 
   TLBEntry& tlbe = ppcState.tlb[0][entry_index];
+  for (u32 tag : tlbe.tag)
+  {
+    if (tag != TLBEntry::INVALID_TAG)
+      InvalidateHostPageCacheEntry(tag << HW_PAGE_INDEX_SHIFT);
+  }
   tlbe.tag[0] = TLBEntry::INVALID_TAG;
   tlbe.tag[1] = TLBEntry::INVALID_TAG;
 
@@ -1198,7 +1365,9 @@ static void UpdateBATs(BatTable& bat_table, u32 base_spr)
                  physical_address < 0xE0000000 + Memory::L1_CACHE_SIZE)
           valid_bit |= BAT_PHYSICAL_BIT;
 
-        // Fastmem doesn't support memchecks, so disable it for all overlapping virtual pages.
+        // Fastmem doesn't support memchecks, so disable it for all overlapping virtual pages. They
+        // aren't mapped in the fastmem arena, so only accesses to them fault and take the slow
+        // path.
         if (PowerPC::memchecks.OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
           valid_bit &= ~BAT_PHYSICAL_BIT;
 
@@ -1228,6 +1397,7 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
 
 void DBATUpdated()
 {
+  InvalidateHostPageCache();
   dbat_table = {};
   UpdateBATs(dbat_table, SPR_DBAT0U);
   bool extended_bats = SConfig::GetInstance().bWii && HID4.SBE;
@@ -5,7 +5,10 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <vector>
@@ -13,8 +16,11 @@
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/ParallelFor.h"
 #include "Common/StringUtil.h"
+#include "Common/Swap.h"
 #include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PPCTables.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -77,13 +83,92 @@ static u32 EvaluateBranchTarget(UGeckoInstruction instr, u32 pc)
   }
 }
 
+namespace
+{
+// Reads code the way the CPU would, through the address translation and the instruction cache.
+class GuestCodeReader
+{
+public:
+  bool Read(u32 address, u32* hex) const
+  {
+    if (!PowerPC::HostIsInstructionRAMAddress(address))
+      return false;
+    const PowerPC::TryReadInstResult read_result = PowerPC::TryReadInstruction(address);
+    *hex = read_result.hex;
+    return read_result.valid;
+  }
+
+  u32 ComputeCodeChecksum(u32 start, u32 end) const
+  {
+    return HashSignatureDB::ComputeCodeChecksum(start, end);
+  }
+};
+
+// Reads code straight from RAM, with the pages of an address range translated up front. It
+// doesn't touch the TLB or the instruction cache, so it can be used from other threads while the
+// CPU thread waits.
+class CodeSnapshotReader
+{
+public:
+  CodeSnapshotReader(u32 start, u32 end)
+      : m_start(start & ~PAGE_MASK),
+        m_pages(end > start ? (end - m_start + PAGE_MASK) / (PAGE_MASK + 1) : 0)
+  {
+    for (size_t i = 0; i < m_pages.size(); i++)
+    {
+      const u32 address = m_start + static_cast<u32>(i) * (PAGE_MASK + 1);
+      if (!PowerPC::HostIsInstructionRAMAddress(address))
+        continue;
+
+      const PowerPC::TranslateResult translated = PowerPC::JitCache_TranslateAddress(address);
+      if (!translated.valid)
+        continue;
+
+      if (Memory::m_pFakeVMEM && (translated.address & 0xFE000000) == 0x7E000000)
+        m_pages[i] = &Memory::m_pFakeVMEM[translated.address & Memory::FAKEVMEM_MASK];
+      else
+        m_pages[i] = Memory::GetPointer(translated.address);
+    }
+  }
+
+  bool Read(u32 address, u32* hex) const
+  {
+    const u32 page = (address - m_start) / (PAGE_MASK + 1);
+    if ((address & 3) || address < m_start || page >= m_pages.size() || !m_pages[page])
+      return false;
+
+    *hex = Common::swap32(m_pages[page] + (address & PAGE_MASK));
+    return true;
+  }
+
+  u32 ComputeCodeChecksum(u32 start, u32 end) const
+  {
+    u32 sum = 0;
+    u32 hex = 0;
+    for (u32 address = start; address <= end; address += 4)
+    {
+      Read(address, &hex);
+      sum = HashSignatureDB::UpdateCodeChecksum(sum, hex);
+    }
+    return sum;
+  }
+
+private:
+  static constexpr u32 PAGE_MASK = 0xFFF;
+
+  u32 m_start;
+  std::vector<const u8*> m_pages;
+};
+}  // Anonymous namespace
+
 // To find the size of each found function, scan
 // forward until we hit blr or rfi. In the meantime, collect information
 // about which functions this function calls.
 // Also collect which internal branch goes the farthest.
 // If any one goes farther than the blr or rfi, assume that there is more than
 // one blr or rfi, and keep scanning.
-bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size)
+template <typename Reader>
+static bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size, const Reader& reader)
 {
   if (!func.name.size())
     func.name = StringFromFormat("zz_%07x_", startAddr & 0x0FFFFFFF);
@@ -100,7 +185,8 @@ bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size)
   for (u32 addr = startAddr; true; addr += 4)
   {
     func.size += 4;
-    if (func.size >= CODEBUFFER_SIZE * 4 || !PowerPC::HostIsInstructionRAMAddress(addr))  // weird
+    u32 hex;
+    if (func.size >= CODEBUFFER_SIZE * 4 || !reader.Read(addr, &hex))  // weird
       return false;
 
     if (max_size && func.size > max_size)
@@ -108,14 +194,13 @@ bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size)
       func.address = startAddr;
       func.analyzed = true;
       func.size -= 4;
-      func.hash = HashSignatureDB::ComputeCodeChecksum(startAddr, addr - 4);
+      func.hash = reader.ComputeCodeChecksum(startAddr, addr - 4);
       if (numInternalBranches == 0)
         func.flags |= FFLAG_STRAIGHT;
       return true;
     }
-    const PowerPC::TryReadInstResult read_result = PowerPC::TryReadInstruction(addr);
-    const UGeckoInstruction instr = read_result.hex;
-    if (read_result.valid && PPCTables::IsValidInstruction(instr))
+    const UGeckoInstruction instr = hex;
+    if (PPCTables::IsValidInstruction(instr))
     {
       // BLR or RFI
       // 4e800021 is blrl, not the end of a function
@@ -130,7 +215,7 @@ bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size)
         // Let's calc the checksum and get outta here
         func.address = startAddr;
         func.analyzed = true;
-        func.hash = HashSignatureDB::ComputeCodeChecksum(startAddr, addr);
+        func.hash = reader.ComputeCodeChecksum(startAddr, addr);
         if (numInternalBranches == 0)
           func.flags |= FFLAG_STRAIGHT;
         return true;
@@ -192,6 +277,11 @@ bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size)
   }
 }
 
+bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size)
+{
+  return AnalyzeFunction(startAddr, func, max_size, GuestCodeReader());
+}
+
 bool ReanalyzeFunction(u32 start_addr, Symbol& func, int max_size)
 {
   _assert_msg_(OSHLE, func.analyzed, "The function wasn't previously analyzed!");
@@ -280,35 +370,64 @@ static bool CanSwapAdjacentOps(const CodeOp& a, const CodeOp& b)
 // called by another function. Therefore, let's scan the
 // entire space for bl operations and find what functions
 // get called.
+// Both the scan and the analysis of the functions found are split across threads. Functions which
+// can't be analyzed from the snapshot of the range, like those extending past it, are retried the
+// regular way.
 static void FindFunctionsFromBranches(u32 startAddr, u32 endAddr, SymbolDB* func_db)
 {
-  for (u32 addr = startAddr; addr < endAddr; addr += 4)
-  {
-    const PowerPC::TryReadInstResult read_result = PowerPC::TryReadInstruction(addr);
-    const UGeckoInstruction instr = read_result.hex;
-
-    if (read_result.valid && PPCTables::IsValidInstruction(instr))
+  const CodeSnapshotReader reader(startAddr, endAddr);
+  const size_t count = endAddr > startAddr ? (endAddr - startAddr) / 4 : 0;
+
+  std::mutex targets_mutex;
+  std::vector<u32> targets;
+  Common::ParallelFor(count, 0x10000, [&](size_t begin, size_t end) {
+    std::vector<u32> found;
+    for (size_t i = begin; i < end; i++)
     {
-      switch (instr.OPCD)
-      {
-      case 18:  // branch instruction
+      const u32 addr = startAddr + static_cast<u32>(i) * 4;
+      u32 hex;
+      if (!reader.Read(addr, &hex))
+        continue;
+
+      const UGeckoInstruction instr = hex;
+      if (instr.OPCD == 18 && instr.LK && PPCTables::IsValidInstruction(instr))  // bl
       {
-        if (instr.LK)  // bl
-        {
-          u32 target = SignExt26(instr.LI << 2);
-          if (!instr.AA)
-            target += addr;
-          if (PowerPC::HostIsRAMAddress(target))
-          {
-            func_db->AddFunction(target);
-          }
-        }
-      }
-      break;
-      default:
-        break;
+        u32 target = SignExt26(instr.LI << 2);
+        if (!instr.AA)
+          target += addr;
+        found.push_back(target);
       }
     }
+
+    std::lock_guard<std::mutex> lk(targets_mutex);
+    targets.insert(targets.end(), found.begin(), found.end());
+  });
+
+  std::sort(targets.begin(), targets.end());
+  targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+  targets.erase(std::remove_if(targets.begin(), targets.end(),
+                               [func_db](u32 target) {
+                                 return !PowerPC::HostIsRAMAddress(target) ||
+                                        func_db->Symbols().count(target) != 0;
+                               }),
+                targets.end());
+
+  std::vector<Symbol> functions(targets.size());
+  std::vector<u8> analyzed(targets.size());
+  Common::ParallelFor(targets.size(), 256, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      analyzed[i] = AnalyzeFunction(targets[i], functions[i], 0, reader);
+  });
+
+  for (size_t i = 0; i < targets.size(); i++)
+  {
+    if (analyzed[i])
+    {
+      functions[i].type = Symbol::Type::Function;
+      func_db->AddCompleteSymbol(functions[i]);
+    }
+    else
+      func_db->AddFunction(targets[i]);
   }
 }
 
@@ -384,6 +503,8 @@ static void FindFunctionsAfterReturnInstruction(PPCSymbolDB* func_db)
 
 void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB* func_db)
 {
+  const auto start_time = std::chrono::steady_clock::now();
+
   // Step 1: Find all functions
   FindFunctionsFromBranches(startAddr, endAddr, func_db);
   FindFunctionsFromHandlers(func_db);
@@ -453,6 +574,11 @@ void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB* func_db)
                   "%i timer, %i rfi. %i are branchless leafs.",
            numLeafs, numNice, numUnNice, numTimer, numRFI, numStraightLeaf);
   INFO_LOG(OSHLE, "Average size: %i (leaf), %i (nice), %i(unnice)", leafSize, niceSize, unniceSize);
+
+  const auto duration = std::chrono::steady_clock::now() - start_time;
+  NOTICE_LOG(OSHLE, "Found %u functions in %u ms", static_cast<u32>(func_db->Symbols().size()),
+             static_cast<u32>(
+                 std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
 }
 
 static bool isCmp(const CodeOp& a)
@@ -682,6 +808,88 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   }
 }
 
+// Checks the conditions of OPTION_IDLE_LOOP_DETECTION. A register which is read before being
+// written within the loop, and written later on, carries state over to the next iteration.
+static bool IsIdleLoop(const CodeOp* code, u32 count, u32 start)
+{
+  u32 end = 0;
+  for (u32 i = 0; i < count; i++)
+  {
+    const UGeckoInstruction inst = code[i].inst;
+    if (code[i].skip || inst.LK)
+      continue;
+    if (inst.OPCD == 18 && SignExt26(inst.LI << 2) + (inst.AA ? 0 : code[i].address) == start)
+      end = i + 1;
+    else if (inst.OPCD == 16 && SignExt16(inst.BD << 2) + (inst.AA ? 0 : code[i].address) == start)
+      end = i + 1;
+  }
+  if (end == 0)
+    return false;
+
+  BitSet32 gprs_read_first, gprs_written;
+  BitSet8 crs_read_first, crs_written;
+  bool ca_read_first = false;
+  bool ca_written = false;
+  for (u32 i = 0; i < end; i++)
+  {
+    const UGeckoInstruction inst = code[i].inst;
+    const int flags = code[i].opinfo->flags;
+    switch (code[i].opinfo->type)
+    {
+    case OPTYPE_INTEGER:
+    case OPTYPE_LOAD:
+      break;
+    case OPTYPE_SYSTEM:
+      // sync and eieio
+      if (inst.OPCD != 31 || (inst.SUBOP10 != 598 && inst.SUBOP10 != 854))
+        return false;
+      break;
+    case OPTYPE_ICACHE:
+      // isync
+      if (inst.OPCD != 19 || inst.SUBOP10 != 150)
+        return false;
+      break;
+    case OPTYPE_BRANCH:
+      if (inst.LK)
+        return false;
+      if (inst.OPCD == 16 || (inst.OPCD == 19 && inst.SUBOP10 == 16))
+      {
+        // Decrementing CTR is progress.
+        if (!(inst.BO & BO_DONT_DECREMENT_FLAG))
+          return false;
+      }
+      else if (inst.OPCD != 18 && (inst.OPCD != 19 || inst.SUBOP10 != 528))
+      {
+        return false;
+      }
+      if (inst.OPCD != 18 && !(inst.BO & BO_DONT_CHECK_CONDITION) && !crs_written[inst.BI >> 2])
+        crs_read_first[inst.BI >> 2] = true;
+      break;
+    default:
+      return false;
+    }
+
+    if ((flags & FL_SET_OE) && inst.OE)
+      return false;
+
+    gprs_read_first |= code[i].regsIn & ~gprs_written;
+    gprs_written |= code[i].regsOut;
+
+    if ((flags & FL_READ_CA) && !ca_written)
+      ca_read_first = true;
+    if (flags & FL_SET_CA)
+      ca_written = true;
+
+    if ((flags & FL_SET_CR0) || ((flags & FL_RC_BIT) && inst.Rc))
+      crs_written[0] = true;
+    if (flags & FL_SET_CRn)
+      crs_written[inst.CRFD] = true;
+  }
+
+  return !(gprs_read_first & gprs_written) && !(crs_read_first & crs_written) &&
+         !(ca_read_first && ca_written);
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32 blockSize)
 {
   // Clear block stats
@@ -703,6 +911,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
   block->m_num_instructions = 0;
   block->m_gqr_used = BitSet8(0);
   block->m_physical_addresses.clear();
+  block->m_idle_loop = false;
 
   CodeOp* code = buffer->codebuffer;
 
@@ -751,11 +960,10 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
     {
       if (inst.OPCD == 18 && blockSize > 1)
       {
-        // Always follow BX instructions.
-        // TODO: Loop unrolling might bloat the code size too much.
-        //       Enable it carefully.
-        follow = destination != block->m_address;
+        // Always follow BX instructions, except back to the start of the block when the JIT wants
+        // to see the loop's back edge.
         destination = SignExt26(inst.LI << 2) + (inst.AA ? 0 : address);
+        follow = !HasOption(OPTION_KEEP_LOOP_BACK_EDGE) || destination != block->m_address;
         if (inst.LK)
         {
           found_call = true;
@@ -766,8 +974,8 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
                (inst.BO & BO_DONT_CHECK_CONDITION) && blockSize > 1)
       {
         // Always follow unconditional BCX instructions, but they are very rare.
-        follow = true;
         destination = SignExt16(inst.BD << 2) + (inst.AA ? 0 : address);
+        follow = !HasOption(OPTION_KEEP_LOOP_BACK_EDGE) || destination != block->m_address;
         if (inst.LK)
         {
           found_call = true;
@@ -968,7 +1176,61 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
   block->m_gqr_used = gqrUsed;
   block->m_gqr_modified = gqrModified;
   block->m_gpr_inputs = gprBlockInputs;
+
+  if (HasOption(OPTION_IDLE_LOOP_DETECTION) && !block->m_memory_exception)
+    block->m_idle_loop = IsIdleLoop(code, block->m_num_instructions, block->m_address);
+
   return address;
 }
 
+bool IsLoop(const CodeOp* ops, u32 count, u32 start)
+{
+  bool back_edge = false;
+  for (u32 i = 0; i < count; i++)
+  {
+    switch (ops[i].opinfo->type)
+    {
+    case OPTYPE_SPR:
+    case OPTYPE_SYSTEM:
+    case OPTYPE_DCACHE:
+    case OPTYPE_ICACHE:
+    case OPTYPE_UNKNOWN:
+    case OPTYPE_INVALID:
+      return false;
+    default:
+      break;
+    }
+
+    const UGeckoInstruction inst = ops[i].inst;
+    if (i == 0 || ops[i].skip || inst.LK)
+      continue;
+    if (inst.OPCD == 18)
+      back_edge |= SignExt26(inst.LI << 2) + (inst.AA ? 0 : ops[i].address) == start;
+    else if (inst.OPCD == 16)
+      back_edge |= SignExt16(inst.BD << 2) + (inst.AA ? 0 : ops[i].address) == start;
+  }
+  return back_edge;
+}
+
+BitSet32 GetMostReadRegisters(const CodeOp* ops, u32 count, bool fpr, size_t max)
+{
+  std::array<int, 32> reads{};
+  for (u32 i = 0; i < count; i++)
+  {
+    for (int reg : fpr ? ops[i].fregsIn : ops[i].regsIn)
+      reads[reg]++;
+  }
+
+  BitSet32 result;
+  for (size_t i = 0; i < max; i++)
+  {
+    auto most_read = std::max_element(reads.begin(), reads.end());
+    if (*most_read < 2)
+      break;
+    result[most_read - reads.begin()] = true;
+    *most_read = 0;
+  }
+  return result;
+}
+
 }  // namespace
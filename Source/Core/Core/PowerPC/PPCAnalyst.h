@@ -162,6 +162,10 @@ struct CodeBlock
 
   // Which memory locations are occupied by this block.
   std::set<u32> m_physical_addresses;
+
+  // Whether the block starts with a loop which can't make progress until memory changes, see
+  // OPTION_IDLE_LOOP_DETECTION.
+  bool m_idle_loop;
 };
 
 class PPCAnalyzer
@@ -218,6 +222,17 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Look for blocks which branch back to their start, and which, up to the last such branch,
+    // only load from memory, compute and branch, without carrying any register over from one
+    // iteration to the next. Until memory changes, such a loop does the same thing each time, so
+    // the JIT can skip to the next event when it branches back.
+    OPTION_IDLE_LOOP_DETECTION = (1 << 7),
+
+    // Don't follow unconditional branches back to the start of the block, but end the block
+    // there instead, so that the JIT sees the loop's back edge. Needed by
+    // OPTION_IDLE_LOOP_DETECTION and by JITs which keep registers across loop iterations.
+    OPTION_KEEP_LOOP_BACK_EDGE = (1 << 8),
   };
 
   PPCAnalyzer() : m_options(0) {}
@@ -233,4 +248,11 @@ void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB* func_db);
 bool AnalyzeFunction(u32 startAddr, Symbol& func, int max_size = 0);
 bool ReanalyzeFunction(u32 start_addr, Symbol& func, int max_size = 0);
 
+// Whether the block branches back to its start, other than from its first instruction (which is
+// an idle loop), and only contains instructions that can't invalidate it while it loops. The JITs
+// keep registers in host registers across the back edge of such blocks.
+bool IsLoop(const CodeOp* ops, u32 count, u32 start);
+// Returns up to max of the GPRs or FPRs read most often in the block.
+BitSet32 GetMostReadRegisters(const CodeOp* ops, u32 count, bool fpr, size_t max);
+
 }  // namespace
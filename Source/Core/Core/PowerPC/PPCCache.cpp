@@ -4,10 +4,13 @@
 
 #include "Core/PowerPC/PPCCache.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/ChunkFile.h"
+#include "Common/Logging/Log.h"
 #include "Common/Swap.h"
+#include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -60,9 +63,9 @@ void InstructionCache::Reset()
 {
   memset(valid, 0, sizeof(valid));
   memset(plru, 0, sizeof(plru));
-  memset(lookup_table, 0xff, sizeof(lookup_table));
-  memset(lookup_table_ex, 0xff, sizeof(lookup_table_ex));
-  memset(lookup_table_vmem, 0xff, sizeof(lookup_table_vmem));
+  std::fill(lookup_table.begin(), lookup_table.end(), 0xff);
+  std::fill(lookup_table_ex.begin(), lookup_table_ex.end(), 0xff);
+  std::fill(lookup_table_vmem.begin(), lookup_table_vmem.end(), 0xff);
   JitInterface::ClearSafe();
 }
 
@@ -70,51 +73,95 @@ void InstructionCache::Init()
 {
   memset(data, 0, sizeof(data));
   memset(tags, 0, sizeof(tags));
+  memset(way_hint, 0, sizeof(way_hint));
+
+  mode = static_cast<ICacheMode>(SConfig::GetInstance().iICacheMode);
+  if (mode != ICacheMode::Compact && mode != ICacheMode::Lazy)
+    mode = ICacheMode::Table;
+  emulating = mode != ICacheMode::Lazy;
+
+  if (mode == ICacheMode::Table)
+  {
+    lookup_table.resize(1 << 20);
+    lookup_table_ex.resize(1 << 21);
+    lookup_table_vmem.resize(1 << 20);
+  }
+  else
+  {
+    // Give the memory back if a previous game used the tables.
+    std::vector<u8>().swap(lookup_table);
+    std::vector<u8>().swap(lookup_table_ex);
+    std::vector<u8>().swap(lookup_table_vmem);
+  }
 
   Reset();
 }
 
+// Only valid for ICacheMode::Table. block is the address shifted right by 5.
+u8& InstructionCache::GetLookupTableEntry(u32 block)
+{
+  if (block & (ICACHE_VMEM_BIT >> 5))
+    return lookup_table_vmem[block & 0xfffff];
+  if (block & (ICACHE_EXRAM_BIT >> 5))
+    return lookup_table_ex[block & 0x1fffff];
+  return lookup_table[block & 0xfffff];
+}
+
+// Returns the way holding the block at addr, or 0xff if it isn't cached.
+u32 InstructionCache::FindWay(u32 addr, u32 set, u32 tag)
+{
+  if (mode == ICacheMode::Table)
+    return GetLookupTableEntry(addr >> 5);
+
+  u8& hint = way_hint[(addr >> 5) % ICACHE_WAY_HINTS];
+  if ((valid[set] & (1 << hint)) && tags[set][hint] == tag)
+    return hint;
+
+  for (u32 way = 0; way < ICACHE_WAYS; way++)
+  {
+    if ((valid[set] & (1 << way)) && tags[set][way] == tag)
+    {
+      hint = way;
+      return way;
+    }
+  }
+  return 0xff;
+}
+
+void InstructionCache::EvictWay(u32 set, u32 way)
+{
+  if (mode == ICacheMode::Table && (valid[set] & (1 << way)))
+    GetLookupTableEntry((tags[set][way] << 7) | set) = 0xff;
+}
+
 void InstructionCache::Invalidate(u32 addr)
 {
   if (!HID0.ICE)
     return;
+
+  if (!emulating)
+  {
+    // Nothing has been cached yet, so the cache starts out empty, as if it was flash invalidated.
+    INFO_LOG(POWERPC, "icbi at %08x, starting instruction cache emulation", PC);
+    emulating = true;
+  }
+
   // invalidates the whole set
   u32 set = (addr >> 5) & 0x7f;
-  for (int i = 0; i < 8; i++)
-    if (valid[set] & (1 << i))
-    {
-      if (tags[set][i] & (ICACHE_VMEM_BIT >> 12))
-        lookup_table_vmem[((tags[set][i] << 7) | set) & 0xfffff] = 0xff;
-      else if (tags[set][i] & (ICACHE_EXRAM_BIT >> 12))
-        lookup_table_ex[((tags[set][i] << 7) | set) & 0x1fffff] = 0xff;
-      else
-        lookup_table[((tags[set][i] << 7) | set) & 0xfffff] = 0xff;
-    }
+  for (u32 i = 0; i < ICACHE_WAYS; i++)
+    EvictWay(set, i);
   valid[set] = 0;
   JitInterface::InvalidateICache(addr & ~0x1f, 32, false);
 }
 
 u32 InstructionCache::ReadInstruction(u32 addr)
 {
-  if (!HID0.ICE)  // instruction cache is disabled
+  if (!HID0.ICE || !emulating)  // instruction cache is disabled or not emulated yet
     return Memory::Read_U32(addr);
   u32 set = (addr >> 5) & 0x7f;
   u32 tag = addr >> 12;
 
-  u32 t;
-  if (addr & ICACHE_VMEM_BIT)
-  {
-    t = lookup_table_vmem[(addr >> 5) & 0xfffff];
-  }
-  else if (addr & ICACHE_EXRAM_BIT)
-  {
-    t = lookup_table_ex[(addr >> 5) & 0x1fffff];
-  }
-  else
-  {
-    t = lookup_table[(addr >> 5) & 0xfffff];
-  }
-
+  u32 t = FindWay(addr, set, tag);
   if (t == 0xff)  // load to the cache
   {
     if (HID0.ILOCK)  // instruction cache is locked
@@ -126,22 +173,12 @@ u32 InstructionCache::ReadInstruction(u32 addr)
       t = way_from_plru[plru[set]];
     // load
     Memory::CopyFromEmu((u8*)data[set][t], (addr & ~0x1f), 32);
-    if (valid[set] & (1 << t))
-    {
-      if (tags[set][t] & (ICACHE_VMEM_BIT >> 12))
-        lookup_table_vmem[((tags[set][t] << 7) | set) & 0xfffff] = 0xff;
-      else if (tags[set][t] & (ICACHE_EXRAM_BIT >> 12))
-        lookup_table_ex[((tags[set][t] << 7) | set) & 0x1fffff] = 0xff;
-      else
-        lookup_table[((tags[set][t] << 7) | set) & 0xfffff] = 0xff;
-    }
+    EvictWay(set, t);
 
-    if (addr & ICACHE_VMEM_BIT)
-      lookup_table_vmem[(addr >> 5) & 0xfffff] = t;
-    else if (addr & ICACHE_EXRAM_BIT)
-      lookup_table_ex[(addr >> 5) & 0x1fffff] = t;
+    if (mode == ICacheMode::Table)
+      GetLookupTableEntry(addr >> 5) = t;
     else
-      lookup_table[(addr >> 5) & 0xfffff] = t;
+      way_hint[(addr >> 5) % ICACHE_WAY_HINTS] = t;
     tags[set][t] = tag;
     valid[set] |= (1 << t);
   }
@@ -153,14 +190,33 @@ u32 InstructionCache::ReadInstruction(u32 addr)
 
 void InstructionCache::DoState(PointerWrap& p)
 {
+  // The lookup tables and way hints can be rebuilt from the tags, so states don't depend on the
+  // mode they were saved with.
   p.DoArray(data);
   p.DoArray(tags);
   p.DoArray(plru);
   p.DoArray(valid);
-  p.DoArray(way_from_valid);
-  p.DoArray(way_from_plru);
-  p.DoArray(lookup_table);
-  p.DoArray(lookup_table_ex);
-  p.DoArray(lookup_table_vmem);
+  bool saved_emulating = emulating;
+  p.Do(saved_emulating);
+
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    emulating = saved_emulating || mode != ICacheMode::Lazy;
+    std::fill(lookup_table.begin(), lookup_table.end(), 0xff);
+    std::fill(lookup_table_ex.begin(), lookup_table_ex.end(), 0xff);
+    std::fill(lookup_table_vmem.begin(), lookup_table_vmem.end(), 0xff);
+    for (u32 set = 0; set < ICACHE_SETS; set++)
+    {
+      for (u32 way = 0; way < ICACHE_WAYS; way++)
+      {
+        if (!(valid[set] & (1 << way)))
+          continue;
+        if (mode == ICacheMode::Table)
+          GetLookupTableEntry((tags[set][way] << 7) | set) = way;
+        else
+          way_hint[((tags[set][way] << 7) | set) % ICACHE_WAY_HINTS] = way;
+      }
+    }
+  }
 }
 }  // namespace PowerPC
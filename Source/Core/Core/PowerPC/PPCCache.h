@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -18,6 +20,21 @@ const u32 ICACHE_BLOCK_SIZE = 8;
 const u32 ICACHE_EXRAM_BIT = 0x10000000;
 const u32 ICACHE_VMEM_BIT = 0x20000000;
 
+// Size of the way hint table of ICacheMode::Compact, indexed by the low bits of the block number.
+const u32 ICACHE_WAY_HINTS = 4096;
+
+// How the instruction cache is emulated. Stored in SConfig::iICacheMode, which can be set per game.
+enum class ICacheMode
+{
+  // Tables mapping every block of memory to the way it is cached in. 4 MiB.
+  Table = 0,
+  // Compares the tags of a set, starting with the way last hit by blocks with the same low bits.
+  Compact = 1,
+  // Fetches straight from memory until the game first invalidates a block with icbi, and then
+  // works like Compact. For games which only ever flash invalidate the whole cache.
+  Lazy = 2,
+};
+
 struct InstructionCache
 {
   u32 data[ICACHE_SETS][ICACHE_WAYS][ICACHE_BLOCK_SIZE];
@@ -28,9 +45,16 @@ struct InstructionCache
   u32 way_from_valid[255];
   u32 way_from_plru[128];
 
-  u8 lookup_table[1 << 20];
-  u8 lookup_table_ex[1 << 21];
-  u8 lookup_table_vmem[1 << 20];
+  ICacheMode mode = ICacheMode::Table;
+  // False while ICacheMode::Lazy hasn't seen an icbi yet.
+  bool emulating = true;
+
+  // Only allocated for ICacheMode::Table.
+  std::vector<u8> lookup_table;
+  std::vector<u8> lookup_table_ex;
+  std::vector<u8> lookup_table_vmem;
+
+  u8 way_hint[ICACHE_WAY_HINTS];
 
   InstructionCache();
   u32 ReadInstruction(u32 addr);
@@ -38,5 +62,10 @@ struct InstructionCache
   void Init();
   void Reset();
   void DoState(PointerWrap& p);
+
+private:
+  u8& GetLookupTableEntry(u32 block);
+  u32 FindWay(u32 addr, u32 set, u32 tag);
+  void EvictWay(u32 set, u32 way);
 };
 }  // namespace PowerPC
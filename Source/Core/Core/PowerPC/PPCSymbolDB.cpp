@@ -4,15 +4,25 @@
 
 #include "Core/PowerPC/PPCSymbolDB.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/SignatureDB/SignatureDB.h"
@@ -26,6 +36,217 @@ static std::string GetStrippedFunctionName(const std::string& symbol_name)
   return name;
 }
 
+// What AddKnownSymbol adds for a symbol which isn't in the database yet.
+static Symbol AnalyzeKnownSymbol(u32 start_addr, u32 size, const std::string& name,
+                                 Symbol::Type type)
+{
+  Symbol symbol;
+  symbol.name = name;
+  symbol.type = type;
+  symbol.address = start_addr;
+  if (symbol.type == Symbol::Type::Function)
+  {
+    PPCAnalyst::AnalyzeFunction(start_addr, symbol, size);
+    symbol.function_name = GetStrippedFunctionName(name);
+  }
+  symbol.size = size;
+  return symbol;
+}
+
+// Loading a map parses it, checks each entry against the code in RAM and analyzes the functions,
+// which takes a while for large maps. The symbols it adds are cached in a binary file per game and
+// map, which is used as long as neither the map nor the code it describes changed since. Keying
+// the file on the map too keeps the maps of a game and of MIOS from replacing each other.
+namespace
+{
+constexpr u32 SYMBOL_CACHE_MAGIC = 0x43535044;  // "DPSC"
+constexpr u32 SYMBOL_CACHE_VERSION = 3;
+
+struct SymbolCacheKey
+{
+  u64 map_hash;
+  u64 ram_hash;
+};
+
+struct MapEntry
+{
+  u32 address;
+  u32 size;
+  std::string name;
+};
+
+template <typename T>
+void AppendValue(std::string* out, const T& value)
+{
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class SymbolCacheReader
+{
+public:
+  explicit SymbolCacheReader(const std::string& data) : m_data(data) {}
+
+  template <typename T>
+  bool Read(T* value)
+  {
+    if (m_data.size() - m_position < sizeof(T))
+      return false;
+    std::memcpy(value, m_data.data() + m_position, sizeof(T));
+    m_position += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string* value, size_t length)
+  {
+    if (m_data.size() - m_position < length)
+      return false;
+    value->assign(m_data, m_position, length);
+    m_position += length;
+    return true;
+  }
+
+private:
+  const std::string& m_data;
+  size_t m_position = 0;
+};
+}
+
+static std::string GetSymbolCachePath(u64 map_hash)
+{
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  if (game_id.empty() || !Memory::m_pRAM)
+    return "";
+  return File::GetUserPath(D_CACHE_IDX) + "Symbols" DIR_SEP + game_id +
+         StringFromFormat("_%016llx.bin", static_cast<unsigned long long>(map_hash));
+}
+
+// Entries without a size are analyzed up to the first blr, so the code their symbols depend on
+// isn't known before analyzing them. They aren't cached, and are analyzed on every load.
+static bool IsCachedEntry(const MapEntry& entry)
+{
+  return entry.size != 0;
+}
+
+// Hashes the code the cached entries of a map cover, which is all that their symbols depend on. The
+// rest of RAM changes with the OS globals, the heap and whatever else was loaded next to the
+// executable.
+static bool HashMappedCode(const std::vector<MapEntry>& entries, u64* hash)
+{
+  std::vector<std::pair<u32, u32>> ranges;
+  ranges.reserve(entries.size());
+  for (const MapEntry& entry : entries)
+  {
+    if (IsCachedEntry(entry))
+      ranges.emplace_back(entry.address, entry.address + entry.size);
+  }
+  std::sort(ranges.begin(), ranges.end());
+
+  XXH64_state_t* state = XXH64_createState();
+  XXH64_reset(state, 0);
+  bool valid = true;
+  for (size_t i = 0; i < ranges.size() && valid;)
+  {
+    const u32 start = ranges[i].first;
+    u32 end = ranges[i].second;
+    for (++i; i < ranges.size() && ranges[i].first <= end; ++i)
+      end = std::max(end, ranges[i].second);
+
+    const u8* first = Memory::GetPointer(start);
+    const u8* last = Memory::GetPointer(end - 1);
+    valid = first && last && end > start && static_cast<u32>(last - first) == end - 1 - start;
+    if (valid)
+    {
+      XXH64_update(state, &start, sizeof(start));
+      XXH64_update(state, first, end - start);
+    }
+  }
+  *hash = XXH64_digest(state);
+  XXH64_freeState(state);
+  return valid;
+}
+
+static void AppendSymbol(std::string* out, const Symbol& symbol)
+{
+  AppendValue(out, symbol.address);
+  AppendValue(out, static_cast<u32>(symbol.size));
+  AppendValue(out, symbol.hash);
+  AppendValue(out, symbol.flags);
+  AppendValue(out, static_cast<u32>(symbol.numCalls));
+  AppendValue(out, static_cast<u8>(symbol.type));
+  AppendValue(out, static_cast<u8>(symbol.analyzed));
+  AppendValue(out, static_cast<u32>(symbol.name.size()));
+  AppendValue(out, static_cast<u32>(symbol.calls.size()));
+  out->append(symbol.name);
+  for (const SCall& call : symbol.calls)
+  {
+    AppendValue(out, call.function);
+    AppendValue(out, call.callAddress);
+  }
+}
+
+static bool ReadSymbol(SymbolCacheReader* reader, Symbol* symbol)
+{
+  u32 size, num_calls, name_length, calls_count;
+  u8 type, analyzed;
+  if (!reader->Read(&symbol->address) || !reader->Read(&size) || !reader->Read(&symbol->hash) ||
+      !reader->Read(&symbol->flags) || !reader->Read(&num_calls) || !reader->Read(&type) ||
+      !reader->Read(&analyzed) || !reader->Read(&name_length) || !reader->Read(&calls_count) ||
+      !reader->ReadString(&symbol->name, name_length))
+  {
+    return false;
+  }
+
+  symbol->size = static_cast<int>(size);
+  symbol->numCalls = static_cast<int>(num_calls);
+  symbol->type = static_cast<Symbol::Type>(type);
+  symbol->analyzed = analyzed != 0;
+  if (symbol->type == Symbol::Type::Function)
+    symbol->function_name = GetStrippedFunctionName(symbol->name);
+
+  for (u32 i = 0; i < calls_count; ++i)
+  {
+    u32 function, call_address;
+    if (!reader->Read(&function) || !reader->Read(&call_address))
+      return false;
+    symbol->calls.emplace_back(function, call_address);
+  }
+  return true;
+}
+
+// Reads the symbols of the cached entries of a map loaded before, or returns false if the cache
+// doesn't match it.
+static bool LoadSymbolCache(const std::string& cache_path, const SymbolCacheKey& key,
+                            std::vector<Symbol>* symbols)
+{
+  std::string data;
+  if (!File::ReadFileToString(cache_path, data))
+    return false;
+
+  SymbolCacheReader reader(data);
+  u32 magic, version, count;
+  SymbolCacheKey cached_key;
+  if (!reader.Read(&magic) || !reader.Read(&version) || !reader.Read(&cached_key.map_hash) ||
+      !reader.Read(&cached_key.ram_hash) || !reader.Read(&count) ||
+      magic != SYMBOL_CACHE_MAGIC || version != SYMBOL_CACHE_VERSION ||
+      cached_key.map_hash != key.map_hash || cached_key.ram_hash != key.ram_hash)
+  {
+    return false;
+  }
+
+  symbols->clear();
+  for (u32 i = 0; i < count; ++i)
+  {
+    Symbol symbol;
+    if (!ReadSymbol(&reader, &symbol))
+    {
+      WARN_LOG(OSHLE, "Symbol cache %s is truncated", cache_path.c_str());
+      return false;
+    }
+    symbols->push_back(std::move(symbol));
+  }
+  return true;
+}
+
 PPCSymbolDB g_symbolDB;
 
 PPCSymbolDB::PPCSymbolDB()
@@ -52,7 +273,7 @@ Symbol* PPCSymbolDB::AddFunction(u32 start_addr)
   functions[start_addr] = std::move(symbol);
   Symbol* ptr = &functions[start_addr];
   ptr->type = Symbol::Type::Function;
-  checksumToFunction[ptr->hash].insert(ptr);
+  InvalidateLookupTables();
   return ptr;
 }
 
@@ -73,37 +294,18 @@ void PPCSymbolDB::AddKnownSymbol(u32 startAddr, u32 size, const std::string& nam
   else
   {
     // new symbol. run analyze.
-    Symbol tf;
-    tf.name = name;
-    tf.type = type;
-    tf.address = startAddr;
-    if (tf.type == Symbol::Type::Function)
-    {
-      PPCAnalyst::AnalyzeFunction(startAddr, tf, size);
-      checksumToFunction[tf.hash].insert(&functions[startAddr]);
-      tf.function_name = GetStrippedFunctionName(name);
-    }
-    tf.size = size;
-    functions[startAddr] = tf;
+    functions[startAddr] = AnalyzeKnownSymbol(startAddr, size, name, type);
   }
+  InvalidateLookupTables();
 }
 
 Symbol* PPCSymbolDB::GetSymbolFromAddr(u32 addr)
 {
   XFuncMap::iterator it = functions.find(addr);
   if (it != functions.end())
-  {
     return &it->second;
-  }
-  else
-  {
-    for (auto& p : functions)
-    {
-      if (addr >= p.second.address && addr < p.second.address + p.second.size)
-        return &p.second;
-    }
-  }
-  return nullptr;
+
+  return GetSymbolContaining(addr);
 }
 
 std::string PPCSymbolDB::GetDescription(u32 addr)
@@ -228,6 +430,9 @@ bool PPCSymbolDB::LoadMap(const std::string& filename, bool bad)
   if (!f)
     return false;
 
+  const auto start_time = std::chrono::steady_clock::now();
+  std::vector<MapEntry> entries;
+
   // four columns are used in American Mensa Academy map files and perhaps other games
   bool started = false, four_columns = false;
   int good_count = 0, bad_count = 0;
@@ -373,7 +578,7 @@ bool PPCSymbolDB::LoadMap(const std::string& filename, bool bad)
       if (good)
       {
         ++good_count;
-        AddKnownSymbol(vaddress, size, name);  // ST_FUNCTION
+        entries.push_back({vaddress, size, name});
       }
       else
       {
@@ -382,6 +587,79 @@ bool PPCSymbolDB::LoadMap(const std::string& filename, bool bad)
     }
   }
 
+  // Parsing is quick, it's analyzing the functions which is worth skipping. Maps which might not
+  // match the game are checked more carefully, and the results reported, so they're never cached.
+  const u32 cached_count =
+      static_cast<u32>(std::count_if(entries.begin(), entries.end(), IsCachedEntry));
+  std::string map_contents, cache_path;
+  SymbolCacheKey cache_key = {};
+  if (!bad && File::ReadFileToString(filename, map_contents) &&
+      HashMappedCode(entries, &cache_key.ram_hash))
+  {
+    cache_key.map_hash = XXH64(map_contents.data(), map_contents.size(), 0);
+    cache_path = GetSymbolCachePath(cache_key.map_hash);
+    std::vector<Symbol> symbols;
+    if (!cache_path.empty() && LoadSymbolCache(cache_path, cache_key, &symbols) &&
+        symbols.size() == cached_count)
+    {
+      // Applied in the order of the map, the same way as the entries are added below.
+      auto symbol = symbols.begin();
+      for (const MapEntry& entry : entries)
+      {
+        if (!IsCachedEntry(entry) || functions.find(entry.address) != functions.end())
+          AddKnownSymbol(entry.address, entry.size, entry.name);  // ST_FUNCTION
+        else
+          functions[entry.address] = std::move(*symbol);
+        if (IsCachedEntry(entry))
+          ++symbol;
+      }
+      Index();
+
+      const auto duration = std::chrono::steady_clock::now() - start_time;
+      NOTICE_LOG(OSHLE, "Loaded %s from the symbol cache in %u ms", filename.c_str(),
+                 static_cast<u32>(
+                     std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+      return true;
+    }
+  }
+  const bool write_cache = !cache_path.empty();
+
+  std::string cache;
+  if (write_cache)
+  {
+    AppendValue(&cache, SYMBOL_CACHE_MAGIC);
+    AppendValue(&cache, SYMBOL_CACHE_VERSION);
+    AppendValue(&cache, cache_key.map_hash);
+    AppendValue(&cache, cache_key.ram_hash);
+    AppendValue(&cache, cached_count);
+  }
+  for (const MapEntry& entry : entries)
+  {
+    const bool existed = functions.find(entry.address) != functions.end();
+    AddKnownSymbol(entry.address, entry.size, entry.name);  // ST_FUNCTION
+    if (!write_cache || !IsCachedEntry(entry))
+      continue;
+
+    // An entry for an address which already had a symbol only updates it, but the cache has to
+    // hold what would be added to a database without it.
+    if (existed)
+    {
+      AppendSymbol(&cache, AnalyzeKnownSymbol(entry.address, entry.size, entry.name,
+                                              Symbol::Type::Function));
+    }
+    else
+    {
+      AppendSymbol(&cache, functions[entry.address]);
+    }
+  }
+
+  if (write_cache)
+  {
+    File::CreateFullPath(cache_path);
+    if (!File::WriteStringToFile(cache, cache_path))
+      WARN_LOG(OSHLE, "Failed to write the symbol cache to %s", cache_path.c_str());
+  }
+
   Index();
   if (bad)
     SuccessAlertT("Loaded %d good functions, ignored %d bad functions.", good_count, bad_count);
@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/PowerPC.h"
 
+#include <cinttypes>
 #include <cstring>
 #include <vector>
 
@@ -21,6 +22,7 @@
 #include "Core/HW/SystemTimers.h"
 #include "Core/Host.h"
 #include "Core/PowerPC/CPUCoreBase.h"
+#include "Core/PowerPC/IdleLoops.h"
 #include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/JitInterface.h"
 
@@ -229,6 +231,7 @@ void Reset()
   ppcState.pagetable_base = 0;
   ppcState.pagetable_hashmask = 0;
   ppcState.tlb = {};
+  ResetHostPageCacheStats();
 
   ResetRegisters();
   ppcState.iCache.Reset();
@@ -249,6 +252,14 @@ void ScheduleInvalidateCacheThreadSafe(u32 address)
 
 void Shutdown()
 {
+  const HostPageCacheStats stats = GetHostPageCacheStats();
+  if (stats.hits + stats.misses != 0)
+  {
+    INFO_LOG(POWERPC, "Host page cache: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate)",
+             stats.hits, stats.misses, 100.0 * stats.hits / (stats.hits + stats.misses));
+  }
+  IdleLoops::Report();
+
   InjectExternalCPUCore(nullptr);
   JitInterface::Shutdown();
   s_interpreter->Shutdown();
@@ -277,6 +277,16 @@ void InvalidateTLBEntry(u32 address);
 void DBATUpdated();
 void IBATUpdated();
 
+// How often loads and stores with data translation enabled found the host pointer for their page
+// in the cache, instead of translating the address.
+struct HostPageCacheStats
+{
+  u64 hits;
+  u64 misses;
+};
+HostPageCacheStats GetHostPageCacheStats();
+void ResetHostPageCacheStats();
+
 // Result changes based on the BAT registers and MSR.DR.  Returns whether
 // it's safe to optimize a read or write to this address to an unguarded
 // memory access.  Does not consider page tables.
@@ -0,0 +1,372 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/SamplingProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/Flag.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Swap.h"
+#include "Common/Thread.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MachineContext.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#if !defined(_M_GENERIC) && defined(_WIN32) && defined(_M_X86_64)
+#define SAMPLE_BY_SUSPENDING
+#elif !defined(_M_GENERIC) && defined(__linux__) && (defined(_M_X86_64) || defined(_M_ARM_64))
+#define SAMPLE_BY_SIGNAL
+#include <pthread.h>
+#include <signal.h>
+#include <ucontext.h>
+#if _M_X86_64
+#define CTX_HOST_PC CTX_RIP
+#else
+#define CTX_HOST_PC CTX_PC
+#endif
+#endif
+
+namespace SamplingProfiler
+{
+constexpr auto SAMPLE_INTERVAL = std::chrono::milliseconds(1);
+constexpr u32 MAX_STACK_DEPTH = 16;
+// Samples waiting to be resolved. Samples taken while it is full are dropped.
+constexpr u32 BUFFER_SIZE = 1 << 16;
+
+struct Sample
+{
+  uintptr_t host_pc;
+  u32 pc;
+  u32 depth;
+  // Return addresses, innermost first.
+  std::array<u32, MAX_STACK_DEPTH> stack;
+};
+
+// Written by whichever thread takes the samples, read by ResolveSamples.
+static std::vector<Sample> s_buffer;
+static std::atomic<u32> s_write_index{0};
+static std::atomic<u32> s_read_index{0};
+static std::atomic<u32> s_dropped{0};
+
+// Guards everything below.
+static std::mutex s_mutex;
+// Guest call stacks, outermost function first, and the number of samples they got.
+static std::map<std::vector<u32>, u64> s_stacks;
+static bool s_running = false;
+static bool s_have_cpu_thread = false;
+static std::thread s_sampler_thread;
+static Common::Flag s_sampler_quit;
+
+#if defined(SAMPLE_BY_SUSPENDING)
+static HANDLE s_cpu_thread;
+#elif defined(SAMPLE_BY_SIGNAL)
+static pthread_t s_cpu_thread;
+#endif
+
+// Reads guest memory without going through address translation, which can't be done from a signal
+// handler. Stacks are always in the default BAT mapped areas.
+static bool ReadStackWord(u32 address, u32* value)
+{
+  if (address & 3)
+    return false;
+
+  const u32 offset = address & 0x0FFFFFFF;
+  const u8* base;
+  switch (address >> 28)
+  {
+  case 0x8:
+  case 0xC:
+    if (offset >= Memory::REALRAM_SIZE)
+      return false;
+    base = Memory::m_pRAM;
+    break;
+  case 0x9:
+  case 0xD:
+    if (!Memory::m_pEXRAM || offset >= Memory::EXRAM_SIZE)
+      return false;
+    base = Memory::m_pEXRAM;
+    break;
+  default:
+    return false;
+  }
+
+  u32 word;
+  std::memcpy(&word, base + offset, sizeof(word));
+  *value = Common::swap32(word);
+  return true;
+}
+
+// Called on the interrupted CPU thread, or while it is suspended. The JITs may keep r1 in a host
+// register for a while, in which case the stack of the block's caller is recorded.
+static void RecordSample(uintptr_t host_pc)
+{
+  const u32 write = s_write_index.load(std::memory_order_relaxed);
+  if (write - s_read_index.load(std::memory_order_acquire) >= BUFFER_SIZE)
+  {
+    s_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  Sample& sample = s_buffer[write % BUFFER_SIZE];
+  sample.host_pc = host_pc;
+  sample.pc = PC;
+  // LR is the return address in leaf functions. In others, it points into the function itself,
+  // which gets merged with it later.
+  sample.stack[0] = LR;
+  sample.depth = 1;
+
+  u32 frame;
+  u32 return_address;
+  if (ReadStackWord(PowerPC::ppcState.gpr[1], &frame))
+  {
+    while (sample.depth < MAX_STACK_DEPTH && ReadStackWord(frame + 4, &return_address))
+    {
+      sample.stack[sample.depth++] = return_address;
+      if (!ReadStackWord(frame, &frame))
+        break;
+    }
+  }
+
+  s_write_index.store(write + 1, std::memory_order_release);
+}
+
+#if defined(SAMPLE_BY_SIGNAL)
+static void SignalHandler(int, siginfo_t*, void* raw_context)
+{
+  RecordSample(static_cast<ucontext_t*>(raw_context)->uc_mcontext.CTX_HOST_PC);
+}
+#endif
+
+static void TakeSample()
+{
+#if defined(SAMPLE_BY_SUSPENDING)
+  if (SuspendThread(s_cpu_thread) == static_cast<DWORD>(-1))
+    return;
+  CONTEXT context = {};
+  context.ContextFlags = CONTEXT_CONTROL;
+  if (GetThreadContext(s_cpu_thread, &context))
+    RecordSample(context.CTX_RIP);
+  ResumeThread(s_cpu_thread);
+#elif defined(SAMPLE_BY_SIGNAL)
+  pthread_kill(s_cpu_thread, SIGPROF);
+#else
+  // Without a way to interrupt the CPU thread, only the guest state is sampled. The JITs only
+  // update the PC when leaving a block, so this is less precise.
+  RecordSample(0);
+#endif
+}
+
+static void SamplerThread()
+{
+  Common::SetCurrentThreadName("Sampling profiler");
+
+  while (!s_sampler_quit.IsSet())
+  {
+    std::this_thread::sleep_for(SAMPLE_INTERVAL);
+    if (Core::GetState() == Core::State::Running)
+      TakeSample();
+  }
+}
+
+static void StartSampler()
+{
+  if (!s_running || !s_have_cpu_thread || s_sampler_thread.joinable())
+    return;
+
+  s_sampler_quit.Clear();
+  s_sampler_thread = std::thread(SamplerThread);
+}
+
+static void StopSampler()
+{
+  if (!s_sampler_thread.joinable())
+    return;
+
+  s_sampler_quit.Set();
+  s_sampler_thread.join();
+}
+
+namespace
+{
+struct BlockRange
+{
+  const u8* start;
+  const u8* end;
+  u32 address;
+};
+}
+
+static void Resolve()
+{
+  const u32 write = s_write_index.load(std::memory_order_acquire);
+  u32 read = s_read_index.load(std::memory_order_relaxed);
+  if (read == write)
+    return;
+
+  std::vector<BlockRange> blocks;
+  if (g_jit)
+  {
+    g_jit->GetBlockCache()->RunOnBlocks([&blocks](const JitBlock& block) {
+      blocks.push_back(
+          {block.checkedEntry, block.checkedEntry + block.codeSize, block.effectiveAddress});
+    });
+    std::sort(blocks.begin(), blocks.end(),
+              [](const BlockRange& a, const BlockRange& b) { return a.start < b.start; });
+  }
+
+  for (; read != write; read++)
+  {
+    const Sample& sample = s_buffer[read % BUFFER_SIZE];
+
+    // Samples taken outside of the blocks, like in far code or in functions called by them, are
+    // attributed to the PC from the guest state.
+    u32 pc = sample.pc;
+    const u8* host_pc = reinterpret_cast<const u8*>(sample.host_pc);
+    auto block = std::upper_bound(
+        blocks.begin(), blocks.end(), host_pc,
+        [](const u8* address, const BlockRange& range) { return address < range.start; });
+    if (block != blocks.begin() && host_pc < (--block)->end)
+      pc = block->address;
+
+    std::vector<u32> stack(sample.stack.rend() - sample.depth, sample.stack.rend());
+    // Return addresses point past the call.
+    for (u32& address : stack)
+      address -= 4;
+    stack.push_back(pc);
+    s_stacks[stack]++;
+  }
+
+  s_read_index.store(read, std::memory_order_release);
+}
+
+static std::string GetFunctionName(u32 address)
+{
+  const Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+  if (!symbol)
+    return StringFromFormat("%08x", address);
+
+  // Spaces and semicolons separate the fields of the folded stack format.
+  std::string name = symbol->name;
+  std::replace(name.begin(), name.end(), ' ', '_');
+  std::replace(name.begin(), name.end(), ';', ':');
+  return name;
+}
+
+void SetCPUThread()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+
+#if defined(SAMPLE_BY_SUSPENDING)
+  DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &s_cpu_thread,
+                  THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, 0);
+#elif defined(SAMPLE_BY_SIGNAL)
+  s_cpu_thread = pthread_self();
+
+  struct sigaction sa = {};
+  sa.sa_sigaction = SignalHandler;
+  sa.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGPROF, &sa, nullptr);
+#endif
+
+  s_have_cpu_thread = true;
+  StartSampler();
+}
+
+void ClearCPUThread()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+
+  StopSampler();
+  s_have_cpu_thread = false;
+#if defined(SAMPLE_BY_SUSPENDING)
+  CloseHandle(s_cpu_thread);
+#endif
+
+  // The JIT goes away with the CPU thread.
+  Resolve();
+}
+
+void Start()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+
+  if (s_buffer.empty())
+    s_buffer.resize(BUFFER_SIZE);
+  s_stacks.clear();
+  s_read_index.store(s_write_index.load());
+  s_dropped.store(0);
+
+  s_running = true;
+  StartSampler();
+}
+
+bool IsRunning()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  return s_running;
+}
+
+bool Stop(const std::string& path)
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+
+  s_running = false;
+  StopSampler();
+  Resolve();
+
+  // Stacks which only differ in the addresses within their functions are merged.
+  std::map<std::string, u64> folded;
+  for (const auto& entry : s_stacks)
+  {
+    std::string line;
+    std::string previous;
+    for (u32 address : entry.first)
+    {
+      std::string name = GetFunctionName(address);
+      if (name == previous)
+        continue;
+      if (!line.empty())
+        line += ';';
+      line += name;
+      previous = std::move(name);
+    }
+    folded[line] += entry.second;
+  }
+  s_stacks.clear();
+
+  const u32 dropped = s_dropped.exchange(0);
+  if (dropped)
+    WARN_LOG(POWERPC, "Sampling profiler dropped %u samples", dropped);
+
+  std::string text;
+  for (const auto& entry : folded)
+    text += entry.first + ' ' + std::to_string(entry.second) + '\n';
+
+  File::IOFile file(path, "w");
+  return file.WriteBytes(text.data(), text.size());
+}
+
+void ResolveSamples()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  Resolve();
+}
+}
@@ -0,0 +1,28 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+// Finds out where the emulated CPU spends its time, without recompiling or instrumenting any code.
+// About a thousand times per second, the CPU thread is interrupted, and the guest code it was
+// running is recorded together with the guest call stack. When the JIT is used, the host PC is
+// mapped back to the block it belongs to. The results are written in the folded stack format
+// read by flame graph tools, with functions named after the loaded symbol map.
+namespace SamplingProfiler
+{
+// Called by the thread which runs guest code, once it starts and before it exits.
+void SetCPUThread();
+void ClearCPUThread();
+
+void Start();
+bool IsRunning();
+// Stops sampling and writes the samples taken so far to path. The CPU thread has to be paused.
+bool Stop(const std::string& path);
+
+// Maps the pending samples back to guest code. Has to be called with the CPU thread paused, or on
+// it, before the JIT frees any code.
+void ResolveSamples();
+}
@@ -8,12 +8,15 @@
 #include <cstdlib>
 #include <fstream>
 #include <limits>
+#include <map>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
+#include "Common/ParallelFor.h"
 #include "Common/StringUtil.h"
 
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -102,15 +105,14 @@ bool GetRefs(MEGASignature* sig, std::istringstream* iss)
   return true;
 }
 
-bool Compare(u32 address, u32 size, const MEGASignature& sig)
+bool Compare(const std::vector<u32>& code, const MEGASignature& sig)
 {
-  if (size != sig.code.size() * sizeof(u32))
+  if (code.size() != sig.code.size())
     return false;
 
   for (size_t i = 0; i < sig.code.size(); ++i)
   {
-    if (sig.code[i] != 0 &&
-        PowerPC::HostRead_U32(static_cast<u32>(address + i * sizeof(u32))) != sig.code[i])
+    if (sig.code[i] != 0 && code[i] != sig.code[i])
       return false;
   }
   return true;
@@ -159,19 +161,52 @@ bool MEGASignatureDB::Save(const std::string& file_path) const
 
 void MEGASignatureDB::Apply(PPCSymbolDB* symbol_db) const
 {
+  // Only signatures of the same size as a function can match it. Within a size, the signatures
+  // keep the order of the file, so the first one listed still wins.
+  std::map<u32, std::vector<const MEGASignature*>> signatures_by_size;
+  for (const auto& sig : m_signatures)
+    signatures_by_size[static_cast<u32>(sig.code.size() * sizeof(u32))].push_back(&sig);
+
+  // Guest memory is read up front on this thread, the comparisons are done in parallel.
+  std::vector<Symbol*> symbols;
+  std::vector<std::vector<u32>> code;
   for (auto& it : symbol_db->AccessSymbols())
   {
-    auto& symbol = it.second;
-    for (const auto& sig : m_signatures)
+    Symbol& symbol = it.second;
+    if (symbol.size <= 0 || !signatures_by_size.count(static_cast<u32>(symbol.size)))
+      continue;
+
+    std::vector<u32> symbol_code(symbol.size / sizeof(u32));
+    for (size_t i = 0; i < symbol_code.size(); ++i)
+      symbol_code[i] = PowerPC::HostRead_U32(static_cast<u32>(symbol.address + i * sizeof(u32)));
+    symbols.push_back(&symbol);
+    code.push_back(std::move(symbol_code));
+  }
+
+  std::vector<const MEGASignature*> matches(symbols.size());
+  Common::ParallelFor(symbols.size(), 64, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
     {
-      if (Compare(symbol.address, symbol.size, sig))
+      for (const MEGASignature* sig : signatures_by_size.at(static_cast<u32>(symbols[i]->size)))
       {
-        symbol.name = sig.name;
-        INFO_LOG(OSHLE, "Found %s at %08x (size: %08x)!", sig.name.c_str(), symbol.address,
-                 symbol.size);
-        break;
+        if (Compare(code[i], *sig))
+        {
+          matches[i] = sig;
+          break;
+        }
       }
     }
+  });
+
+  for (size_t i = 0; i < symbols.size(); ++i)
+  {
+    if (!matches[i])
+      continue;
+
+    Symbol& symbol = *symbols[i];
+    symbol.name = matches[i]->name;
+    INFO_LOG(OSHLE, "Found %s at %08x (size: %08x)!", symbol.name.c_str(), symbol.address,
+             symbol.size);
   }
   symbol_db->Index();
 }
@@ -71,6 +71,8 @@ public:
   using FuncDB = std::map<u32, DBFunc>;
 
   static u32 ComputeCodeChecksum(u32 offsetStart, u32 offsetEnd);
+  // Adds the next instruction to a checksum computed like above, which starts out as 0.
+  static u32 UpdateCodeChecksum(u32 sum, u32 opcode);
 
   void Clear() override;
   void List() const override;
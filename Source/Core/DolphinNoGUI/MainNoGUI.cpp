@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <OptionParser.h>
+#include <algorithm>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
@@ -10,19 +11,23 @@
 #include <string>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 #include <iostream> //gvx64
 
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/FileUtil.h"
 #include "Common/Flag.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
 
 #include "Core/Analytics.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/Host.h"
 #include "Core/IOS/IOS.h"
@@ -35,6 +40,7 @@
 #include "UICommon/UICommon.h"
 
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoBackendBase.h"
 
 static bool rendererHasFocus = true;
@@ -364,8 +370,11 @@ class PlatformX11 : public Platform
 };
 #endif
 
-static Platform* GetPlatform()
+static Platform* GetPlatform(bool headless)
 {
+  if (headless)
+    return new Platform();
+
 #if defined(USE_HEADLESS)
   return new Platform();
 #elif HAVE_X11
@@ -374,9 +383,93 @@ static Platform* GetPlatform()
   return nullptr;
 }
 
+static std::string EscapeJSON(const std::string& str)
+{
+  std::string escaped;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+static u32 Percentile(const std::vector<u64>& sorted, double fraction)
+{
+  const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * fraction));
+  return static_cast<u32>(sorted[index]);
+}
+
+// Summarizes the frames recorded during a FIFO log benchmark as JSON, so that nightly runs can be
+// compared by scripts. Throughputs are relative to the time the video thread was busy.
+static bool WriteBenchmarkResults(const std::string& fifo_log, u32 loops, const std::string& path)
+{
+  const std::vector<Statistics::FrameRecord> frames = Statistics::StopFrameHistory();
+  if (frames.empty())
+  {
+    fprintf(stderr, "No frames were rendered\n");
+    return false;
+  }
+
+  std::vector<u64> frame_times;
+  u64 busy_us = 0;
+  u64 commands = 0;
+  u64 vertices = 0;
+  for (const Statistics::FrameRecord& frame : frames)
+  {
+    frame_times.push_back(frame.usGPUBusy);
+    busy_us += frame.usGPUBusy;
+    commands += frame.numCommands;
+    vertices += frame.numVertices;
+  }
+  std::sort(frame_times.begin(), frame_times.end());
+  const double busy_seconds = std::max<u64>(busy_us, 1) / 1000000.0;
+
+  const std::string json = StringFromFormat(
+      "{\n"
+      "  \"fifo_log\": \"%s\",\n"
+      "  \"video_backend\": \"%s\",\n"
+      "  \"loops\": %u,\n"
+      "  \"frames\": %u,\n"
+      "  \"gpu_time_s\": %.3f,\n"
+      "  \"gpu_frame_time_us\": {\"mean\": %.1f, \"p50\": %u, \"p90\": %u, \"p99\": %u, "
+      "\"max\": %u},\n"
+      "  \"commands_per_second\": %.0f,\n"
+      "  \"vertices_per_second\": %.0f\n"
+      "}\n",
+      EscapeJSON(fifo_log).c_str(), EscapeJSON(g_video_backend->GetName()).c_str(), loops,
+      static_cast<u32>(frames.size()), busy_seconds, static_cast<double>(busy_us) / frames.size(),
+      Percentile(frame_times, 0.5), Percentile(frame_times, 0.9), Percentile(frame_times, 0.99),
+      static_cast<u32>(frame_times.back()), commands / busy_seconds, vertices / busy_seconds);
+
+  if (path.empty())
+  {
+    fputs(json.c_str(), stdout);
+    return true;
+  }
+
+  if (!File::WriteStringToFile(json, path))
+  {
+    fprintf(stderr, "Could not write %s\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
 int main(int argc, char* argv[])
 {
   auto parser = CommandLineParse::CreateParser(CommandLineParse::ParserOptions::OmitGUIOptions);
+  parser->add_option("--benchmark")
+      .action("store")
+      .type("int")
+      .metavar("<loops>")
+      .help("Replay the FIFO log <loops> times without a window or speed limit, then print "
+            "video thread timings as JSON. Use with the Null or Software video backend");
+  parser->add_option("--benchmark-output")
+      .action("store")
+      .metavar("<file>")
+      .help("Write the benchmark results to <file> instead of stdout");
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
 
@@ -407,7 +500,22 @@ int main(int argc, char* argv[])
     user_directory = static_cast<const char*>(options.get("user"));
   }
 
-  platform = GetPlatform();
+  u32 benchmark_loops = 0;
+  std::string benchmark_output;
+  if (options.is_set("benchmark"))
+  {
+    const int loops = options.get("benchmark");
+    if (loops < 1 || !StringEndsWith(boot_filename, ".dff"))
+    {
+      fprintf(stderr, "--benchmark needs a FIFO log and a loop count of at least 1\n");
+      return 1;
+    }
+    benchmark_loops = loops;
+    if (options.is_set("benchmark_output"))
+      benchmark_output = static_cast<const char*>(options.get("benchmark_output"));
+  }
+
+  platform = GetPlatform(benchmark_loops != 0);
   if (!platform)
   {
     fprintf(stderr, "No platform found\n");
@@ -430,6 +538,13 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance()->ReportDolphinStart("nogui");
 
+  if (benchmark_loops)
+  {
+    FifoPlayer::GetInstance().SetLoopCount(benchmark_loops);
+    SConfig::GetInstance().m_EmulationSpeed = 0.0f;
+    Statistics::StartFrameHistory();
+  }
+
   if (!BootManager::BootCore(BootParameters::GenerateFromFile(boot_filename)))
   {
     fprintf(stderr, "Could not boot %s\n", boot_filename.c_str());
@@ -450,9 +565,14 @@ int main(int argc, char* argv[])
 
   Core::Shutdown();
   platform->Shutdown();
+
+  bool benchmark_succeeded = true;
+  if (benchmark_loops)
+    benchmark_succeeded = WriteBenchmarkResults(boot_filename, benchmark_loops, benchmark_output);
+
   UICommon::Shutdown();
 
   delete platform;
 
-  return 0;
+  return benchmark_succeeded ? 0 : 1;
 }
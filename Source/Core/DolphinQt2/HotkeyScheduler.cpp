@@ -155,6 +155,9 @@ void HotkeyScheduler::Run()
       if (IsHotkey(HK_SCREENSHOT))
         emit ScreenShotHotkey();
 
+      if (IsHotkey(HK_TOGGLE_TRACE))
+        Core::ToggleTraceRecording();
+
       // Exit
       if (IsHotkey(HK_EXIT))
         emit ExitHotkey();
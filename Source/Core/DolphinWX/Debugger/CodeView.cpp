@@ -385,6 +385,7 @@ void CCodeView::OnPopupMenu(wxCommandEvent& event)
       if (dialog.GetValue().ToULong(&size, 0) && size <= std::numeric_limits<u32>::max())
       {
         PPCAnalyst::ReanalyzeFunction(symbol->address, *symbol, size);
+        m_symbol_db->Index();
         Refresh();
         Host_NotifyMapLoaded();
       }
@@ -409,6 +410,7 @@ void CCodeView::OnPopupMenu(wxCommandEvent& event)
           address >= symbol->address)
       {
         PPCAnalyst::ReanalyzeFunction(symbol->address, *symbol, address - symbol->address);
+        m_symbol_db->Index();
         Refresh();
         Host_NotifyMapLoaded();
       }
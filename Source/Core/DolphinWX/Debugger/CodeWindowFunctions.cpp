@@ -39,6 +39,7 @@
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/Profiler.h"
+#include "Core/PowerPC/SamplingProfiler.h"
 #include "Core/PowerPC/SignatureDB/MEGASignatureDB.h"
 #include "Core/PowerPC/SignatureDB/SignatureDB.h"
 
@@ -160,6 +161,26 @@ void CCodeWindow::OnProfilerMenu(wxCommandEvent& event)
         wxExecute(OpenCommand, wxEXEC_SYNC);
     }
     break;
+  case IDM_SAMPLE_PROFILE:
+    if (GetParentMenuBar()->IsChecked(IDM_SAMPLE_PROFILE))
+    {
+      SamplingProfiler::Start();
+    }
+    else
+    {
+      std::string filename = File::GetUserPath(D_DUMP_IDX) + "Debug/profile.folded";
+      File::CreateFullPath(filename);
+
+      bool was_unpaused = Core::PauseAndLock(true);
+      bool success = SamplingProfiler::Stop(filename);
+      Core::PauseAndLock(false, was_unpaused);
+
+      if (success)
+        Core::DisplayMessage("Saved profile to " + filename, 4000);
+      else
+        Core::DisplayMessage("Failed to save profile to " + filename, 4000);
+    }
+    break;
   }
 }
 
@@ -457,7 +457,7 @@ void FifoPlayerDlg::OnBeginSearch(wxCommandEvent& event)
   int const frame_idx = m_framesList->GetSelection();
   FifoPlayer& player = FifoPlayer::GetInstance();
   const AnalyzedFrameInfo& frame = player.GetAnalyzedFrameInfo(frame_idx);
-  const FifoFrameInfo& fifo_frame = player.GetFile()->GetFrame(frame_idx);
+  const FifoFrameInfo fifo_frame = player.GetFile()->GetFrame(frame_idx);
 
   // TODO: Support searching through the last object... How do we know were the cmd data ends?
   // TODO: Support searching for bit patterns
@@ -621,7 +621,7 @@ void FifoPlayerDlg::OnObjectListSelectionChanged(wxCommandEvent& event)
   if (frame_idx != -1 && object_idx != -1)
   {
     const AnalyzedFrameInfo& frame = player.GetAnalyzedFrameInfo(frame_idx);
-    const FifoFrameInfo& fifo_frame = player.GetFile()->GetFrame(frame_idx);
+    const FifoFrameInfo fifo_frame = player.GetFile()->GetFrame(frame_idx);
     const u8* objectdata_start = &fifo_frame.fifoData[frame.objectStarts[object_idx]];
     const u8* objectdata_end = &fifo_frame.fifoData[frame.objectEnds[object_idx]];
     u8* objectdata = (u8*)objectdata_start;
@@ -758,7 +758,7 @@ void FifoPlayerDlg::OnObjectCmdListSelectionChanged(wxCommandEvent& event)
 
   FifoPlayer& player = FifoPlayer::GetInstance();
   const AnalyzedFrameInfo& frame = player.GetAnalyzedFrameInfo(frame_idx);
-  const FifoFrameInfo& fifo_frame = player.GetFile()->GetFrame(frame_idx);
+  const FifoFrameInfo fifo_frame = player.GetFile()->GetFrame(frame_idx);
   const u8* cmddata =
       &fifo_frame.fifoData[frame.objectStarts[object_idx]] + m_objectCmdOffsets[event.GetInt()];
 
@@ -908,9 +908,7 @@ wxString FifoPlayerDlg::CreateRecordingFifoSizeLabel() const
 
   if (file)
   {
-    size_t fifoBytes = 0;
-    for (size_t i = 0; i < file->GetFrameCount(); ++i)
-      fifoBytes += file->GetFrame(i).fifoData.size();
+    size_t fifoBytes = static_cast<size_t>(file->GetFifoDataSize());
 
     return wxString::Format(_("%zu FIFO bytes"), fifoBytes);
   }
@@ -924,13 +922,7 @@ wxString FifoPlayerDlg::CreateRecordingMemSizeLabel() const
 
   if (file)
   {
-    size_t memBytes = 0;
-    for (size_t frameNum = 0; frameNum < file->GetFrameCount(); ++frameNum)
-    {
-      const std::vector<MemoryUpdate>& memUpdates = file->GetFrame(frameNum).memoryUpdates;
-      for (const auto& memUpdate : memUpdates)
-        memBytes += memUpdate.data.size();
-    }
+    size_t memBytes = static_cast<size_t>(file->GetMemoryUpdateSize());
 
     return wxString::Format(_("%zu memory bytes"), memBytes);
   }
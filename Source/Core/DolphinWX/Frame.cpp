@@ -1328,6 +1328,8 @@ void CFrame::ParseHotkeys()
   // Screenshot hotkey
   if (IsHotkey(HK_SCREENSHOT))
     Core::SaveScreenShot();
+  if (IsHotkey(HK_TOGGLE_TRACE))
+    Core::ToggleTraceRecording();
   if (IsHotkey(HK_EXIT))
     wxPostEvent(this, wxCommandEvent(wxEVT_MENU, wxID_EXIT));
   if (IsHotkey(HK_VOLUME_DOWN))
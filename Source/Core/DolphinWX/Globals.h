@@ -246,6 +246,7 @@ enum
   // Profiler
   IDM_PROFILE_BLOCKS,
   IDM_WRITE_PROFILE,
+  IDM_SAMPLE_PROFILE,
   // --------------------------------------------------------------
 
   // --------------------------------------------------------------
@@ -51,13 +51,20 @@ ID3D11Buffer*& GeometryShaderCache::GetConstantBuffer()
   // speed this up
   if (GeometryShaderManager::dirty)
   {
-    D3D11_MAPPED_SUBRESOURCE map;
-    D3D::context->Map(gscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
-    memcpy(map.pData, &GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
-    D3D::context->Unmap(gscbuf, 0);
-    GeometryShaderManager::dirty = false;
+    if (GeometryShaderManager::upload_tracker.Update(&GeometryShaderManager::constants))
+    {
+      D3D11_MAPPED_SUBRESOURCE map;
+      D3D::context->Map(gscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
+      memcpy(map.pData, &GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
+      D3D::context->Unmap(gscbuf, 0);
 
-    ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(GeometryShaderConstants));
+      ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(GeometryShaderConstants));
+    }
+    else
+    {
+      ADDSTAT(stats.thisFrame.bytesUniformSkipped, sizeof(GeometryShaderConstants));
+    }
+    GeometryShaderManager::dirty = false;
   }
   return gscbuf;
 }
@@ -144,6 +151,7 @@ void GeometryShaderCache::Init()
   CHECK(hr == S_OK, "Create geometry shader constant buffer (size=%u)", gbsize);
   D3D::SetDebugObjectName((ID3D11DeviceChild*)gscbuf,
                           "geometry shader constant buffer used to emulate the GX pipeline");
+  GeometryShaderManager::upload_tracker.Invalidate();
 
   // used when drawing clear quads
   ClearGeometryShader = D3D::CompileAndCreateGeometryShader(clear_shader_code);
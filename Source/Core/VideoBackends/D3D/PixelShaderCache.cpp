@@ -435,13 +435,20 @@ ID3D11Buffer*& PixelShaderCache::GetConstantBuffer()
   // speed this up
   if (PixelShaderManager::dirty)
   {
-    D3D11_MAPPED_SUBRESOURCE map;
-    D3D::context->Map(pscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
-    memcpy(map.pData, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
-    D3D::context->Unmap(pscbuf, 0);
-    PixelShaderManager::dirty = false;
+    if (PixelShaderManager::upload_tracker.Update(&PixelShaderManager::constants))
+    {
+      D3D11_MAPPED_SUBRESOURCE map;
+      D3D::context->Map(pscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
+      memcpy(map.pData, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
+      D3D::context->Unmap(pscbuf, 0);
 
-    ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(PixelShaderConstants));
+      ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(PixelShaderConstants));
+    }
+    else
+    {
+      ADDSTAT(stats.thisFrame.bytesUniformSkipped, sizeof(PixelShaderConstants));
+    }
+    PixelShaderManager::dirty = false;
   }
   return pscbuf;
 }
@@ -466,6 +473,7 @@ void PixelShaderCache::Init()
   CHECK(pscbuf != nullptr, "Create pixel shader constant buffer");
   D3D::SetDebugObjectName((ID3D11DeviceChild*)pscbuf,
                           "pixel shader constant buffer used to emulate the GX pipeline");
+  PixelShaderManager::upload_tracker.Invalidate();
 
   // used when drawing clear quads
   s_ClearProgram = D3D::CompileAndCreatePixelShader(clear_program_code);
@@ -58,13 +58,20 @@ ID3D11Buffer*& VertexShaderCache::GetConstantBuffer()
   // speed this up
   if (VertexShaderManager::dirty)
   {
-    D3D11_MAPPED_SUBRESOURCE map;
-    D3D::context->Map(vscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
-    memcpy(map.pData, &VertexShaderManager::constants, sizeof(VertexShaderConstants));
-    D3D::context->Unmap(vscbuf, 0);
-    VertexShaderManager::dirty = false;
+    if (VertexShaderManager::upload_tracker.Update(&VertexShaderManager::constants))
+    {
+      D3D11_MAPPED_SUBRESOURCE map;
+      D3D::context->Map(vscbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
+      memcpy(map.pData, &VertexShaderManager::constants, sizeof(VertexShaderConstants));
+      D3D::context->Unmap(vscbuf, 0);
 
-    ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(VertexShaderConstants));
+      ADDSTAT(stats.thisFrame.bytesUniformStreamed, sizeof(VertexShaderConstants));
+    }
+    else
+    {
+      ADDSTAT(stats.thisFrame.bytesUniformSkipped, sizeof(VertexShaderConstants));
+    }
+    VertexShaderManager::dirty = false;
   }
   return vscbuf;
 }
@@ -131,6 +138,7 @@ void VertexShaderCache::Init()
   CHECK(hr == S_OK, "Create vertex shader constant buffer (size=%u)", cbsize);
   D3D::SetDebugObjectName((ID3D11DeviceChild*)vscbuf,
                           "vertex shader constant buffer used to emulate the GX pipeline");
+  VertexShaderManager::upload_tracker.Invalidate();
 
   D3DBlob* blob;
   D3D::CompileVertexShader(simple_shader_code, &blob);
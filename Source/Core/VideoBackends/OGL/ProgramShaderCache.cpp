@@ -152,6 +152,27 @@ void ProgramShaderCache::UploadConstants()
 {
   if (PixelShaderManager::dirty || VertexShaderManager::dirty || GeometryShaderManager::dirty)
   {
+    // All three blocks are bound from one mapping, so either all of them are streamed or none.
+    // Keep the current bindings if the dirty blocks were only set to the values they already had.
+    const bool pixel_changed =
+        PixelShaderManager::dirty &&
+        PixelShaderManager::upload_tracker.Update(&PixelShaderManager::constants);
+    const bool vertex_changed =
+        VertexShaderManager::dirty &&
+        VertexShaderManager::upload_tracker.Update(&VertexShaderManager::constants);
+    const bool geometry_changed =
+        GeometryShaderManager::dirty &&
+        GeometryShaderManager::upload_tracker.Update(&GeometryShaderManager::constants);
+    PixelShaderManager::dirty = false;
+    VertexShaderManager::dirty = false;
+    GeometryShaderManager::dirty = false;
+
+    if (!pixel_changed && !vertex_changed && !geometry_changed)
+    {
+      ADDSTAT(stats.thisFrame.bytesUniformSkipped, s_ubo_buffer_size);
+      return;
+    }
+
     auto buffer = s_buffer->Map(s_ubo_buffer_size, s_ubo_align);
 
     memcpy(buffer.first, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
@@ -174,10 +195,6 @@ void ProgramShaderCache::UploadConstants()
                           Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
                       sizeof(GeometryShaderConstants));
 
-    PixelShaderManager::dirty = false;
-    VertexShaderManager::dirty = false;
-    GeometryShaderManager::dirty = false;
-
     ADDSTAT(stats.thisFrame.bytesUniformStreamed, s_ubo_buffer_size);
   }
 }
@@ -505,6 +522,9 @@ void ProgramShaderCache::Init()
   // So multiply by four to get how many floats we have from vec4s
   // Then once more to get bytes
   s_buffer = StreamBuffer::Create(GL_UNIFORM_BUFFER, UBO_LENGTH);
+  PixelShaderManager::upload_tracker.Invalidate();
+  VertexShaderManager::upload_tracker.Invalidate();
+  GeometryShaderManager::upload_tracker.Invalidate();
 
   // Read our shader cache, only if supported and enabled
   if (g_ogl_config.bSupportsGLSLCache && g_ActiveConfig.bShaderCache)
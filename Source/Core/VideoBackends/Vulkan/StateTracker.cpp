@@ -360,6 +360,15 @@ void StateTracker::UpdateVertexShaderConstants()
   if (!VertexShaderManager::dirty || !ReserveConstantStorage())
     return;
 
+  // The constants may have been set to the values they already had, in which case the previous
+  // upload is still bound and can be kept.
+  if (!VertexShaderManager::upload_tracker.Update(&VertexShaderManager::constants))
+  {
+    ADDSTAT(stats.thisFrame.bytesUniformSkipped, sizeof(VertexShaderConstants));
+    VertexShaderManager::dirty = false;
+    return;
+  }
+
   // Buffer allocation changed?
   if (m_uniform_stream_buffer->GetBuffer() !=
       m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_VS].buffer)
@@ -394,11 +403,19 @@ void StateTracker::UpdateGeometryShaderConstants()
     }
 
     GeometryShaderManager::dirty = true;
+    GeometryShaderManager::upload_tracker.Invalidate();
   }
 
   if (!GeometryShaderManager::dirty || !ReserveConstantStorage())
     return;
 
+  if (!GeometryShaderManager::upload_tracker.Update(&GeometryShaderManager::constants))
+  {
+    ADDSTAT(stats.thisFrame.bytesUniformSkipped, sizeof(GeometryShaderConstants));
+    GeometryShaderManager::dirty = false;
+    return;
+  }
+
   // Buffer allocation changed?
   if (m_uniform_stream_buffer->GetBuffer() !=
       m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_GS].buffer)
@@ -424,6 +441,13 @@ void StateTracker::UpdatePixelShaderConstants()
   if (!PixelShaderManager::dirty || !ReserveConstantStorage())
     return;
 
+  if (!PixelShaderManager::upload_tracker.Update(&PixelShaderManager::constants))
+  {
+    ADDSTAT(stats.thisFrame.bytesUniformSkipped, sizeof(PixelShaderConstants));
+    PixelShaderManager::dirty = false;
+    return;
+  }
+
   // Buffer allocation changed?
   if (m_uniform_stream_buffer->GetBuffer() !=
       m_bindings.uniform_buffer_bindings[UBO_DESCRIPTOR_SET_BINDING_PS].buffer)
@@ -521,6 +545,14 @@ void StateTracker::UploadAllConstants()
   // Finally, flush buffer memory after copying
   m_uniform_stream_buffer->CommitMemory(allocation_size);
 
+  // Everything is bound from this upload now, so restart the tracking from it.
+  VertexShaderManager::upload_tracker.Invalidate();
+  VertexShaderManager::upload_tracker.Update(&VertexShaderManager::constants);
+  GeometryShaderManager::upload_tracker.Invalidate();
+  GeometryShaderManager::upload_tracker.Update(&GeometryShaderManager::constants);
+  PixelShaderManager::upload_tracker.Invalidate();
+  PixelShaderManager::upload_tracker.Update(&PixelShaderManager::constants);
+
   // Clear dirty flags
   VertexShaderManager::dirty = false;
   GeometryShaderManager::dirty = false;
@@ -612,6 +644,9 @@ void StateTracker::InvalidateConstants()
   VertexShaderManager::dirty = true;
   GeometryShaderManager::dirty = true;
   PixelShaderManager::dirty = true;
+  VertexShaderManager::upload_tracker.Invalidate();
+  GeometryShaderManager::upload_tracker.Invalidate();
+  PixelShaderManager::upload_tracker.Invalidate();
 }
 
 void StateTracker::SetPendingRebind()
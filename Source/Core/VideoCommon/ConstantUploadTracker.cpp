@@ -0,0 +1,44 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/ConstantUploadTracker.h"
+
+#include <algorithm>
+#include <cstring>
+
+ConstantUploadTracker::ConstantUploadTracker(size_t size) : m_uploaded(size), m_dirty_begin(size)
+{
+}
+
+void ConstantUploadTracker::AddDirtyRange(size_t offset, size_t size)
+{
+  m_dirty_begin = std::min(m_dirty_begin, offset);
+  m_dirty_end = std::max(m_dirty_end, std::min(offset + size, m_uploaded.size()));
+}
+
+void ConstantUploadTracker::Invalidate()
+{
+  m_valid = false;
+}
+
+bool ConstantUploadTracker::Update(const void* constants)
+{
+  const u8* const data = static_cast<const u8*>(constants);
+  size_t begin = 0;
+  size_t end = m_uploaded.size();
+  if (m_valid && m_dirty_begin < m_dirty_end)
+  {
+    begin = m_dirty_begin;
+    end = m_dirty_end;
+  }
+  m_dirty_begin = m_uploaded.size();
+  m_dirty_end = 0;
+
+  if (m_valid && std::memcmp(&m_uploaded[begin], data + begin, end - begin) == 0)
+    return false;
+
+  std::memcpy(&m_uploaded[begin], data + begin, end - begin);
+  m_valid = true;
+  return true;
+}
@@ -0,0 +1,37 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Remembers the contents of a constant block as it was last uploaded. Games often rewrite XF and
+// BP registers with the values they already hold, which marks the constants dirty without changing
+// them, so backends check with this before streaming out another copy of the block.
+//
+// The owner can narrow down which part of the block changed with AddDirtyRange, and only that part
+// is compared then. Every change has to be reported that way once one range is, as the comparison
+// falls back to the whole block only when no range was added.
+class ConstantUploadTracker
+{
+public:
+  explicit ConstantUploadTracker(size_t size);
+
+  void AddDirtyRange(size_t offset, size_t size);
+
+  // Makes the next Update report a change, e.g. when the previous upload is no longer bound.
+  void Invalidate();
+
+  // Returns true if the constants differ from the last upload, and takes them as uploaded.
+  bool Update(const void* constants);
+
+private:
+  std::vector<u8> m_uploaded;
+  size_t m_dirty_begin;
+  size_t m_dirty_end = 0;
+  bool m_valid = false;
+};
@@ -0,0 +1,286 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/DisplayListCache.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace DisplayListCache
+{
+// Cached display lists, including their converted vertices, are dropped all at once when they
+// exceed this size. Games usually settle on a working set far below it.
+constexpr size_t MAX_CACHE_SIZE = 32 * 1024 * 1024;
+
+struct Command
+{
+  u8 cmd;
+  u8 sub_cmd;     // CP register
+  u16 count;      // XF transfer size or number of vertices
+  u32 value;      // Register value, or size of the raw vertex data for draws
+  u32 offset;     // Offset of the command in the display list
+  u32 cycles;
+};
+
+struct Entry
+{
+  std::vector<u8> data;
+  std::vector<Command> commands;
+  // One per draw command, in order.
+  std::vector<VertexLoaderManager::ConvertedVertices> draws;
+  size_t size = 0;
+  bool cacheable = true;
+};
+
+static std::unordered_map<u64, Entry> s_cache;
+static size_t s_cache_size = 0;
+
+void Clear()
+{
+  s_cache.clear();
+  s_cache_size = 0;
+}
+
+static bool IsDraw(u8 cmd)
+{
+  return (cmd & 0xC0) == 0x80;
+}
+
+// Returns false if the vertex size of a draw changed since the display list was decoded.
+static bool Execute(Entry* entry, const Command& command, size_t* draw)
+{
+  u8* const data = entry->data.data() + command.offset;
+  switch (command.cmd)
+  {
+  case OpcodeDecoder::GX_LOAD_CP_REG:
+    LoadCPReg(command.sub_cmd, command.value);
+    INCSTAT(stats.thisFrame.numCPLoads);
+    break;
+
+  case OpcodeDecoder::GX_LOAD_XF_REG:
+    LoadXFReg(command.count, command.value & 0xFFFF,
+              DataReader(data + 5, data + 5 + command.count * sizeof(u32)));
+    INCSTAT(stats.thisFrame.numXFLoads);
+    break;
+
+  case OpcodeDecoder::GX_LOAD_INDX_A:
+  case OpcodeDecoder::GX_LOAD_INDX_B:
+  case OpcodeDecoder::GX_LOAD_INDX_C:
+  case OpcodeDecoder::GX_LOAD_INDX_D:
+    LoadIndexedXF(command.value, 0xC + ((command.cmd - OpcodeDecoder::GX_LOAD_INDX_A) >> 3));
+    break;
+
+  case OpcodeDecoder::GX_LOAD_BP_REG:
+    LoadBPReg(command.value);
+    INCSTAT(stats.thisFrame.numBPLoads);
+    break;
+
+  default:
+    if (IsDraw(command.cmd))
+    {
+      const int bytes = VertexLoaderManager::RunCachedVertices(
+          command.cmd & OpcodeDecoder::GX_VAT_MASK,
+          (command.cmd & OpcodeDecoder::GX_PRIMITIVE_MASK) >> OpcodeDecoder::GX_PRIMITIVE_SHIFT,
+          command.count, DataReader(data + 3, data + 3 + command.value),
+          &entry->draws[(*draw)++]);
+      if (bytes < 0)
+        return false;
+    }
+    break;
+  }
+
+  return true;
+}
+
+// Decodes the display list while executing it. Mirrors OpcodeDecoder::Run.
+static u32 Record(Entry* entry)
+{
+  u8* const start = entry->data.data();
+  u8* const end = start + entry->data.size();
+  DataReader src(start, end);
+  size_t draw = 0;
+  u32 cycles = 0;
+
+  while (src.size())
+  {
+    u8* const opcode_start = src.GetPointer();
+    Command command = {};
+    command.cmd = src.Read<u8>();
+    command.offset = static_cast<u32>(opcode_start - start);
+
+    switch (command.cmd)
+    {
+    case OpcodeDecoder::GX_NOP:
+    case OpcodeDecoder::GX_UNKNOWN_RESET:
+    case OpcodeDecoder::GX_CMD_UNKNOWN_METRICS:
+    case OpcodeDecoder::GX_CMD_INVL_VC:
+      command.cycles = 6;
+      break;
+
+    case OpcodeDecoder::GX_LOAD_CP_REG:
+      if (src.size() < 1 + 4)
+        return cycles;
+      command.sub_cmd = src.Read<u8>();
+      command.value = src.Read<u32>();
+      command.cycles = 12;
+      break;
+
+    case OpcodeDecoder::GX_LOAD_XF_REG:
+      if (src.size() < 4)
+        return cycles;
+      command.value = src.Read<u32>();
+      command.count = ((command.value >> 16) & 15) + 1;
+      if (src.size() < command.count * sizeof(u32))
+        return cycles;
+      src.Skip<u32>(command.count);
+      command.cycles = 18 + 6 * command.count;
+      break;
+
+    case OpcodeDecoder::GX_LOAD_INDX_A:
+    case OpcodeDecoder::GX_LOAD_INDX_B:
+    case OpcodeDecoder::GX_LOAD_INDX_C:
+    case OpcodeDecoder::GX_LOAD_INDX_D:
+      if (src.size() < 4)
+        return cycles;
+      command.value = src.Read<u32>();
+      command.cycles = 6;
+      break;
+
+    case OpcodeDecoder::GX_CMD_CALL_DL:
+      if (src.size() < 8)
+        return cycles;
+      src.Skip<u32>(2);
+      command.cycles = 6;
+      INFO_LOG(VIDEO, "recursive display list detected");
+      break;
+
+    case OpcodeDecoder::GX_LOAD_BP_REG:
+      if (src.size() < 4)
+        return cycles;
+      command.value = src.Read<u32>();
+      command.cycles = 12;
+      break;
+
+    default:
+      if (IsDraw(command.cmd))
+      {
+        if (src.size() < 2)
+          return cycles;
+        command.count = src.Read<u16>();
+        command.value = command.count * VertexLoaderManager::GetVertexSize(
+                                            command.cmd & OpcodeDecoder::GX_VAT_MASK);
+        if (src.size() < command.value)
+          return cycles;
+        src.Skip(command.value);
+
+        // 4 GPU ticks per vertex, 3 CPU ticks per GPU tick
+        command.cycles = command.count * 4 * 3 + 6;
+        entry->draws.emplace_back();
+      }
+      else
+      {
+        // Leave the error handling to the regular decoder, and don't try to cache this display
+        // list again until it changes.
+        u32 remaining_cycles = 0;
+        OpcodeDecoder::Run(DataReader(opcode_start, end), &remaining_cycles, true);
+        entry->cacheable = false;
+        entry->commands.clear();
+        entry->draws.clear();
+        return cycles + remaining_cycles;
+      }
+      break;
+    }
+
+    entry->commands.push_back(command);
+    Execute(entry, command, &draw);
+    cycles += command.cycles;
+  }
+
+  return cycles;
+}
+
+static u32 Replay(Entry* entry, bool* stale)
+{
+  size_t draw = 0;
+  u32 cycles = 0;
+  for (const Command& command : entry->commands)
+  {
+    if (!Execute(entry, command, &draw))
+    {
+      // The display list was decoded with a different vertex size, so the command boundaries from
+      // here on can't be trusted. Decode the rest the regular way.
+      u8* const start = entry->data.data();
+      u32 remaining_cycles = 0;
+      OpcodeDecoder::Run(DataReader(start + command.offset, start + entry->data.size()),
+                         &remaining_cycles, true);
+      *stale = true;
+      return cycles + remaining_cycles;
+    }
+    cycles += command.cycles;
+  }
+
+  return cycles;
+}
+
+bool Run(u32 address, u32 size, u8* data, u32* cycles)
+{
+  const u64 key = static_cast<u64>(address) << 32 | size;
+
+  auto iter = s_cache.find(key);
+  if (iter != s_cache.end())
+  {
+    Entry& entry = iter->second;
+    // Write tracking doesn't see every writer of RAM yet, so only the contents can tell whether
+    // the display list is still the same.
+    if (std::memcmp(entry.data.data(), data, size) == 0)
+    {
+      if (!entry.cacheable)
+        return false;
+
+      bool stale = false;
+      *cycles = Replay(&entry, &stale);
+      if (stale)
+      {
+        s_cache_size -= entry.size;
+        s_cache.erase(iter);
+      }
+      INCSTAT(stats.thisFrame.numDListsCached);
+      return true;
+    }
+
+    s_cache_size -= entry.size;
+    s_cache.erase(iter);
+  }
+
+  if (s_cache_size + size > MAX_CACHE_SIZE)
+  {
+    DEBUG_LOG(VIDEO, "Display list cache full, clearing %u entries",
+              static_cast<u32>(s_cache.size()));
+    Clear();
+  }
+
+  Entry& entry = s_cache[key];
+  entry.data.assign(data, data + size);
+  *cycles = Record(&entry);
+
+  entry.size = entry.data.size() + entry.commands.size() * sizeof(Command);
+  for (const auto& draw : entry.draws)
+    entry.size += draw.data.size();
+  s_cache_size += entry.size;
+
+  return true;
+}
+
+}  // namespace DisplayListCache
@@ -0,0 +1,19 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Keeps display lists in a pre-decoded form, so calling the same display list again doesn't need
+// to parse it, and its vertices don't need to go through the vertex loader again as long as the
+// vertex format stays the same. Cached display lists are compared against RAM on every call.
+namespace DisplayListCache
+{
+void Clear();
+
+// Executes the display list from the cache, decoding it first if it isn't cached yet or has
+// changed. Returns false without executing anything if the display list can't be cached.
+bool Run(u32 address, u32 size, u8* data, u32* cycles);
+}
@@ -2,9 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
 
+#include "Common/AdaptiveSpin.h"
 #include "Common/Assert.h"
 #include "Common/Atomic.h"
 #include "Common/BlockingLoop.h"
@@ -13,6 +19,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -38,10 +45,31 @@ static Common::BlockingLoop s_gpu_mainloop;
 
 static Common::Flag s_emu_running_state;
 
-// Most of this array is unlikely to be faulted in...
-static u8 s_fifo_aux_data[FIFO_SIZE];
+// The aux FIFO carries the memory the preprocessing pass reads on the CPU thread (display lists
+// and indexed XF loads) over to the GPU thread. It is made of blocks, so it grows when the GPU
+// thread falls behind instead of making the CPU thread wait for it. Both threads go through the
+// same sequence of sizes, so the GPU thread moves on to the next block exactly where the CPU thread
+// did.
+static constexpr size_t AUX_BLOCK_SIZE = 1024 * 1024;
+static constexpr size_t MAX_FREE_AUX_BLOCKS = 8;
+
+struct AuxBlock
+{
+  std::unique_ptr<u8[]> data;
+  size_t size;
+};
+
+// Guards the block lists. Only taken when either thread moves to another block.
+static std::mutex s_fifo_aux_lock;
+// The GPU thread reads from the front, the CPU thread writes to the back.
+static std::deque<AuxBlock> s_fifo_aux_blocks;
+static std::vector<AuxBlock> s_fifo_aux_free_blocks;
+// Owned by the CPU thread.
 static u8* s_fifo_aux_write_ptr;
+static u8* s_fifo_aux_write_end;
+// Owned by the GPU thread.
 static u8* s_fifo_aux_read_ptr;
+static u8* s_fifo_aux_read_end;
 
 // This could be in SConfig, but it depends on multiple settings
 // and can change at runtime.
@@ -54,7 +82,7 @@ static u8* s_video_buffer;
 static u8* s_video_buffer_read_ptr;
 static std::atomic<u8*> s_video_buffer_write_ptr;
 static std::atomic<u8*> s_video_buffer_seen_ptr;
-static u8* s_video_buffer_pp_read_ptr;
+static std::atomic<u8*> s_video_buffer_pp_read_ptr;
 // The read_ptr is always owned by the GPU thread.  In normal mode, so is the
 // write_ptr, despite it being atomic.  In deterministic GPU thread mode,
 // things get a bit more complicated:
@@ -63,13 +91,16 @@ static u8* s_video_buffer_pp_read_ptr;
 // caused it to stop, not the same as the read ptr.  It's written by the GPU,
 // under the lock, and updating the cond.
 // - The write_ptr is written by the CPU thread after it copies data from the
-// FIFO.  Maybe someday it will be under the lock.  For now, because RunGpuLoop
-// polls, it's just atomic.
-// - The pp_read_ptr is the CPU preprocessing version of the read_ptr.
+// FIFO.
+// - The pp_read_ptr is the CPU preprocessing version of the read_ptr.  Everything
+// before it are complete commands, whose aux data has been pushed, so the GPU
+// thread only decodes up to there.  For now, because RunGpuLoop polls, it's just
+// atomic.
 
 static std::atomic<int> s_sync_ticks;
 static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
+static Common::AdaptiveSpin s_sync_wakeup_spin;
 
 void DoState(PointerWrap& p)
 {
@@ -81,7 +112,8 @@ void DoState(PointerWrap& p)
   if (p.mode == PointerWrap::MODE_READ && s_use_deterministic_gpu_thread)
   {
     // We're good and paused, right?
-    s_video_buffer_seen_ptr = s_video_buffer_pp_read_ptr = s_video_buffer_read_ptr;
+    s_video_buffer_pp_read_ptr = s_video_buffer_read_ptr;
+    s_video_buffer_seen_ptr = s_video_buffer_read_ptr;
   }
 
   p.Do(s_sync_ticks);
@@ -130,8 +162,10 @@ void Shutdown()
   s_video_buffer_pp_read_ptr = nullptr;
   s_video_buffer_read_ptr = nullptr;
   s_video_buffer_seen_ptr = nullptr;
-  s_fifo_aux_write_ptr = nullptr;
-  s_fifo_aux_read_ptr = nullptr;
+  s_fifo_aux_blocks.clear();
+  s_fifo_aux_free_blocks.clear();
+  s_fifo_aux_write_ptr = s_fifo_aux_write_end = nullptr;
+  s_fifo_aux_read_ptr = s_fifo_aux_read_end = nullptr;
 }
 
 // May be executed from any thread, even the graphics thread.
@@ -164,50 +198,50 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
     if (!s_gpu_mainloop.IsRunning())
       return;
 
-    // Opportunistically reset FIFOs so we don't wrap around.
-    if (may_move_read_ptr && s_fifo_aux_write_ptr != s_fifo_aux_read_ptr)
-      PanicAlert("aux fifo not synced (%p, %p)", s_fifo_aux_write_ptr, s_fifo_aux_read_ptr);
-
-    memmove(s_fifo_aux_data, s_fifo_aux_read_ptr, s_fifo_aux_write_ptr - s_fifo_aux_read_ptr);
-    s_fifo_aux_write_ptr -= (s_fifo_aux_read_ptr - s_fifo_aux_data);
-    s_fifo_aux_read_ptr = s_fifo_aux_data;
-
     if (may_move_read_ptr)
     {
+      if (s_fifo_aux_write_ptr != s_fifo_aux_read_ptr)
+        PanicAlert("aux fifo not synced (%p, %p)", s_fifo_aux_write_ptr, s_fifo_aux_read_ptr);
+
+      // Opportunistically reset the FIFO so we don't wrap around.
       u8* write_ptr = s_video_buffer_write_ptr;
+      u8* pp_read_ptr = s_video_buffer_pp_read_ptr;
 
       // what's left over in the buffer
-      size_t size = write_ptr - s_video_buffer_pp_read_ptr;
+      size_t size = write_ptr - pp_read_ptr;
 
-      memmove(s_video_buffer, s_video_buffer_pp_read_ptr, size);
+      memmove(s_video_buffer, pp_read_ptr, size);
       // This change always decreases the pointers.  We write seen_ptr
-      // after write_ptr here, and read it before in RunGpuLoop, so
-      // 'write_ptr > seen_ptr' there cannot become spuriously true.
-      s_video_buffer_write_ptr = write_ptr = s_video_buffer + size;
+      // after pp_read_ptr here, and read it before in RunGpuLoop, so
+      // 'pp_read_ptr > seen_ptr' there cannot become spuriously true.
+      s_video_buffer_write_ptr = s_video_buffer + size;
       s_video_buffer_pp_read_ptr = s_video_buffer;
       s_video_buffer_read_ptr = s_video_buffer;
-      s_video_buffer_seen_ptr = write_ptr;
+      s_video_buffer_seen_ptr = s_video_buffer;
     }
   }
 }
 
 void PushFifoAuxBuffer(const void* ptr, size_t size)
 {
-  if (size > (size_t)(s_fifo_aux_data + FIFO_SIZE - s_fifo_aux_write_ptr))
+  if (size > static_cast<size_t>(s_fifo_aux_write_end - s_fifo_aux_write_ptr))
   {
-    SyncGPU(SyncGPUReason::AuxSpace, /* may_move_read_ptr */ false);
-    if (!s_gpu_mainloop.IsRunning())
+    std::lock_guard<std::mutex> lk(s_fifo_aux_lock);
+    AuxBlock block;
+    if (size <= AUX_BLOCK_SIZE && !s_fifo_aux_free_blocks.empty())
     {
-      // GPU is shutting down
-      return;
+      block = std::move(s_fifo_aux_free_blocks.back());
+      s_fifo_aux_free_blocks.pop_back();
     }
-    if (size > (size_t)(s_fifo_aux_data + FIFO_SIZE - s_fifo_aux_write_ptr))
+    else
     {
-      // That will sync us up to the last 32 bytes, so this short region
-      // of FIFO would have to point to a 2MB display list or something.
-      PanicAlert("absurdly large aux buffer");
-      return;
+      // Display lists larger than a block get a block of their own.
+      block.size = std::max(size, AUX_BLOCK_SIZE);
+      block.data = std::make_unique<u8[]>(block.size);
     }
+    s_fifo_aux_write_ptr = block.data.get();
+    s_fifo_aux_write_end = s_fifo_aux_write_ptr + block.size;
+    s_fifo_aux_blocks.push_back(std::move(block));
   }
   memcpy(s_fifo_aux_write_ptr, ptr, size);
   s_fifo_aux_write_ptr += size;
@@ -215,11 +249,32 @@ void PushFifoAuxBuffer(const void* ptr, size_t size)
 
 void* PopFifoAuxBuffer(size_t size)
 {
+  if (size > static_cast<size_t>(s_fifo_aux_read_end - s_fifo_aux_read_ptr))
+  {
+    std::lock_guard<std::mutex> lk(s_fifo_aux_lock);
+    // The front block is the one we've been reading from, unless this is the first pop.
+    if (s_fifo_aux_read_ptr)
+    {
+      AuxBlock& block = s_fifo_aux_blocks.front();
+      if (block.size == AUX_BLOCK_SIZE && s_fifo_aux_free_blocks.size() < MAX_FREE_AUX_BLOCKS)
+        s_fifo_aux_free_blocks.push_back(std::move(block));
+      s_fifo_aux_blocks.pop_front();
+    }
+    s_fifo_aux_read_ptr = s_fifo_aux_blocks.front().data.get();
+    s_fifo_aux_read_end = s_fifo_aux_read_ptr + s_fifo_aux_blocks.front().size;
+  }
   void* ret = s_fifo_aux_read_ptr;
   s_fifo_aux_read_ptr += size;
   return ret;
 }
 
+// Wakes up the CPU thread if it waits for the GPU thread to catch up in WaitForGpuThread.
+static void WakeupCpuThread()
+{
+  s_sync_wakeup_spin.Notify();
+  s_sync_wakeup_event.Set();
+}
+
 // Description: RunGpuLoop() sends data through this function.
 static void ReadDataFromFifo(u32 readPtr)
 {
@@ -271,10 +326,10 @@ static void ReadDataFromFifoOnCPU(u32 readPtr)
     }
   }
   Memory::CopyFromEmu(s_video_buffer_write_ptr, readPtr, len);
+  s_video_buffer_write_ptr = write_ptr + len;
+  // This would have to be locked if the GPU thread didn't spin.
   s_video_buffer_pp_read_ptr = OpcodeDecoder::Run<true>(
       DataReader(s_video_buffer_pp_read_ptr, write_ptr + len), nullptr, false);
-  // This would have to be locked if the GPU thread didn't spin.
-  s_video_buffer_write_ptr = write_ptr + len;
 }
 
 void ResetVideoBuffer()
@@ -283,8 +338,16 @@ void ResetVideoBuffer()
   s_video_buffer_write_ptr = s_video_buffer;
   s_video_buffer_seen_ptr = s_video_buffer;
   s_video_buffer_pp_read_ptr = s_video_buffer;
-  s_fifo_aux_write_ptr = s_fifo_aux_data;
-  s_fifo_aux_read_ptr = s_fifo_aux_data;
+
+  std::lock_guard<std::mutex> lk(s_fifo_aux_lock);
+  for (AuxBlock& block : s_fifo_aux_blocks)
+  {
+    if (block.size == AUX_BLOCK_SIZE && s_fifo_aux_free_blocks.size() < MAX_FREE_AUX_BLOCKS)
+      s_fifo_aux_free_blocks.push_back(std::move(block));
+  }
+  s_fifo_aux_blocks.clear();
+  s_fifo_aux_write_ptr = s_fifo_aux_write_end = nullptr;
+  s_fifo_aux_read_ptr = s_fifo_aux_read_end = nullptr;
 }
 
 // Description: Main FIFO update loop
@@ -308,20 +371,24 @@ void RunGpuLoop()
         {
           AsyncRequests::GetInstance()->PullEvents();
 
-          // All the fifo/CP stuff is on the CPU.  We just need to run the opcode decoder.
+          // All the fifo/CP stuff is on the CPU.  We just need to run the opcode decoder on
+          // the commands the CPU has already preprocessed, so we never wake up for a partial
+          // command.
           u8* seen_ptr = s_video_buffer_seen_ptr;
-          u8* write_ptr = s_video_buffer_write_ptr;
+          u8* pp_read_ptr = s_video_buffer_pp_read_ptr;
           // See comment in SyncGPU
-          if (write_ptr > seen_ptr)
+          if (pp_read_ptr > seen_ptr)
           {
-            s_video_buffer_read_ptr =
-                OpcodeDecoder::Run(DataReader(s_video_buffer_read_ptr, write_ptr), nullptr, false);
-            s_video_buffer_seen_ptr = write_ptr;
+            TRACE_ZONE("Fifo::RunGpuLoop");
+            s_video_buffer_read_ptr = OpcodeDecoder::Run(
+                DataReader(s_video_buffer_read_ptr, pp_read_ptr), nullptr, false);
+            s_video_buffer_seen_ptr = pp_read_ptr;
           }
         }
         else
         {
           CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
+          TRACE_ZONE_IF("Fifo::RunGpuLoop", fifo.CPReadWriteDistance != 0);
 
           AsyncRequests::GetInstance()->PullEvents();
 
@@ -365,7 +432,7 @@ void RunGpuLoop()
               int old = s_sync_ticks.fetch_sub(cyclesExecuted);
               if (old >= param.iSyncGpuMaxDistance &&
                   old - (int)cyclesExecuted < param.iSyncGpuMaxDistance)
-                s_sync_wakeup_event.Set();
+                WakeupCpuThread();
             }
 
             // This call is pretty important in DualCore mode and must be called in the FIFO Loop.
@@ -380,7 +447,7 @@ void RunGpuLoop()
           {
             int old = s_sync_ticks.exchange(0);
             if (old >= param.iSyncGpuMaxDistance)
-              s_sync_wakeup_event.Set();
+              WakeupCpuThread();
           }
 
           // The fifo is empty and it's unlikely we will get any more work in the near future.
@@ -409,6 +476,12 @@ void GpuMaySleep()
   s_gpu_mainloop.AllowSleep();
 }
 
+void TakeWaitTimes(u64* cpu_waiting_for_gpu, u64* gpu_waiting_for_cpu)
+{
+  *cpu_waiting_for_gpu = s_gpu_mainloop.TakeWaitTime() + s_sync_wakeup_spin.TakeWaitTime();
+  *gpu_waiting_for_cpu = s_gpu_mainloop.TakeWorkerWaitTime();
+}
+
 bool AtBreakpoint()
 {
   CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
@@ -518,7 +591,8 @@ void UpdateWantDeterminism(bool want)
     if (gpu_thread)
     {
       // These haven't been updated in non-deterministic mode.
-      s_video_buffer_seen_ptr = s_video_buffer_pp_read_ptr = s_video_buffer_read_ptr;
+      s_video_buffer_pp_read_ptr = s_video_buffer_read_ptr;
+      s_video_buffer_seen_ptr = s_video_buffer_read_ptr;
       CopyPreprocessCPStateFromMain();
       VertexLoaderManager::MarkAllDirty();
     }
@@ -554,9 +628,13 @@ static int WaitForGpuThread(int ticks)
   if (now < param.iSyncGpuMinDistance)
     return GPU_TIME_SLOT_SIZE + param.iSyncGpuMinDistance - now;
 
-  // Wait for GPU
-  if (now >= param.iSyncGpuMaxDistance)
-    s_sync_wakeup_event.Wait();
+  // Wait for GPU. If the spin sees the GPU catching up, the event may still get set afterwards,
+  // which lets a later wait return early. That's harmless, the event is also set when nobody waits.
+  if (now >= param.iSyncGpuMaxDistance &&
+      !s_sync_wakeup_spin.Spin([&] { return s_sync_ticks.load() < param.iSyncGpuMaxDistance; }))
+  {
+    s_sync_wakeup_spin.Block([] { s_sync_wakeup_event.Wait(); });
+  }
 
   return GPU_TIME_SLOT_SIZE;
 }
@@ -28,7 +28,6 @@ enum class SyncGPUReason
   PerfQuery,
   BBox,
   Swap,
-  AuxSpace,
 };
 // In deterministic GPU thread mode this waits for the GPU to be done with pending work.
 void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr = true);
@@ -39,6 +38,9 @@ void* PopFifoAuxBuffer(size_t size);
 void FlushGpu();
 void RunGpu();
 void GpuMaySleep();
+// Returns the time in microseconds the CPU thread spent waiting for the GPU thread and the other
+// way around since the last call, in dual core mode.
+void TakeWaitTimes(u64* cpu_waiting_for_gpu, u64* gpu_waiting_for_cpu);
 void RunGpuLoop();
 void ExitGpuLoop();
 void EmulatorState(bool running);
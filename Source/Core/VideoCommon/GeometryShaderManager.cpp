@@ -15,6 +15,7 @@ static const int LINE_PT_TEX_OFFSETS[8] = {0, 16, 8, 4, 2, 1, 1, 1};
 
 GeometryShaderConstants GeometryShaderManager::constants;
 bool GeometryShaderManager::dirty;
+ConstantUploadTracker GeometryShaderManager::upload_tracker(sizeof(GeometryShaderConstants));
 
 static bool s_projection_changed;
 static bool s_viewport_changed;
@@ -28,6 +29,7 @@ void GeometryShaderManager::Init()
   SetProjectionChanged();
 
   dirty = true;
+  upload_tracker.Invalidate();
 }
 
 void GeometryShaderManager::Dirty()
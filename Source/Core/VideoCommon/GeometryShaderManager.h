@@ -6,6 +6,7 @@
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/ConstantManager.h"
+#include "VideoCommon/ConstantUploadTracker.h"
 
 class PointerWrap;
 
@@ -25,4 +26,5 @@ public:
 
   static GeometryShaderConstants constants;
   static bool dirty;
+  static ConstantUploadTracker upload_tracker;
 };
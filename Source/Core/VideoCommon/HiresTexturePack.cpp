@@ -0,0 +1,441 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/HiresTexturePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Common/Align.h"
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Swap.h"
+#include "VideoCommon/AbstractTexture.h"
+
+// File layout (all values in the byte order of the host which wrote the pack, so the tables can be
+// used in place; the magic tells whether it matches):
+//
+//   Header
+//   Level data, each level aligned to PACK_DATA_ALIGNMENT
+//   TextureRecord[texture_count], sorted by name
+//   LevelRecord[level_count]
+//   Names, not null terminated
+//
+// Texture data is stored exactly as it is uploaded: RGBA8 or the block compressed formats taken
+// over from DDS files. Nothing needs to be decoded when loading from a pack.
+
+constexpr u32 PACK_MAGIC = 0x4B505444;  // "DTPK"
+constexpr u32 PACK_VERSION = 1;
+constexpr u64 PACK_DATA_ALIGNMENT = 64;
+constexpr u64 PACK_TABLE_ALIGNMENT = 16;
+
+struct HiresTexturePack::Header
+{
+  u32 magic;
+  u32 version;
+  u32 texture_count;
+  u32 level_count;
+  u64 textures_offset;
+  u64 levels_offset;
+  u64 names_offset;
+  u64 names_size;
+  u8 reserved[16];
+};
+
+struct HiresTexturePack::TextureRecord
+{
+  u32 name_offset;
+  u32 name_length;
+  u32 first_level;
+  u32 level_count;
+};
+
+struct HiresTexturePack::LevelRecord
+{
+  u32 format;
+  u32 width;
+  u32 height;
+  u32 row_length;
+  u64 data_offset;
+  u64 data_size;
+};
+
+// The on-disk format values are fixed, independent of the AbstractTextureFormat enum.
+static bool FormatFromPack(u32 value, AbstractTextureFormat* format)
+{
+  switch (value)
+  {
+  case 0:
+    *format = AbstractTextureFormat::RGBA8;
+    return true;
+  case 1:
+    *format = AbstractTextureFormat::DXT1;
+    return true;
+  case 2:
+    *format = AbstractTextureFormat::DXT3;
+    return true;
+  case 3:
+    *format = AbstractTextureFormat::DXT5;
+    return true;
+  default:
+    return false;
+  }
+}
+
+static u32 FormatToPack(AbstractTextureFormat format)
+{
+  switch (format)
+  {
+  case AbstractTextureFormat::DXT1:
+    return 1;
+  case AbstractTextureFormat::DXT3:
+    return 2;
+  case AbstractTextureFormat::DXT5:
+    return 3;
+  case AbstractTextureFormat::RGBA8:
+  default:
+    return 0;
+  }
+}
+
+static bool RangeInFile(u64 offset, u64 size, size_t file_size)
+{
+  return offset <= file_size && size <= file_size - offset;
+}
+
+// Whether data_size bytes hold all of a level with the given dimensions. Block compressed formats
+// store rows of 4x4 blocks, and row_length is in pixels for all formats.
+static bool IsLevelSizeValid(AbstractTextureFormat format, u32 width, u32 height, u32 row_length,
+                             u64 data_size)
+{
+  if (width == 0 || height == 0 || row_length < width)
+    return false;
+
+  u64 rows = height;
+  if (AbstractTexture::IsCompressedHostTextureFormat(format))
+    rows = (rows + 3) / 4;
+
+  const u64 pitch = AbstractTexture::CalculateHostTextureLevelPitch(format, row_length);
+  return data_size >= pitch * rows;
+}
+
+std::shared_ptr<HiresTexturePack> HiresTexturePack::Open(const std::string& path)
+{
+  // Can't use make_shared due to private constructor.
+  std::shared_ptr<HiresTexturePack> pack(new HiresTexturePack());
+  if (!pack->Map(path))
+    return nullptr;
+
+  if (!pack->ValidateIndex())
+  {
+    ERROR_LOG(VIDEO, "Custom texture pack %s is invalid", path.c_str());
+    return nullptr;
+  }
+
+  return pack;
+}
+
+#ifdef _WIN32
+
+bool HiresTexturePack::Map(const std::string& path)
+{
+  HANDLE file = CreateFile(UTF8ToTStr(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  m_file_handle = file;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    return false;
+
+  HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+    return false;
+  m_mapping_handle = mapping;
+
+  m_base = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  m_size = static_cast<size_t>(size.QuadPart);
+  return m_base != nullptr;
+}
+
+HiresTexturePack::~HiresTexturePack()
+{
+  if (m_base)
+    UnmapViewOfFile(m_base);
+  if (m_mapping_handle)
+    CloseHandle(m_mapping_handle);
+  if (m_file_handle)
+    CloseHandle(m_file_handle);
+}
+
+#else
+
+bool HiresTexturePack::Map(const std::string& path)
+{
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return false;
+
+  m_base = static_cast<const u8*>(base);
+  m_size = static_cast<size_t>(st.st_size);
+  return true;
+}
+
+HiresTexturePack::~HiresTexturePack()
+{
+  if (m_base)
+    munmap(const_cast<u8*>(m_base), m_size);
+}
+
+#endif
+
+bool HiresTexturePack::ValidateIndex()
+{
+  static_assert(sizeof(Header) == 64, "Header must be 64 bytes");
+  static_assert(sizeof(TextureRecord) == 16, "TextureRecord must be 16 bytes");
+  static_assert(sizeof(LevelRecord) == 32, "LevelRecord must be 32 bytes");
+
+  if (m_size < sizeof(Header))
+    return false;
+
+  Header header;
+  std::memcpy(&header, m_base, sizeof(header));
+  if (header.magic == Common::swap32(PACK_MAGIC))
+  {
+    ERROR_LOG(VIDEO, "Custom texture pack was written on a host with a different byte order");
+    return false;
+  }
+  if (header.magic != PACK_MAGIC || header.version != PACK_VERSION)
+    return false;
+
+  if (header.textures_offset % PACK_TABLE_ALIGNMENT || header.levels_offset % PACK_TABLE_ALIGNMENT)
+    return false;
+
+  if (!RangeInFile(header.textures_offset, u64(header.texture_count) * sizeof(TextureRecord),
+                   m_size) ||
+      !RangeInFile(header.levels_offset, u64(header.level_count) * sizeof(LevelRecord), m_size) ||
+      !RangeInFile(header.names_offset, header.names_size, m_size))
+  {
+    return false;
+  }
+
+  m_textures = reinterpret_cast<const TextureRecord*>(m_base + header.textures_offset);
+  m_levels = reinterpret_cast<const LevelRecord*>(m_base + header.levels_offset);
+  m_names = reinterpret_cast<const char*>(m_base + header.names_offset);
+  m_texture_count = header.texture_count;
+  m_level_count = header.level_count;
+  m_names_size = static_cast<size_t>(header.names_size);
+
+  // Check the tables once here, so lookups don't need to.
+  for (size_t i = 0; i < m_texture_count; i++)
+  {
+    const TextureRecord& texture = m_textures[i];
+    if (!RangeInFile(texture.name_offset, texture.name_length, m_names_size) ||
+        !RangeInFile(texture.first_level, texture.level_count, m_level_count) ||
+        texture.level_count == 0)
+    {
+      return false;
+    }
+    if (i > 0 && GetName(m_textures[i - 1]) >= GetName(texture))
+      return false;
+  }
+
+  for (size_t i = 0; i < m_level_count; i++)
+  {
+    const LevelRecord& level = m_levels[i];
+    AbstractTextureFormat format;
+    if (!FormatFromPack(level.format, &format) ||
+        !RangeInFile(level.data_offset, level.data_size, m_size) ||
+        !IsLevelSizeValid(format, level.width, level.height, level.row_length, level.data_size))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string HiresTexturePack::GetName(const TextureRecord& record) const
+{
+  return std::string(m_names + record.name_offset, record.name_length);
+}
+
+std::string HiresTexturePack::GetTextureName(size_t index) const
+{
+  return GetName(m_textures[index]);
+}
+
+const HiresTexturePack::TextureRecord*
+HiresTexturePack::FindTexture(const std::string& name) const
+{
+  const TextureRecord* end = m_textures + m_texture_count;
+  const TextureRecord* iter =
+      std::lower_bound(m_textures, end, name, [this](const TextureRecord& record,
+                                                     const std::string& value) {
+        const size_t length = std::min<size_t>(record.name_length, value.size());
+        const int result = std::memcmp(m_names + record.name_offset, value.data(), length);
+        return result < 0 || (result == 0 && record.name_length < value.size());
+      });
+
+  if (iter == end || iter->name_length != name.size() ||
+      std::memcmp(m_names + iter->name_offset, name.data(), name.size()) != 0)
+  {
+    return nullptr;
+  }
+
+  return iter;
+}
+
+bool HiresTexturePack::Contains(const std::string& name) const
+{
+  return FindTexture(name) != nullptr;
+}
+
+bool HiresTexturePack::GetLevels(const std::string& name, std::vector<Level>* levels) const
+{
+  const TextureRecord* texture = FindTexture(name);
+  if (!texture)
+    return false;
+
+  levels->clear();
+  for (u32 i = 0; i < texture->level_count; i++)
+  {
+    const LevelRecord& record = m_levels[texture->first_level + i];
+    Level level;
+    FormatFromPack(record.format, &level.format);
+    level.width = record.width;
+    level.height = record.height;
+    level.row_length = record.row_length;
+    level.data = m_base + record.data_offset;
+    level.data_size = static_cast<size_t>(record.data_size);
+    levels->push_back(level);
+  }
+
+  return true;
+}
+
+HiresTexturePack::Writer::Writer(const std::string& path) : m_file(path, "wb")
+{
+  // The header is written last, once all offsets are known.
+  const Header header = {};
+  m_file.WriteBytes(&header, sizeof(header));
+}
+
+static bool PadTo(File::IOFile& file, u64 alignment)
+{
+  static const u8 zeroes[PACK_DATA_ALIGNMENT] = {};
+  const u64 position = file.Tell();
+  const u64 padding = Common::AlignUp(position, alignment) - position;
+  return file.WriteBytes(zeroes, static_cast<size_t>(padding));
+}
+
+bool HiresTexturePack::Writer::AddTexture(const std::string& name,
+                                          const std::vector<Level>& levels)
+{
+  if (levels.empty())
+    return false;
+
+  for (const Level& level : levels)
+  {
+    if (!IsLevelSizeValid(level.format, level.width, level.height, level.row_length,
+                          level.data_size))
+    {
+      return false;
+    }
+  }
+
+  m_textures.push_back({name, static_cast<u32>(m_levels.size()), static_cast<u32>(levels.size())});
+  for (const Level& level : levels)
+  {
+    if (!PadTo(m_file, PACK_DATA_ALIGNMENT))
+      return false;
+
+    LevelEntry entry = {level, m_file.Tell()};
+    entry.level.data = nullptr;
+    if (!m_file.WriteBytes(level.data, level.data_size))
+      return false;
+
+    m_levels.push_back(entry);
+  }
+
+  return true;
+}
+
+bool HiresTexturePack::Writer::Finish()
+{
+  std::sort(m_textures.begin(), m_textures.end(),
+            [](const TextureEntry& a, const TextureEntry& b) { return a.name < b.name; });
+  m_textures.erase(std::unique(m_textures.begin(), m_textures.end(),
+                               [](const TextureEntry& a, const TextureEntry& b) {
+                                 return a.name == b.name;
+                               }),
+                   m_textures.end());
+
+  Header header = {};
+  header.magic = PACK_MAGIC;
+  header.version = PACK_VERSION;
+  header.texture_count = static_cast<u32>(m_textures.size());
+  header.level_count = static_cast<u32>(m_levels.size());
+
+  std::string names;
+  if (!PadTo(m_file, PACK_TABLE_ALIGNMENT))
+    return false;
+  header.textures_offset = m_file.Tell();
+  for (const TextureEntry& texture : m_textures)
+  {
+    const TextureRecord record = {static_cast<u32>(names.size()),
+                                  static_cast<u32>(texture.name.size()), texture.first_level,
+                                  texture.level_count};
+    names += texture.name;
+    if (!m_file.WriteBytes(&record, sizeof(record)))
+      return false;
+  }
+
+  header.levels_offset = m_file.Tell();
+  for (const LevelEntry& entry : m_levels)
+  {
+    const LevelRecord record = {FormatToPack(entry.level.format), entry.level.width,
+                                entry.level.height, entry.level.row_length, entry.data_offset,
+                                entry.level.data_size};
+    if (!m_file.WriteBytes(&record, sizeof(record)))
+      return false;
+  }
+
+  header.names_offset = m_file.Tell();
+  header.names_size = names.size();
+  if (!m_file.WriteBytes(names.data(), names.size()))
+    return false;
+
+  if (!m_file.Seek(0, SEEK_SET) || !m_file.WriteBytes(&header, sizeof(header)))
+    return false;
+
+  return m_file.Close();
+}
@@ -0,0 +1,93 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "VideoCommon/TextureConfig.h"
+
+// A whole custom texture pack in a single file, indexed by the names generated by
+// HiresTexture::GenBaseName. Packs are memory mapped and the texture data is used in place, so
+// opening one costs a single file open, and only the textures a game actually uses are paged in.
+class HiresTexturePack
+{
+public:
+  struct Level
+  {
+    AbstractTextureFormat format;
+    u32 width;
+    u32 height;
+    u32 row_length;
+    const u8* data;
+    size_t data_size;
+  };
+
+  static std::shared_ptr<HiresTexturePack> Open(const std::string& path);
+  ~HiresTexturePack();
+
+  size_t GetTextureCount() const { return m_texture_count; }
+  std::string GetTextureName(size_t index) const;
+
+  bool Contains(const std::string& name) const;
+  bool GetLevels(const std::string& name, std::vector<Level>* levels) const;
+
+  // Builds a pack. Texture data is written out as it is added, only the index is kept in memory.
+  class Writer
+  {
+  public:
+    explicit Writer(const std::string& path);
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    bool AddTexture(const std::string& name, const std::vector<Level>& levels);
+    bool Finish();
+
+  private:
+    struct TextureEntry
+    {
+      std::string name;
+      u32 first_level;
+      u32 level_count;
+    };
+    struct LevelEntry
+    {
+      Level level;
+      u64 data_offset;
+    };
+
+    File::IOFile m_file;
+    std::vector<TextureEntry> m_textures;
+    std::vector<LevelEntry> m_levels;
+  };
+
+private:
+  struct Header;
+  struct TextureRecord;
+  struct LevelRecord;
+
+  HiresTexturePack() = default;
+
+  bool Map(const std::string& path);
+  bool ValidateIndex();
+  const TextureRecord* FindTexture(const std::string& name) const;
+  std::string GetName(const TextureRecord& record) const;
+
+  const u8* m_base = nullptr;
+  size_t m_size = 0;
+  const TextureRecord* m_textures = nullptr;
+  const LevelRecord* m_levels = nullptr;
+  const char* m_names = nullptr;
+  size_t m_texture_count = 0;
+  size_t m_level_count = 0;
+  size_t m_names_size = 0;
+#ifdef _WIN32
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+#endif
+};
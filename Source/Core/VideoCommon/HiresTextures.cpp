@@ -6,13 +6,20 @@
 
 #include <SOIL/SOIL.h>
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <png.h>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
@@ -20,7 +27,6 @@
 #include "Common/File.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
-#include "Common/Flag.h"
 #include "Common/Hash.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
@@ -28,27 +34,142 @@
 #include "Common/Swap.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
-#include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
+#include "VideoCommon/HiresTexturePack.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
 
+namespace
+{
+struct LoadRequest
+{
+  std::string base_filename;
+  std::vector<std::string> level_filenames;
+  u32 width;
+  u32 height;
+  bool prefetch;
+};
+
+struct ResidentTexture
+{
+  std::shared_ptr<HiresTexture> texture;
+  size_t size;
+  std::list<std::string>::iterator lru_iter;
+};
+
+struct LoaderStatistics
+{
+  u32 textures_loaded = 0;
+  u32 load_failures = 0;
+  u32 on_demand_loads = 0;
+  u32 evictions = 0;
+  u64 bytes_loaded = 0;
+  u64 load_time_us = 0;
+};
+}  // Anonymous namespace
+
 static std::unordered_map<std::string, std::string> s_textureMap;
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
-static std::mutex s_textureCacheMutex;
-static std::mutex s_textureCacheAquireMutex;  // for high priority access
-static Common::Flag s_textureCacheAbortLoading;
+static std::shared_ptr<HiresTexturePack> s_pack;
 static bool s_check_native_format;
 static bool s_check_new_format;
 
-static std::thread s_prefetcher;
+// The resident set and the load queue are shared with the loader threads, and are protected by
+// s_textureCacheMutex. The least recently used textures are evicted once s_memory_budget is
+// exceeded.
+static std::mutex s_textureCacheMutex;
+static std::condition_variable s_load_queue_cond;
+static std::unordered_map<std::string, ResidentTexture> s_textureCache;
+static std::list<std::string> s_lru;  // Most recently used first.
+static std::deque<LoadRequest> s_load_queue;
+static std::unordered_set<std::string> s_pending;  // Queued on-demand loads.
+static std::unordered_set<std::string> s_failed;
+static size_t s_resident_size;
+static size_t s_memory_budget;
+static u32 s_prefetch_remaining;
+static u32 s_prefetch_start_time;
+static LoaderStatistics s_stats;
+static bool s_loaders_exit;
+
+static std::vector<std::thread> s_loaders;
+static std::atomic<u32> s_load_generation{0};
+
+// SOIL is not thread safe. It is only used for the legacy formats, PNG and DDS are decoded
+// directly.
+static std::mutex s_soil_mutex;
 
 static const std::string s_format_prefix = "tex1_";
+static const std::string s_pack_extension = ".dtp";
+static const std::vector<std::string> s_extensions = {
+    ".png", ".bmp", ".tga", ".dds",
+    ".jpg"  // Why not? Could be useful for large photo-like textures
+};
+
+// Loose files take priority over the pack, so single textures can be overridden.
+static bool HasTexture(const std::string& name)
+{
+  return s_textureMap.find(name) != s_textureMap.end() || (s_pack && s_pack->Contains(name));
+}
 
 HiresTexture::Level::Level() : data(nullptr, SOIL_free_image_data)
 {
 }
 
+static void ClearResidentTextures()
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+  s_textureCache.clear();
+  s_lru.clear();
+  s_resident_size = 0;
+}
+
+static void EvictLeastRecentlyUsed()
+{
+  auto iter = s_textureCache.find(s_lru.back());
+  s_resident_size -= iter->second.size;
+  s_textureCache.erase(iter);
+  s_lru.pop_back();
+  s_stats.evictions++;
+}
+
+static void MakeResident(const std::string& base_filename, std::shared_ptr<HiresTexture> texture,
+                         size_t size)
+{
+  if (s_textureCache.count(base_filename))
+    return;
+
+  while (!s_lru.empty() && s_resident_size + size > s_memory_budget)
+    EvictLeastRecentlyUsed();
+
+  s_lru.push_front(base_filename);
+  s_textureCache.emplace(base_filename, ResidentTexture{std::move(texture), size, s_lru.begin()});
+  s_resident_size += size;
+  s_load_generation++;
+}
+
+static void FinishPrefetch(bool budget_exceeded)
+{
+  const double size_mb = s_resident_size / (1024.0 * 1024.0);
+  if (budget_exceeded)
+  {
+    // Drop the remaining prefetch requests, they will be loaded on demand instead.
+    s_load_queue.erase(std::remove_if(s_load_queue.begin(), s_load_queue.end(),
+                                      [](const LoadRequest& request) { return request.prefetch; }),
+                       s_load_queue.end());
+    s_prefetch_remaining = 0;
+
+    OSD::AddMessage(StringFromFormat("Custom Textures prefetching stopped after %.1f MB, "
+                                     "remaining textures are loaded on demand",
+                                     size_mb),
+                    10000);
+    return;
+  }
+
+  const u32 stoptime = Common::Timer::GetTimeMs();
+  OSD::AddMessage(StringFromFormat("Custom Textures loaded, %.1f MB in %.1f s", size_mb,
+                                   (stoptime - s_prefetch_start_time) / 1000.0),
+                  10000);
+}
+
 void HiresTexture::Init()
 {
   s_check_native_format = false;
@@ -59,47 +180,60 @@ void HiresTexture::Init()
 
 void HiresTexture::Shutdown()
 {
-  if (s_prefetcher.joinable())
+  StopLoaders();
+
+  if (s_stats.textures_loaded || s_stats.load_failures)
   {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
+    INFO_LOG(VIDEO, "Custom textures: %u loaded (%u on demand, %u failed), %.1f MB in %.1f s of "
+                    "decode time, %u evicted",
+             s_stats.textures_loaded, s_stats.on_demand_loads, s_stats.load_failures,
+             s_stats.bytes_loaded / (1024.0 * 1024.0), s_stats.load_time_us / 1000000.0,
+             s_stats.evictions);
   }
+  s_stats = {};
 
   s_textureMap.clear();
-  s_textureCache.clear();
+  ClearResidentTextures();
+  s_pack.reset();
 }
 
 void HiresTexture::Update()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  StopLoaders();
 
   if (!g_ActiveConfig.bHiresTextures)
   {
     s_textureMap.clear();
-    s_textureCache.clear();
+    ClearResidentTextures();
+    s_pack.reset();
     return;
   }
 
   if (!g_ActiveConfig.bCacheHiresTextures)
   {
-    s_textureCache.clear();
+    ClearResidentTextures();
   }
 
   const std::string& game_id = SConfig::GetInstance().GetGameID();
-  const std::string texture_directory = GetTextureDirectory(game_id);
-  std::vector<std::string> extensions{
-      ".png", ".bmp", ".tga", ".dds",
-      ".jpg"  // Why not? Could be useful for large photo-like textures
-  };
+  const std::string code = game_id + "_";
 
-  std::vector<std::string> filenames =
-      Common::DoFileSearch({texture_directory}, extensions, /*recursive*/ true);
+  s_pack = HiresTexturePack::Open(GetTexturePackPath(game_id));
+  if (s_pack)
+  {
+    for (size_t i = 0; i < s_pack->GetTextureCount(); i++)
+    {
+      const std::string name = s_pack->GetTextureName(i);
+      if (name.compare(0, code.length(), code) == 0)
+        s_check_native_format = true;
+      if (name.compare(0, s_format_prefix.length(), s_format_prefix) == 0)
+        s_check_new_format = true;
+    }
+    INFO_LOG(VIDEO, "Using custom texture pack with %zu textures", s_pack->GetTextureCount());
+  }
 
-  const std::string code = game_id + "_";
+  const std::string texture_directory = GetTextureDirectory(game_id);
+  std::vector<std::string> filenames =
+      Common::DoFileSearch({texture_directory}, s_extensions, /*recursive*/ true);
 
   for (auto& rFilename : filenames)
   {
@@ -119,14 +253,16 @@ void HiresTexture::Update()
     }
   }
 
-  if (g_ActiveConfig.bCacheHiresTextures)
+  // remove cached but deleted textures
   {
-    // remove cached but deleted textures
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
     auto iter = s_textureCache.begin();
     while (iter != s_textureCache.end())
     {
       if (s_textureMap.find(iter->first) == s_textureMap.end())
       {
+        s_resident_size -= iter->second.size;
+        s_lru.erase(iter->second.lru_iter);
         iter = s_textureCache.erase(iter);
       }
       else
@@ -135,83 +271,126 @@ void HiresTexture::Update()
       }
     }
 
-    s_textureCacheAbortLoading.Clear();
-    s_prefetcher = std::thread(Prefetch);
+    // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other
+    // cases
+    const size_t sys_mem = Common::MemPhysical();
+    const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
+    s_memory_budget =
+        (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+    s_failed.clear();
   }
+
+  StartLoaders();
 }
 
-void HiresTexture::Prefetch()
+void HiresTexture::StartLoaders()
 {
-  Common::SetCurrentThreadName("Prefetcher");
-
-  size_t size_sum = 0;
-  size_t sys_mem = Common::MemPhysical();
-  size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
-  // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
-  size_t max_mem =
-      (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
-  u32 starttime = Common::Timer::GetTimeMs();
-  for (const auto& entry : s_textureMap)
   {
-    const std::string& base_filename = entry.first;
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+    s_loaders_exit = false;
+    s_prefetch_remaining = 0;
 
-    if (base_filename.find("_mip") == std::string::npos)
+    if (g_ActiveConfig.bCacheHiresTextures)
     {
+      for (const auto& entry : s_textureMap)
       {
-        // try to get this mutex first, so the video thread is allow to get the real mutex faster
-        std::unique_lock<std::mutex> lk(s_textureCacheAquireMutex);
-      }
-      std::unique_lock<std::mutex> lk(s_textureCacheMutex);
-
-      auto iter = s_textureCache.find(base_filename);
-      if (iter == s_textureCache.end())
-      {
-        // unlock while loading a texture. This may result in a race condition where we'll load a
-        // texture twice,
-        // but it reduces the stuttering a lot. Notice: The loading library _must_ be thread safe
-        // now.
-        // But bad luck, SOIL isn't, so TODO: remove SOIL usage here and use libpng directly
-        // Also TODO: remove s_textureCacheAquireMutex afterwards. It won't be needed as the main
-        // mutex will be locked rarely
-        // lk.unlock();
-        std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0);
-        // lk.lock();
-        if (texture)
-        {
-          std::shared_ptr<HiresTexture> ptr(std::move(texture));
-          iter = s_textureCache.insert(iter, std::make_pair(base_filename, ptr));
-        }
-      }
-      if (iter != s_textureCache.end())
-      {
-        for (const Level& l : iter->second->m_levels)
+        const std::string& base_filename = entry.first;
+        if (base_filename.find("_mip") != std::string::npos ||
+            s_textureCache.count(base_filename))
         {
-          size_sum += l.data_size;
+          continue;
         }
+
+        s_load_queue.push_back({base_filename, GetLevelFilenames(base_filename), 0, 0, true});
+        s_prefetch_remaining++;
       }
+      s_prefetch_start_time = Common::Timer::GetTimeMs();
     }
+  }
 
-    if (s_textureCacheAbortLoading.IsSet())
-    {
+  // Decoding is mostly CPU bound, but leave a core for the emulation and video threads.
+  const u32 num_loaders = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+  for (u32 i = 0; i < num_loaders; i++)
+    s_loaders.emplace_back(LoaderThread);
+}
+
+void HiresTexture::StopLoaders()
+{
+  {
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+    s_loaders_exit = true;
+    s_load_queue.clear();
+    s_pending.clear();
+  }
+  s_load_queue_cond.notify_all();
+
+  for (std::thread& loader : s_loaders)
+    loader.join();
+  s_loaders.clear();
+}
+
+void HiresTexture::LoaderThread()
+{
+  Common::SetCurrentThreadName("Custom Texture Loader");
+
+  std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  while (true)
+  {
+    s_load_queue_cond.wait(lk, [] { return s_loaders_exit || !s_load_queue.empty(); });
+    if (s_loaders_exit)
       return;
-    }
 
-    if (size_sum > max_mem)
+    LoadRequest request = std::move(s_load_queue.front());
+    s_load_queue.pop_front();
+
+    // Prefetching never evicts anything, it stops once the budget is used up.
+    if (request.prefetch && s_resident_size >= s_memory_budget)
     {
-      Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
+      FinishPrefetch(true);
+      continue;
+    }
 
-      OSD::AddMessage(
-          StringFromFormat(
-              "Custom Textures prefetching after %.1f MB aborted, not enough RAM available",
-              size_sum / (1024.0 * 1024.0)),
-          10000);
-      return;
+    if (!s_textureCache.count(request.base_filename))
+    {
+      lk.unlock();
+      const u64 start = Common::Timer::GetTimeUs();
+      std::shared_ptr<HiresTexture> texture =
+          Load(request.base_filename, request.level_filenames, request.width, request.height);
+      const u64 load_time = Common::Timer::GetTimeUs() - start;
+      lk.lock();
+
+      // The texture list may have changed while the lock was released.
+      if (s_loaders_exit)
+        return;
+
+      s_stats.load_time_us += load_time;
+      if (texture)
+      {
+        size_t size = 0;
+        for (const Level& l : texture->m_levels)
+          size += l.data_size;
+
+        DEBUG_LOG(VIDEO, "Loaded custom texture %s (%zu KB) in %" PRIu64 " us",
+                  request.base_filename.c_str(), size / 1024, load_time);
+        s_stats.textures_loaded++;
+        s_stats.bytes_loaded += size;
+        if (!request.prefetch)
+          s_stats.on_demand_loads++;
+
+        MakeResident(request.base_filename, std::move(texture), size);
+      }
+      else
+      {
+        s_stats.load_failures++;
+        s_failed.insert(request.base_filename);
+      }
     }
+
+    if (!request.prefetch)
+      s_pending.erase(request.base_filename);
+    else if (s_prefetch_remaining && --s_prefetch_remaining == 0)
+      FinishPrefetch(false);
   }
-  u32 stoptime = Common::Timer::GetTimeMs();
-  OSD::AddMessage(StringFromFormat("Custom Textures loaded, %.1f MB in %.1f s",
-                                   size_sum / (1024.0 * 1024.0), (stoptime - starttime) / 1000.0),
-                  10000);
 }
 
 std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
@@ -237,6 +416,10 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
       else
         return name;
     }
+    else if (s_pack && s_pack->Contains(name))
+    {
+      return name;
+    }
   }
 
   if (dump || s_check_new_format || convert)
@@ -357,11 +540,11 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
     }
 
     // try to match a wildcard template
-    if (!dump && s_textureMap.find(basename + "_*" + formatname) != s_textureMap.end())
+    if (!dump && HasTexture(basename + "_*" + formatname))
       return basename + "_*" + formatname;
 
     // else generate the complete texture
-    if (dump || s_textureMap.find(fullname) != s_textureMap.end())
+    if (dump || HasTexture(fullname))
       return fullname;
   }
 
@@ -385,63 +568,106 @@ u32 HiresTexture::CalculateMipCount(u32 width, u32 height)
 
 std::shared_ptr<HiresTexture> HiresTexture::Search(const u8* texture, size_t texture_size,
                                                    const u8* tlut, size_t tlut_size, u32 width,
-                                                   u32 height, int format, bool has_mipmaps)
+                                                   u32 height, int format, bool has_mipmaps,
+                                                   std::string* pending_name)
 {
   std::string base_filename =
       GenBaseName(texture, texture_size, tlut, tlut_size, width, height, format, has_mipmaps);
 
-  std::lock_guard<std::mutex> lk2(s_textureCacheAquireMutex);
+  // We need to have a level 0 custom texture to even consider loading.
+  if (s_textureMap.find(base_filename) == s_textureMap.end())
+  {
+    // Textures from a pack don't need to be decoded, so they are neither queued nor kept
+    // resident. The data is paged in from the mapping on upload.
+    if (s_pack)
+      return LoadFromPack(s_pack, base_filename, width, height);
+
+    return nullptr;
+  }
+
   std::lock_guard<std::mutex> lk(s_textureCacheMutex);
 
   auto iter = s_textureCache.find(base_filename);
   if (iter != s_textureCache.end())
   {
-    return iter->second;
+    s_lru.splice(s_lru.begin(), s_lru, iter->second.lru_iter);
+    return iter->second.texture;
   }
 
-  std::shared_ptr<HiresTexture> ptr(Load(base_filename, width, height));
+  if (s_failed.count(base_filename))
+    return nullptr;
 
-  if (ptr && g_ActiveConfig.bCacheHiresTextures)
+  // On-demand loads jump ahead of any outstanding prefetching.
+  if (s_pending.insert(base_filename).second)
   {
-    s_textureCache[base_filename] = ptr;
+    s_load_queue.push_front(
+        {base_filename, GetLevelFilenames(base_filename), width, height, false});
+    s_load_queue_cond.notify_one();
   }
 
-  return ptr;
+  if (pending_name)
+    *pending_name = std::move(base_filename);
+
+  return nullptr;
 }
 
-std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
-                                                 u32 height)
+u32 HiresTexture::GetLoadGeneration()
 {
-  // We need to have a level 0 custom texture to even consider loading.
-  auto filename_iter = s_textureMap.find(base_filename);
-  if (filename_iter == s_textureMap.end())
-    return nullptr;
+  return s_load_generation.load(std::memory_order_relaxed);
+}
 
-  // Try to load level 0 (and any mipmaps) from a DDS file.
-  // If this fails, it's fine, we'll just load level0 again using SOIL.
-  // Can't use make_unique due to private constructor.
-  std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
-  const std::string& first_mip_filename = filename_iter->second;
-  LoadDDSTexture(ret.get(), first_mip_filename);
+bool HiresTexture::IsResident(const std::string& base_filename)
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+  return s_textureCache.count(base_filename) != 0;
+}
 
-  // Load remaining mip levels, or from the start if it's not a DDS texture.
-  for (u32 mip_level = static_cast<u32>(ret->m_levels.size());; mip_level++)
+std::vector<std::string> HiresTexture::GetLevelFilenames(const std::string& base_filename)
+{
+  std::vector<std::string> level_filenames;
+  for (u32 mip_level = 0;; mip_level++)
   {
     std::string filename = base_filename;
     if (mip_level != 0)
       filename += StringFromFormat("_mip%u", mip_level);
 
-    filename_iter = s_textureMap.find(filename);
+    auto filename_iter = s_textureMap.find(filename);
     if (filename_iter == s_textureMap.end())
       break;
 
+    level_filenames.push_back(filename_iter->second);
+  }
+
+  return level_filenames;
+}
+
+// Runs on the loader threads, so this must not touch s_textureMap.
+std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename,
+                                                 const std::vector<std::string>& level_filenames,
+                                                 u32 width, u32 height)
+{
+  if (level_filenames.empty())
+    return nullptr;
+
+  // Try to load level 0 (and any mipmaps) from a DDS file.
+  // If this fails, it's fine, we'll just load level0 again as an image file.
+  // Can't use make_unique due to private constructor.
+  std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
+  const std::string& first_mip_filename = level_filenames[0];
+  LoadDDSTexture(ret.get(), first_mip_filename);
+
+  // Load remaining mip levels, or from the start if it's not a DDS texture.
+  for (size_t mip_level = ret->m_levels.size(); mip_level < level_filenames.size(); mip_level++)
+  {
+    const std::string& filename = level_filenames[mip_level];
+
     // Try loading DDS textures first, that way we maintain compression of DXT formats.
     // TODO: Reduce the number of open() calls here. We could use one fd.
     Level level;
-    if (!LoadDDSTexture(level, filename_iter->second))
+    if (!LoadDDSTexture(level, filename))
     {
       File::IOFile file;
-      file.Open(filename_iter->second, "rb");
+      file.Open(filename, "rb");
       std::vector<u8> buffer(file.GetSize());
       file.ReadBytes(buffer.data(), file.GetSize());
       if (!LoadTexture(level, buffer))
@@ -454,6 +680,39 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
     ret->m_levels.push_back(std::move(level));
   }
 
+  return Validate(std::move(ret), first_mip_filename, width, height);
+}
+
+std::unique_ptr<HiresTexture> HiresTexture::LoadFromPack(std::shared_ptr<HiresTexturePack> pack,
+                                                         const std::string& base_filename,
+                                                         u32 width, u32 height)
+{
+  std::vector<HiresTexturePack::Level> pack_levels;
+  if (!pack->GetLevels(base_filename, &pack_levels))
+    return nullptr;
+
+  std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
+  for (const HiresTexturePack::Level& pack_level : pack_levels)
+  {
+    // The data is used straight from the mapping, and paged in when it is first uploaded.
+    Level level;
+    level.data = ImageDataPointer(const_cast<u8*>(pack_level.data), [](u8*) {});
+    level.format = pack_level.format;
+    level.width = pack_level.width;
+    level.height = pack_level.height;
+    level.row_length = pack_level.row_length;
+    level.data_size = pack_level.data_size;
+    ret->m_levels.push_back(std::move(level));
+  }
+  ret->m_pack = std::move(pack);
+
+  return Validate(std::move(ret), base_filename, width, height);
+}
+
+std::unique_ptr<HiresTexture> HiresTexture::Validate(std::unique_ptr<HiresTexture> ret,
+                                                     const std::string& first_mip_filename,
+                                                     u32 width, u32 height)
+{
   // If we failed to load any mip levels, we can't use this texture at all.
   if (ret->m_levels.empty())
     return nullptr;
@@ -521,10 +780,14 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
 
 bool HiresTexture::LoadTexture(Level& level, const std::vector<u8>& buffer)
 {
+  if (buffer.size() >= 8 && png_sig_cmp(buffer.data(), 0, 8) == 0)
+    return LoadPNGTexture(level, buffer);
+
   int channels;
   int width;
   int height;
 
+  std::lock_guard<std::mutex> lk(s_soil_mutex);
   u8* data = SOIL_load_image_from_memory(buffer.data(), static_cast<int>(buffer.size()), &width,
                                          &height, &channels, SOIL_LOAD_RGBA);
   if (!data)
@@ -540,6 +803,34 @@ bool HiresTexture::LoadTexture(Level& level, const std::vector<u8>& buffer)
   return true;
 }
 
+bool HiresTexture::LoadPNGTexture(Level& level, const std::vector<u8>& buffer)
+{
+  // The simplified libpng API keeps all state in the png_image, so this is safe to call from
+  // several threads at once.
+  png_image png = {};
+  png.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_memory(&png, buffer.data(), buffer.size()))
+    return false;
+
+  png.format = PNG_FORMAT_RGBA;
+  const size_t data_size = PNG_IMAGE_SIZE(png);
+  ImageDataPointer data(new u8[data_size], [](u8* ptr) { delete[] ptr; });
+  if (!png_image_finish_read(&png, nullptr, data.get(), 0, nullptr))
+  {
+    ERROR_LOG(VIDEO, "Failed to decode PNG custom texture: %s", png.message);
+    png_image_free(&png);
+    return false;
+  }
+
+  level.width = png.width;
+  level.height = png.height;
+  level.format = AbstractTextureFormat::RGBA8;
+  level.data = std::move(data);
+  level.row_length = level.width;
+  level.data_size = data_size;
+  return true;
+}
+
 std::string HiresTexture::GetTextureDirectory(const std::string& game_id)
 {
   const std::string texture_directory = File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id;
@@ -551,6 +842,74 @@ std::string HiresTexture::GetTextureDirectory(const std::string& game_id)
   return texture_directory;
 }
 
+std::string HiresTexture::GetTexturePackPath(const std::string& game_id)
+{
+  const std::string pack_path =
+      File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id + s_pack_extension;
+
+  // Same fallback to the region-free ID as for directories
+  if (!File::Exists(pack_path))
+    return File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id.substr(0, 3) + s_pack_extension;
+
+  return pack_path;
+}
+
+bool HiresTexture::BuildPack(const std::string& texture_directory, const std::string& pack_path,
+                             const std::function<void(const std::string&, bool)>& on_texture)
+{
+  std::map<std::string, std::string> files;
+  for (const std::string& path :
+       Common::DoFileSearch({texture_directory}, s_extensions, /*recursive*/ true))
+  {
+    std::string name;
+    SplitPath(path, nullptr, &name, nullptr);
+    files.emplace(name, path);
+  }
+
+  HiresTexturePack::Writer writer(pack_path);
+  if (!writer.IsOpen())
+    return false;
+
+  for (const auto& file : files)
+  {
+    const std::string& base_filename = file.first;
+    if (base_filename.find("_mip") != std::string::npos)
+      continue;
+
+    std::vector<std::string> level_filenames;
+    for (u32 mip_level = 0;; mip_level++)
+    {
+      std::string filename = base_filename;
+      if (mip_level != 0)
+        filename += StringFromFormat("_mip%u", mip_level);
+
+      const auto iter = files.find(filename);
+      if (iter == files.end())
+        break;
+
+      level_filenames.push_back(iter->second);
+    }
+
+    std::unique_ptr<HiresTexture> texture = Load(base_filename, level_filenames, 0, 0);
+    if (texture)
+    {
+      std::vector<HiresTexturePack::Level> levels;
+      for (const Level& level : texture->m_levels)
+      {
+        levels.push_back({level.format, level.width, level.height, level.row_length,
+                          level.data.get(), level.data_size});
+      }
+      if (!writer.AddTexture(base_filename, levels))
+        return false;
+    }
+
+    if (on_texture)
+      on_texture(base_filename, texture != nullptr);
+  }
+
+  return writer.Finish();
+}
+
 HiresTexture::~HiresTexture()
 {
 }
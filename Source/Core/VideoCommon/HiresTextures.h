@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,6 +12,8 @@
 #include "Common/CommonTypes.h"
 #include "VideoCommon/TextureConfig.h"
 
+class HiresTexturePack;
+
 class HiresTexture
 {
 public:
@@ -20,9 +23,18 @@ public:
   static void Update();
   static void Shutdown();
 
+  // Returns the custom texture if it is resident or stored in the texture pack. Otherwise, a
+  // load is queued on the loader threads, nullptr is returned so the native texture can be used
+  // as a placeholder, and the name of the pending texture is stored in pending_name.
   static std::shared_ptr<HiresTexture> Search(const u8* texture, size_t texture_size,
                                               const u8* tlut, size_t tlut_size, u32 width,
-                                              u32 height, int format, bool has_mipmaps);
+                                              u32 height, int format, bool has_mipmaps,
+                                              std::string* pending_name = nullptr);
+
+  // Incremented every time a texture becomes resident. Lets callers holding a placeholder avoid
+  // calling IsResident (which locks) until something has actually finished loading.
+  static u32 GetLoadGeneration();
+  static bool IsResident(const std::string& base_filename);
 
   static std::string GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
                                  size_t tlut_size, u32 width, u32 height, int format,
@@ -30,6 +42,11 @@ public:
 
   static u32 CalculateMipCount(u32 width, u32 height);
 
+  // Converts all textures in a directory into a single HiresTexturePack file. on_texture is
+  // called for every texture with its name and whether it could be loaded.
+  static bool BuildPack(const std::string& texture_directory, const std::string& pack_path,
+                        const std::function<void(const std::string&, bool)>& on_texture);
+
   ~HiresTexture();
 
   AbstractTextureFormat GetFormat() const;
@@ -47,14 +64,30 @@ public:
   std::vector<Level> m_levels;
 
 private:
-  static std::unique_ptr<HiresTexture> Load(const std::string& base_filename, u32 width,
-                                            u32 height);
+  static std::vector<std::string> GetLevelFilenames(const std::string& base_filename);
+  static std::unique_ptr<HiresTexture> Load(const std::string& base_filename,
+                                            const std::vector<std::string>& level_filenames,
+                                            u32 width, u32 height);
+  static std::unique_ptr<HiresTexture> LoadFromPack(std::shared_ptr<HiresTexturePack> pack,
+                                                    const std::string& base_filename, u32 width,
+                                                    u32 height);
+  static std::unique_ptr<HiresTexture> Validate(std::unique_ptr<HiresTexture> ret,
+                                                const std::string& first_mip_filename, u32 width,
+                                                u32 height);
   static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
   static bool LoadDDSTexture(Level& level, const std::string& filename);
   static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
-  static void Prefetch();
+  static bool LoadPNGTexture(Level& level, const std::vector<u8>& buffer);
+
+  static void StartLoaders();
+  static void StopLoaders();
+  static void LoaderThread();
 
   static std::string GetTextureDirectory(const std::string& game_id);
+  static std::string GetTexturePackPath(const std::string& game_id);
 
   HiresTexture() {}
+
+  // Keeps the pack mapped while its data is referenced by m_levels.
+  std::shared_ptr<HiresTexturePack> m_pack;
 };
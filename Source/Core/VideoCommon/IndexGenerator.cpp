@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <cstddef>
+#include <cstring>
+#include <vector>
 
 #include "Common/Common.h"
 #include "Common/CommonTypes.h"
@@ -20,6 +22,10 @@ static const u16 s_primitive_restart = UINT16_MAX;
 
 static u16* (*primitive_table[8])(u16*, u32, u32);
 
+// Scratch space for AddDeduplicatedIndices.
+static std::vector<u32> s_dedup_table;
+static std::vector<u16> s_dedup_remap;
+
 void IndexGenerator::Init()
 {
   if (g_Config.backend_info.bSupportsPrimitiveRestart)
@@ -56,6 +62,64 @@ void IndexGenerator::AddIndices(int primitive, u32 numVerts)
   base_index += numVerts;
 }
 
+static u32 HashVertex(const u8* vertex, u32 stride)
+{
+  // All native vertex components are 4 bytes wide.
+  u32 hash = 0;
+  for (u32 i = 0; i < stride; i += sizeof(u32))
+  {
+    u32 word;
+    std::memcpy(&word, vertex + i, sizeof(u32));
+    hash = (hash ^ word) * 0x9E3779B1;
+  }
+  return hash ^ (hash >> 15);
+}
+
+u32 IndexGenerator::AddDeduplicatedIndices(int primitive, u32 numVerts, u8* vertices, u32 stride)
+{
+  // Open addressing, storing the new index + 1 of the first vertex with each content.
+  std::vector<u32>& table = s_dedup_table;
+  std::vector<u16>& remap = s_dedup_remap;
+  u32 table_size = 16;
+  while (table_size < numVerts * 2)
+    table_size <<= 1;
+  table.assign(table_size, 0);
+  remap.resize(numVerts);
+
+  u32 unique_verts = 0;
+  for (u32 i = 0; i < numVerts; ++i)
+  {
+    const u8* vertex = vertices + i * stride;
+    u32 slot = HashVertex(vertex, stride) & (table_size - 1);
+    while (table[slot] &&
+           std::memcmp(vertices + (table[slot] - 1) * stride, vertex, stride) != 0)
+    {
+      slot = (slot + 1) & (table_size - 1);
+    }
+
+    if (!table[slot])
+    {
+      // The kept vertices are always below the current one, so this never overlaps.
+      if (unique_verts != i)
+        std::memcpy(vertices + unique_verts * stride, vertex, stride);
+      table[slot] = ++unique_verts;
+    }
+    remap[i] = table[slot] - 1;
+  }
+
+  // Generate the indices as usual, then point them at the kept vertices.
+  u16* const first_index = index_buffer_current;
+  index_buffer_current = primitive_table[primitive](index_buffer_current, numVerts, base_index);
+  for (u16* index = first_index; index != index_buffer_current; ++index)
+  {
+    if (*index != s_primitive_restart)
+      *index = base_index + remap[*index - base_index];
+  }
+  base_index += unique_verts;
+
+  return unique_verts;
+}
+
 // Triangles
 template <bool pr>
 __forceinline u16* IndexGenerator::WriteTriangle(u16* Iptr, u32 index1, u32 index2, u32 index3)
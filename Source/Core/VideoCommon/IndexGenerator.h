@@ -18,6 +18,11 @@ public:
 
   static void AddIndices(int primitive, u32 numVertices);
 
+  // Like AddIndices, but first removes duplicates from the numVertices vertices of the given
+  // stride, which must be the last ones in the vertex buffer. The remaining vertices are packed at
+  // the start, and the indices refer to them. Returns the number of vertices kept.
+  static u32 AddDeduplicatedIndices(int primitive, u32 numVertices, u8* vertices, u32 stride);
+
   // returns numprimitives
   static u32 GetNumVerts() { return base_index; }
   static u32 GetIndexLen() { return (u32)(index_buffer_current - BASEIptr); }
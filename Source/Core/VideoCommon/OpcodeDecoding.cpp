@@ -18,16 +18,19 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/Tracing.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
 bool g_bRecordFifoData = false;
@@ -40,6 +43,11 @@ static u32 InterpretDisplayList(u32 address, u32 size)
 {
   u8* startAddress;
 
+  // The cache validates display lists against RAM, which isn't where they are read from with the
+  // deterministic GPU thread. While recording, every command has to go through Run.
+  const bool use_cache = g_ActiveConfig.bDisplayListCache && !Fifo::UseDeterministicGPUThread() &&
+                         !g_bRecordFifoData;
+
   if (Fifo::UseDeterministicGPUThread())
     startAddress = (u8*)Fifo::PopFifoAuxBuffer(size);
   else
@@ -53,7 +61,8 @@ static u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     Statistics::SwapDL();
 
-    Run(DataReader(startAddress, startAddress + size), &cycles, true);
+    if (!use_cache || !DisplayListCache::Run(address, size, startAddress, &cycles))
+      Run(DataReader(startAddress, startAddress + size), &cycles, true);
     INCSTAT(stats.thisFrame.numDListsCalled);
 
     // un-swap
@@ -83,6 +92,7 @@ void Init()
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list)
 {
+  TRACE_ZONE(is_preprocess ? "OpcodeDecoder::Preprocess" : "OpcodeDecoder::Run");
   u32 totalCycles = 0;
   u8* opcodeStart;
   while (true)
@@ -18,6 +18,7 @@ bool PixelShaderManager::s_bViewPortChanged;
 
 PixelShaderConstants PixelShaderManager::constants;
 bool PixelShaderManager::dirty;
+ConstantUploadTracker PixelShaderManager::upload_tracker(sizeof(PixelShaderConstants));
 
 void PixelShaderManager::Init()
 {
@@ -41,6 +42,7 @@ void PixelShaderManager::Init()
   SetTexCoordChanged(7);
 
   dirty = true;
+  upload_tracker.Invalidate();
 }
 
 void PixelShaderManager::Dirty()
@@ -6,6 +6,7 @@
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/ConstantManager.h"
+#include "VideoCommon/ConstantUploadTracker.h"
 
 class PointerWrap;
 
@@ -41,6 +42,7 @@ public:
 
   static PixelShaderConstants constants;
   static bool dirty;
+  static ConstantUploadTracker upload_tracker;
 
   static bool s_bFogRangeAdjustChanged;
   static bool s_bViewPortChanged;
@@ -47,6 +47,7 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/Fifo.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -740,6 +741,11 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
   // Begin new frame
   // Set default viewport and scissor, for the clear to work correctly
   // New frame
+  u64 cpu_wait_time, gpu_wait_time;
+  Fifo::TakeWaitTimes(&cpu_wait_time, &gpu_wait_time);
+  SETSTAT(stats.usCPUWaitingForGPU, cpu_wait_time);
+  SETSTAT(stats.usGPUWaitingForCPU, gpu_wait_time);
+  stats.RecordFrame(gpu_wait_time);
   stats.ResetFrame();
 
   Core::Callback_VideoCopiedToXFB(m_xfb_written ||
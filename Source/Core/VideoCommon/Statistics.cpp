@@ -2,9 +2,14 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Common/StringUtil.h"
 #include "VideoCommon/Statistics.h"
@@ -13,11 +18,59 @@
 
 Statistics stats;
 
+static std::atomic<bool> s_frame_history_enabled{false};
+static std::mutex s_frame_history_lock;
+static std::vector<Statistics::FrameRecord> s_frame_history;
+static std::chrono::steady_clock::time_point s_last_frame_time;
+static bool s_has_last_frame_time;
+
 void Statistics::ResetFrame()
 {
   memset(&thisFrame, 0, sizeof(ThisFrame));
 }
 
+void Statistics::StartFrameHistory()
+{
+  std::lock_guard<std::mutex> lk(s_frame_history_lock);
+  s_frame_history.clear();
+  s_has_last_frame_time = false;
+  s_frame_history_enabled.store(true);
+}
+
+std::vector<Statistics::FrameRecord> Statistics::StopFrameHistory()
+{
+  std::lock_guard<std::mutex> lk(s_frame_history_lock);
+  s_frame_history_enabled.store(false);
+  return std::move(s_frame_history);
+}
+
+void Statistics::RecordFrame(u64 gpu_waiting_for_cpu_us)
+{
+  if (!s_frame_history_enabled.load(std::memory_order_relaxed))
+    return;
+
+  std::lock_guard<std::mutex> lk(s_frame_history_lock);
+  const auto now = std::chrono::steady_clock::now();
+
+  // The first frame has no start to measure from, it only starts the clock.
+  if (s_has_last_frame_time)
+  {
+    const u64 frame_us = static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - s_last_frame_time).count());
+
+    FrameRecord record;
+    record.usGPUBusy = frame_us - std::min(frame_us, gpu_waiting_for_cpu_us);
+    record.numCommands = thisFrame.numBPLoads + thisFrame.numCPLoads + thisFrame.numXFLoads +
+                         thisFrame.numBPLoadsInDL + thisFrame.numCPLoadsInDL +
+                         thisFrame.numXFLoadsInDL + thisFrame.numPrimitiveJoins;
+    record.numVertices = thisFrame.numPrims + thisFrame.numDLPrims;
+    s_frame_history.push_back(record);
+  }
+
+  s_last_frame_time = now;
+  s_has_last_frame_time = true;
+}
+
 void Statistics::SwapDL()
 {
   std::swap(stats.thisFrame.numDLPrims, stats.thisFrame.numPrims);
@@ -47,12 +100,19 @@ std::string Statistics::ToString()
   str += StringFromFormat("Textures created: %i\n", stats.numTexturesCreated);
   str += StringFromFormat("Textures uploaded: %i\n", stats.numTexturesUploaded);
   str += StringFromFormat("Textures alive: %i\n", stats.numTexturesAlive);
+  const int pool_requests =
+      stats.thisFrame.numTexturePoolHits + stats.thisFrame.numTexturePoolMisses;
+  str += StringFromFormat("Texture pool: %i (%i kB), %i%% hits\n", stats.numTexturesPooled,
+                          stats.bytesTexturePool / 1024,
+                          pool_requests ? stats.thisFrame.numTexturePoolHits * 100 / pool_requests :
+                                          100);
   str += StringFromFormat("pshaders created: %i\n", stats.numPixelShadersCreated);
   str += StringFromFormat("pshaders alive: %i\n", stats.numPixelShadersAlive);
   str += StringFromFormat("vshaders created: %i\n", stats.numVertexShadersCreated);
   str += StringFromFormat("vshaders alive: %i\n", stats.numVertexShadersAlive);
   str += StringFromFormat("shaders changes: %i\n", stats.thisFrame.numShaderChanges);
   str += StringFromFormat("dlists called: %i\n", stats.thisFrame.numDListsCalled);
+  str += StringFromFormat("dlists cached: %i\n", stats.thisFrame.numDListsCached);
   str += StringFromFormat("Primitive joins: %i\n", stats.thisFrame.numPrimitiveJoins);
   str += StringFromFormat("Draw calls: %i\n", stats.thisFrame.numDrawCalls);
   str += StringFromFormat("Primitives: %i\n", stats.thisFrame.numPrims);
@@ -66,6 +126,11 @@ std::string Statistics::ToString()
   str += StringFromFormat("Vertex streamed: %i kB\n", stats.thisFrame.bytesVertexStreamed / 1024);
   str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
   str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
+  str += StringFromFormat("Uniform skipped: %i kB\n", stats.thisFrame.bytesUniformSkipped / 1024);
+  str += StringFromFormat("Vertex deduplicated: %i kB\n",
+                          stats.thisFrame.bytesVertexDeduplicated / 1024);
+  str += StringFromFormat("CPU waiting for GPU: %i us\n", stats.usCPUWaitingForGPU);
+  str += StringFromFormat("GPU waiting for CPU: %i us\n", stats.usGPUWaitingForCPU);
   str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
 
   std::string vertex_list = VertexLoaderManager::VertexLoadersToString();
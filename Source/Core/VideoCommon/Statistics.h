@@ -5,6 +5,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
 
 struct Statistics
 {
@@ -16,9 +19,15 @@ struct Statistics
   int numTexturesCreated;
   int numTexturesUploaded;
   int numTexturesAlive;
+  int numTexturesPooled;
+  int bytesTexturePool;
 
   int numVertexLoaders;
 
+  // Time in microseconds the CPU and GPU threads spent waiting for each other in the last frame.
+  int usCPUWaitingForGPU;
+  int usGPUWaitingForCPU;
+
   float proj_0, proj_1, proj_2, proj_3, proj_4, proj_5;
   float gproj_0, gproj_1, gproj_2, gproj_3, gproj_4, gproj_5;
   float gproj_6, gproj_7, gproj_8, gproj_9, gproj_10, gproj_11, gproj_12, gproj_13, gproj_14,
@@ -46,10 +55,16 @@ struct Statistics
     int numDrawCalls;
 
     int numDListsCalled;
+    int numDListsCached;
+
+    int numTexturePoolHits;
+    int numTexturePoolMisses;
 
     int bytesVertexStreamed;
     int bytesIndexStreamed;
     int bytesUniformStreamed;
+    int bytesUniformSkipped;
+    int bytesVertexDeduplicated;
 
     int numTrianglesClipped;
     int numTrianglesIn;
@@ -64,6 +79,20 @@ struct Statistics
   };
   ThisFrame thisFrame;
   void ResetFrame();
+
+  struct FrameRecord
+  {
+    // Time the video thread spent on the frame, without waiting for the CPU thread.
+    u64 usGPUBusy;
+    u32 numCommands;
+    u32 numVertices;
+  };
+
+  // Keeps a record of every frame until StopFrameHistory, for benchmarks.
+  static void StartFrameHistory();
+  static std::vector<FrameRecord> StopFrameHistory();
+  // Called by the renderer at the end of each frame, before ResetFrame.
+  void RecordFrame(u64 gpu_waiting_for_cpu_us);
   static void SwapDL();
 
   static std::string ToString();
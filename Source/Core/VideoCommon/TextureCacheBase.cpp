@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
@@ -17,6 +18,7 @@
 #include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
@@ -39,6 +41,10 @@ static const u64 TEXHASH_INVALID = 0;
 // Sonic the Fighters (inside Sonic Gems Collection) loops a 64 frames animation
 static const int TEXTURE_KILL_THRESHOLD = 64;
 static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
+// Upper bound for the memory held by unused textures at native resolution. Games which keep
+// creating render targets of slightly different sizes would otherwise fill the pool with textures
+// that are never reused.
+static const u64 TEXTURE_POOL_MEMORY_BUDGET = 64 * 1024 * 1024;
 
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
@@ -90,6 +96,9 @@ void TextureCacheBase::Invalidate()
   textures_by_hash.clear();
 
   texture_pool.clear();
+  texture_pool_bytes = 0;
+  SETSTAT(stats.numTexturesPooled, 0);
+  SETSTAT(stats.bytesTexturePool, 0);
 }
 
 TextureCacheBase::~TextureCacheBase()
@@ -152,14 +161,18 @@ void TextureCacheBase::Cleanup(int _frameCount)
         // host GPU are unrecoverable. Perform this check only every TEXTURE_KILL_THRESHOLD for
         // performance reasons
         if ((_frameCount - iter->second->frameCount) % TEXTURE_KILL_THRESHOLD == 1 &&
-            iter->second->hash != iter->second->CalculateHash())
+            !iter->second->IsUnmodifiedSinceHashed())
         {
-          iter = InvalidateTexture(iter);
-        }
-        else
-        {
-          ++iter;
+          const u32 write_epoch = Memory::GetWriteEpoch();
+          if (iter->second->hash != iter->second->CalculateHash())
+          {
+            iter = InvalidateTexture(iter);
+            continue;
+          }
+          if (Memory::IsWriteTrackingEnabled())
+            iter->second->write_epoch = write_epoch;
         }
+        ++iter;
       }
       else
       {
@@ -172,6 +185,10 @@ void TextureCacheBase::Cleanup(int _frameCount)
     }
   }
 
+  // Writes made from now on can't have been seen by anything hashed before this point.
+  if (Memory::IsWriteTrackingEnabled())
+    Memory::AdvanceWriteEpoch();
+
   TexPool::iterator iter2 = texture_pool.begin();
   TexPool::iterator tcend2 = texture_pool.end();
   while (iter2 != tcend2)
@@ -182,13 +199,15 @@ void TextureCacheBase::Cleanup(int _frameCount)
     }
     if (_frameCount > TEXTURE_POOL_KILL_THRESHOLD + iter2->second.frameCount)
     {
-      iter2 = texture_pool.erase(iter2);
+      iter2 = RemoveTextureFromPool(iter2);
     }
     else
     {
       ++iter2;
     }
   }
+
+  TrimTexturePool();
 }
 
 bool TextureCacheBase::TCacheEntry::OverlapsMemoryRange(u32 range_address, u32 range_size) const
@@ -237,6 +256,35 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ApplyPaletteToEntry(TCacheEntry
   return decoded_entry;
 }
 
+u64 TextureCacheBase::GetUnmodifiedBaseHash(u32 address, u32 size_in_bytes) const
+{
+  auto iter_range = textures_by_address.equal_range(address);
+  for (auto iter = iter_range.first; iter != iter_range.second; ++iter)
+  {
+    const TCacheEntry* entry = iter->second;
+    if (!entry->IsEfbCopy() && entry->size_in_bytes == size_in_bytes &&
+        entry->IsUnmodifiedSinceHashed())
+    {
+      return entry->base_hash;
+    }
+  }
+  return TEXHASH_INVALID;
+}
+
+bool TextureCacheBase::IsPendingCustomTextureReady(TCacheEntry* entry) const
+{
+  if (entry->pending_custom_tex.empty())
+    return false;
+
+  // Only look the texture up when something has been loaded since the last check.
+  const u32 generation = HiresTexture::GetLoadGeneration();
+  if (entry->custom_tex_generation == generation)
+    return false;
+
+  entry->custom_tex_generation = generation;
+  return HiresTexture::IsResident(entry->pending_custom_tex);
+}
+
 void TextureCacheBase::ScaleTextureCacheEntryTo(TextureCacheBase::TCacheEntry* entry, u32 new_width,
                                                 u32 new_height)
 {
@@ -266,10 +314,9 @@ void TextureCacheBase::ScaleTextureCacheEntryTo(TextureCacheBase::TCacheEntry* e
                                           new_texture->GetConfig().GetRect());
     entry->texture.swap(new_texture);
 
-    auto config = new_texture->GetConfig();
     // At this point new_texture has the old texture in it,
     // we can potentially reuse this, so let's move it back to the pool
-    texture_pool.emplace(config, TexPoolEntry(std::move(new_texture)));
+    ReturnTextureToPool(std::move(new_texture));
   }
   else
   {
@@ -312,7 +359,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
         entry->memory_stride == numBlocksX * block_size)
     {
-      if (entry->hash == entry->CalculateHash())
+      if (entry->IsUnmodifiedSinceHashed() || entry->hash == entry->CalculateHash())
       {
         if (isPaletteTexture)
         {
@@ -469,6 +516,7 @@ void TextureCacheBase::UnbindTextures()
 
 TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 {
+  TRACE_ZONE("TextureCache::Load");
   const FourTexUnits& tex = bpmem.tex[stage >> 2];
   const u32 id = stage & 3;
   const u32 address = (tex.texImage3[id].image_base /* & 0x1FFFFF*/) << 5;
@@ -547,9 +595,18 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
     FifoRecorder::GetInstance().UseMemory(address, texture_size + additional_mips_size,
                                           MemoryUpdate::TEXTURE_MAP);
 
+  // With write tracking, memory which hasn't been written since an existing entry hashed it can't
+  // have changed, so that entry's hash can be reused instead of hashing the texture again.
+  const bool track_writes = !from_tmem && Memory::IsWriteTrackingEnabled();
+  const u32 write_epoch = track_writes ? Memory::GetWriteEpoch() : 0;
+  if (track_writes)
+    base_hash = GetUnmodifiedBaseHash(address, texture_size);
+  const bool hash_is_tracked = base_hash != TEXHASH_INVALID;
+
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  base_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+  if (!hash_is_tracked)
+    base_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
   u32 palette_size = 0;
   if (isPaletteTexture)
   {
@@ -650,6 +707,15 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
           entry->native_levels >= tex_levels && entry->native_width == nativeW &&
           entry->native_height == nativeH)
       {
+        // Replace the placeholder once its custom texture has finished loading.
+        if (IsPendingCustomTextureReady(entry))
+        {
+          iter = InvalidateTexture(iter);
+          continue;
+        }
+
+        if (track_writes && !hash_is_tracked)
+          entry->write_epoch = write_epoch;
         entry = DoPartialTextureUpdates(iter->second, &texMem[tlutaddr], tlutfmt);
 
         return ReturnEntry(stage, entry);
@@ -700,6 +766,12 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       if (entry->format == full_format && entry->native_levels >= tex_levels &&
           entry->native_width == nativeW && entry->native_height == nativeH)
       {
+        if (IsPendingCustomTextureReady(entry))
+        {
+          InvalidateTexture(GetTexCacheIter(entry));
+          break;
+        }
+
         entry = DoPartialTextureUpdates(hash_iter->second, &texMem[tlutaddr], tlutfmt);
 
         return ReturnEntry(stage, entry);
@@ -716,10 +788,12 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   }
 
   std::shared_ptr<HiresTexture> hires_tex;
+  std::string pending_custom_tex;
+  const u32 custom_tex_generation = HiresTexture::GetLoadGeneration();
   if (g_ActiveConfig.bHiresTextures)
   {
     hires_tex = HiresTexture::Search(src_data, texture_size, &texMem[tlutaddr], palette_size, width,
-                                     height, texformat, use_mipmaps);
+                                     height, texformat, use_mipmaps, &pending_custom_tex);
 
     if (hires_tex)
     {
@@ -806,8 +880,11 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   entry->SetGeneralParameters(address, texture_size, full_format);
   entry->SetDimensions(nativeW, nativeH, tex_levels);
   entry->SetHashes(base_hash, full_hash);
+  entry->write_epoch = write_epoch;
   entry->is_efb_copy = false;
   entry->is_custom_tex = hires_tex != nullptr;
+  entry->pending_custom_tex = std::move(pending_custom_tex);
+  entry->custom_tex_generation = custom_tex_generation;
 
   std::string basename = "";
   if (g_ActiveConfig.bDumpTextures && !hires_tex)
@@ -1308,6 +1385,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, unsigned int dstFo
       }
     }
   }
+  Memory::NotifyWrite(dstAddr, covered_range);
+
   if (g_bRecordFifoData)
   {
     // Mark the memory behind this efb copy as dynamicly generated for the Fifo log
@@ -1378,8 +1457,11 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, unsigned int dstFo
 
       CopyEFBToCacheEntry(entry, is_depth_copy, srcRect, scaleByHalf, cbufid, colmat);
 
+      const u32 write_epoch = Memory::GetWriteEpoch();
       u64 hash = entry->CalculateHash();
       entry->SetHashes(hash, hash);
+      if (Memory::IsWriteTrackingEnabled())
+        entry->write_epoch = write_epoch;
 
       if (g_ActiveConfig.bDumpEFBTarget)
       {
@@ -1415,7 +1497,8 @@ std::unique_ptr<AbstractTexture> TextureCacheBase::AllocateTexture(const Texture
   if (iter != texture_pool.end())
   {
     entry = std::move(iter->second.texture);
-    texture_pool.erase(iter);
+    RemoveTextureFromPool(iter);
+    INCSTAT(stats.thisFrame.numTexturePoolHits);
   }
   else
   {
@@ -1424,6 +1507,7 @@ std::unique_ptr<AbstractTexture> TextureCacheBase::AllocateTexture(const Texture
       return nullptr;
 
     INCSTAT(stats.numTexturesCreated);
+    INCSTAT(stats.thisFrame.numTexturePoolMisses);
   }
 
   return entry;
@@ -1444,6 +1528,80 @@ TextureCacheBase::FindMatchingTextureFromPool(const TextureConfig& config)
   return matching_iter != range.second ? matching_iter : texture_pool.end();
 }
 
+static size_t CalculateTextureMemorySize(const TextureConfig& config)
+{
+  const size_t block_size = AbstractTexture::IsCompressedHostTextureFormat(config.format) ? 4 : 1;
+  size_t size = 0;
+  for (u32 level = 0; level < config.levels; level++)
+  {
+    const u32 width = std::max(config.width >> level, 1u);
+    const u32 height = std::max(config.height >> level, 1u);
+    const size_t rows = (height + block_size - 1) / block_size;
+    size += AbstractTexture::CalculateHostTextureLevelPitch(config.format, width) * rows;
+  }
+  return size * config.layers;
+}
+
+void TextureCacheBase::ReturnTextureToPool(std::unique_ptr<AbstractTexture> texture)
+{
+  const TextureConfig config = texture->GetConfig();
+  const size_t size = CalculateTextureMemorySize(config);
+  texture_pool.emplace(config, TexPoolEntry(std::move(texture), size));
+  texture_pool_bytes += size;
+
+  SETSTAT(stats.numTexturesPooled, texture_pool.size());
+  SETSTAT(stats.bytesTexturePool, texture_pool_bytes);
+}
+
+TextureCacheBase::TexPool::iterator TextureCacheBase::RemoveTextureFromPool(TexPool::iterator iter)
+{
+  texture_pool_bytes -= iter->second.size;
+  iter = texture_pool.erase(iter);
+
+  SETSTAT(stats.numTexturesPooled, texture_pool.size());
+  SETSTAT(stats.bytesTexturePool, texture_pool_bytes);
+  return iter;
+}
+
+// The pool mostly holds EFB copies, which grow with the internal resolution, so the budget scales
+// with the size of the render target to keep as many of them around.
+static size_t GetTexturePoolMemoryBudget()
+{
+  const u64 target_pixels =
+      static_cast<u64>(g_renderer->GetTargetWidth()) * g_renderer->GetTargetHeight();
+  const u64 budget = TEXTURE_POOL_MEMORY_BUDGET * target_pixels / (EFB_WIDTH * EFB_HEIGHT);
+  return static_cast<size_t>(std::max(budget, TEXTURE_POOL_MEMORY_BUDGET));
+}
+
+void TextureCacheBase::TrimTexturePool()
+{
+  const size_t budget = GetTexturePoolMemoryBudget();
+  if (texture_pool_bytes <= budget)
+    return;
+
+  // Called from Cleanup, after every pooled texture has been assigned a frame count.
+  std::vector<TexPool::iterator> by_age;
+  by_age.reserve(texture_pool.size());
+  for (auto iter = texture_pool.begin(); iter != texture_pool.end(); ++iter)
+    by_age.push_back(iter);
+  std::sort(by_age.begin(), by_age.end(), [](const auto& a, const auto& b) {
+    return a->second.frameCount < b->second.frameCount;
+  });
+
+  size_t freed = 0;
+  for (auto iter : by_age)
+  {
+    if (texture_pool_bytes <= budget)
+      break;
+
+    freed += iter->second.size;
+    RemoveTextureFromPool(iter);
+  }
+
+  DEBUG_LOG(VIDEO, "Trimmed %u kB from the texture pool, %u kB left",
+            static_cast<u32>(freed / 1024), static_cast<u32>(texture_pool_bytes / 1024));
+}
+
 TextureCacheBase::TexAddrCache::iterator
 TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
 {
@@ -1491,8 +1649,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter)
     entry->textures_by_hash_iter = textures_by_hash.end();
   }
 
-  auto config = entry->texture->GetConfig();
-  texture_pool.emplace(config, TexPoolEntry(std::move(entry->texture)));
+  ReturnTextureToPool(std::move(entry->texture));
 
   return textures_by_address.erase(iter);
 }
@@ -1531,6 +1688,28 @@ void TextureCacheBase::TCacheEntry::SetEfbCopy(u32 stride)
   size_in_bytes = memory_stride * NumBlocksY();
 }
 
+bool TextureCacheBase::TCacheEntry::IsUnmodifiedSinceHashed() const
+{
+  if (write_epoch == 0 || Memory::WasRangeWrittenSince(addr, size_in_bytes, write_epoch))
+    return false;
+
+#if defined(_DEBUG) || defined(DEBUGFAST)
+  // A writer which doesn't call Memory::NotifyWrite() leaves its pages looking clean, so make sure
+  // the memory still hashes to what it did when the epoch was recorded.
+  const u64 current_hash = CalculateHash();
+  const u64 recorded_hash = IsEfbCopy() ? hash : base_hash;
+  if (current_hash != recorded_hash)
+  {
+    _dbg_assert_msg_(VIDEO, false,
+                     "Untracked write to texture memory at 0x%08x (%u bytes) since epoch %u", addr,
+                     size_in_bytes, write_epoch);
+    return false;
+  }
+#endif
+
+  return true;
+}
+
 u64 TextureCacheBase::TCacheEntry::CalculateHash() const
 {
   u8* ptr = Memory::GetPointer(addr);
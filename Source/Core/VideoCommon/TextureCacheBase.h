@@ -7,6 +7,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -47,6 +48,15 @@ public:
     // used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
     int frameCount = FRAMECOUNT_INVALID;
 
+    // Memory write epoch at which the hash was last known to match RAM, or 0 if the backing
+    // memory isn't write tracked. See Memory::WasRangeWrittenSince.
+    u32 write_epoch = 0;
+
+    // Custom texture that was still loading when this entry was created, so the native texture
+    // is used as a placeholder until it becomes resident. See HiresTexture::Search.
+    std::string pending_custom_tex;
+    u32 custom_tex_generation = 0;
+
     // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
     // removing the cache entry
     std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
@@ -99,6 +109,7 @@ public:
     u32 BytesPerRow() const;
 
     u64 CalculateHash() const;
+    bool IsUnmodifiedSinceHashed() const;
 
     u32 GetWidth() const { return texture->GetConfig().width; }
     u32 GetHeight() const { return texture->GetConfig().height; }
@@ -164,8 +175,12 @@ private:
   struct TexPoolEntry
   {
     std::unique_ptr<AbstractTexture> texture;
+    size_t size;
     int frameCount = FRAMECOUNT_INVALID;
-    TexPoolEntry(std::unique_ptr<AbstractTexture> tex) : texture(std::move(tex)) {}
+    TexPoolEntry(std::unique_ptr<AbstractTexture> tex, size_t tex_size)
+        : texture(std::move(tex)), size(tex_size)
+    {
+    }
   };
   typedef std::multimap<u32, TCacheEntry*> TexAddrCache;
   typedef std::multimap<u64, TCacheEntry*> TexHashCache;
@@ -175,6 +190,11 @@ private:
 
   TCacheEntry* ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, u32 tlutfmt);
 
+  // Returns the base hash of an existing, write tracked entry for this range whose memory hasn't
+  // been written since it was hashed, or TEXHASH_INVALID if there is none.
+  u64 GetUnmodifiedBaseHash(u32 address, u32 size_in_bytes) const;
+  bool IsPendingCustomTextureReady(TCacheEntry* entry) const;
+
   void ScaleTextureCacheEntryTo(TCacheEntry* entry, u32 new_width, u32 new_height);
   TCacheEntry* DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* palette, u32 tlutfmt);
 
@@ -184,6 +204,10 @@ private:
   TCacheEntry* AllocateCacheEntry(const TextureConfig& config);
   std::unique_ptr<AbstractTexture> AllocateTexture(const TextureConfig& config);
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
+  void ReturnTextureToPool(std::unique_ptr<AbstractTexture> texture);
+  TexPool::iterator RemoveTextureFromPool(TexPool::iterator iter);
+  // Frees the least recently pooled textures until the pool fits in its memory budget.
+  void TrimTexturePool();
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
   // Return all possible overlapping textures. As addr+size of the textures is not
@@ -205,6 +229,7 @@ private:
   TexAddrCache textures_by_address;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
+  size_t texture_pool_bytes = 0;
 
   // Backup configuration values
   struct BackupConfig
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 
@@ -65,6 +67,86 @@ static void SkipVertex(VertexLoader* loader)
   }
 }
 
+namespace
+{
+// A pipeline with all stages known at compile time, so they are inlined into a single loop.
+template <TPipelineFunction... stages>
+struct SpecializedPipeline
+{
+  static bool Matches(const TPipelineFunction* pipeline, int num_stages)
+  {
+    static const TPipelineFunction expected[] = {stages...};
+    return num_stages == static_cast<int>(sizeof...(stages)) &&
+           std::equal(expected, expected + num_stages, pipeline);
+  }
+
+  static void Run(VertexLoader* loader, int count)
+  {
+    for (loader->m_counter = count - 1; loader->m_counter >= 0; loader->m_counter--)
+    {
+      loader->m_tcIndex = 0;
+      loader->m_colIndex = 0;
+      loader->m_texmtxwrite = loader->m_texmtxread = 0;
+      // Braced initializers are evaluated in order.
+      const int unused[] = {(stages(loader), 0)...};
+      (void)unused;
+      PRIM_LOG("\n");
+    }
+  }
+};
+
+struct SpecializedLoop
+{
+  bool (*matches)(const TPipelineFunction* pipeline, int num_stages);
+  TPipelineLoop run;
+};
+
+template <TPipelineFunction... stages>
+constexpr SpecializedLoop Specialize()
+{
+  return {SpecializedPipeline<stages...>::Matches, SpecializedPipeline<stages...>::Run};
+}
+
+// The formats showing up most often in VertexLoadersToString(). Indexed positions always end with
+// SkipVertex.
+const SpecializedLoop s_specialized_loops[] = {
+    // Direct formats, mostly used for 2D and menus.
+    Specialize<Pos_ReadDirect<float, 3>>(),
+    Specialize<Pos_ReadDirect<float, 3>, Color_ReadDirect_32b_8888>(),
+    Specialize<Pos_ReadDirect<float, 3>, TexCoord_ReadDirect<float, 2>>(),
+    Specialize<Pos_ReadDirect<float, 3>, Color_ReadDirect_32b_8888,
+               TexCoord_ReadDirect<float, 2>>(),
+    Specialize<Pos_ReadDirect<s16, 3>, Color_ReadDirect_32b_8888, TexCoord_ReadDirect<s16, 2>>(),
+    Specialize<Pos_ReadDirect<float, 3>, Normal_Direct<float, 1>::function,
+               TexCoord_ReadDirect<float, 2>>(),
+    Specialize<Pos_ReadDirect<float, 3>, Normal_Direct<float, 1>::function,
+               Color_ReadDirect_32b_8888, TexCoord_ReadDirect<float, 2>>(),
+
+    // Indexed formats, used for most models.
+    Specialize<Pos_ReadIndex<u16, float, 3>, TexCoord_ReadIndex<u16, float, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, s16, 3>, TexCoord_ReadIndex<u16, s16, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, float, 3>, Normal_Index<u16, float, 1>::function,
+               TexCoord_ReadIndex<u16, float, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, float, 3>, Normal_Index<u16, float, 1>::function,
+               Color_ReadIndex16_32b_8888, TexCoord_ReadIndex<u16, float, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, float, 3>, Normal_Index<u16, s16, 1>::function,
+               TexCoord_ReadIndex<u16, u16, 2>, TexCoord_ReadIndex<u16, float, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, s16, 3>, Normal_Index<u16, s8, 1>::function,
+               TexCoord_ReadIndex<u16, s16, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, s16, 3>, Normal_Index<u16, s16, 1>::function,
+               TexCoord_ReadIndex<u16, s16, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u16, s16, 3>, Normal_Index<u16, s8, 1>::function,
+               Color_ReadIndex16_32b_8888, TexCoord_ReadIndex<u16, s16, 2>, SkipVertex>(),
+    Specialize<Pos_ReadIndex<u8, s16, 3>, Normal_Index<u8, s8, 1>::function,
+               TexCoord_ReadIndex<u8, s16, 2>, SkipVertex>(),
+    Specialize<PosMtx_ReadDirect_UByte, Pos_ReadIndex<u16, float, 3>,
+               Normal_Index<u16, float, 1>::function, TexCoord_ReadIndex<u16, float, 2>,
+               SkipVertex>(),
+    Specialize<PosMtx_ReadDirect_UByte, Pos_ReadIndex<u16, s16, 3>,
+               Normal_Index<u16, s8, 1>::function, TexCoord_ReadIndex<u16, s16, 2>, SkipVertex>(),
+};
+}
+
 VertexLoader::VertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr)
     : VertexLoaderBase(vtx_desc, vtx_attr)
 {
@@ -72,6 +154,15 @@ VertexLoader::VertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr)
 
   CompileVertexTranslator();
 
+  for (const SpecializedLoop& loop : s_specialized_loops)
+  {
+    if (loop.matches(m_PipelineStages, m_numPipelineStages))
+    {
+      m_specialized_loop = loop.run;
+      break;
+    }
+  }
+
   // generate frac factors
   m_posScale = 1.0f / (1U << m_VtxAttr.PosFrac);
   for (int i = 0; i < 8; i++)
@@ -408,6 +499,12 @@ int VertexLoader::RunVertices(DataReader src, DataReader dst, int count)
   m_numLoadedVertices += count;
   m_skippedVertices = 0;
 
+  if (m_specialized_loop)
+  {
+    m_specialized_loop(this, count);
+    return count - m_skippedVertices;
+  }
+
   for (m_counter = count - 1; m_counter >= 0; m_counter--)
   {
     m_tcIndex = 0;
@@ -15,6 +15,7 @@
 class DataReader;
 class VertexLoader;
 typedef void (*TPipelineFunction)(VertexLoader* loader);
+typedef void (*TPipelineLoop)(VertexLoader* loader, int count);
 
 class VertexLoader : public VertexLoaderBase
 {
@@ -24,6 +25,7 @@ public:
   int RunVertices(DataReader src, DataReader dst, int count) override;
   std::string GetName() const override { return "OldLoader"; }
   bool IsInitialized() override { return true; }  // This vertex loader supports all formats
+  bool IsSpecialized() const { return m_specialized_loop != nullptr; }
   // They are used for the communication with the loader functions
   float m_posScale;
   float m_tcScale[8];
@@ -45,6 +47,10 @@ private:
   TPipelineFunction m_PipelineStages[64];  // TODO - figure out real max. it's lower.
   int m_numPipelineStages;
 
+  // Common pipelines have a loop with all stages inlined, generated from templates in
+  // VertexLoader.cpp. Everything else calls the stages one by one.
+  TPipelineLoop m_specialized_loop = nullptr;
+
   void CompileVertexTranslator();
 
   void WriteCall(TPipelineFunction);
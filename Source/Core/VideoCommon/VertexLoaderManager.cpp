@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -24,6 +25,7 @@
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace VertexLoaderManager
 {
@@ -186,20 +188,13 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
+int GetVertexSize(int vtx_attr_group)
 {
-  if (!count)
-    return 0;
-
-  VertexLoaderBase* loader = RefreshLoader(vtx_attr_group, is_preprocess);
-
-  int size = count * loader->m_VertexSize;
-  if ((int)src.size() < size)
-    return -1;
-
-  if (is_preprocess)
-    return size;
+  return RefreshLoader(vtx_attr_group)->m_VertexSize;
+}
 
+static DataReader PrepareForVertices(VertexLoaderBase* loader, int primitive, int count)
+{
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
@@ -214,17 +209,120 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   // slope.
   bool cullall = (bpmem.genMode.cullmode == GenMode::CULL_ALL && primitive < 5);
 
-  DataReader dst = g_vertex_manager->PrepareForAdditionalData(
-      primitive, count, loader->m_native_vtx_decl.stride, cullall);
+  return g_vertex_manager->PrepareForAdditionalData(primitive, count,
+                                                    loader->m_native_vtx_decl.stride, cullall);
+}
 
-  count = loader->RunVertices(src, dst, count);
+// Vertices only repeat within a draw when they are built from indexed attributes.
+static bool ShouldDeduplicate(int count)
+{
+  if (!g_ActiveConfig.bDeduplicateVertices || count < 4)
+    return false;
 
-  IndexGenerator::AddIndices(primitive, count);
+  for (int i = 0; i < 12; i++)
+  {
+    if (g_main_cp_state.vtx_desc.GetVertexArrayStatus(i) & MASK_INDEXED)
+      return true;
+  }
+  return false;
+}
+
+static void FinishVertices(VertexLoaderBase* loader, int primitive, int count, u8* data)
+{
+  const u32 stride = loader->m_native_vtx_decl.stride;
+  u32 vertices = count;
+  if (ShouldDeduplicate(count))
+  {
+    vertices = IndexGenerator::AddDeduplicatedIndices(primitive, count, data, stride);
+    ADDSTAT(stats.thisFrame.bytesVertexDeduplicated, (count - vertices) * stride);
+  }
+  else
+  {
+    IndexGenerator::AddIndices(primitive, count);
+  }
 
-  g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
+  g_vertex_manager->FlushData(vertices, stride);
 
   ADDSTAT(stats.thisFrame.numPrims, count);
   INCSTAT(stats.thisFrame.numPrimitiveJoins);
+}
+
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
+{
+  if (!count)
+    return 0;
+
+  VertexLoaderBase* loader = RefreshLoader(vtx_attr_group, is_preprocess);
+
+  int size = count * loader->m_VertexSize;
+  if ((int)src.size() < size)
+    return -1;
+
+  if (is_preprocess)
+    return size;
+
+  DataReader dst = PrepareForVertices(loader, primitive, count);
+  u8* const output = dst.GetPointer();
+
+  count = loader->RunVertices(src, dst, count);
+
+  FinishVertices(loader, primitive, count, output);
+  return size;
+}
+
+int RunCachedVertices(int vtx_attr_group, int primitive, int count, DataReader src,
+                      ConvertedVertices* converted)
+{
+  if (!count)
+    return 0;
+
+  VertexLoaderBase* loader = RefreshLoader(vtx_attr_group);
+
+  int size = count * loader->m_VertexSize;
+  if ((int)src.size() != size)
+    return -1;
+
+  DataReader dst = PrepareForVertices(loader, primitive, count);
+  u8* const output = dst.GetPointer();
+
+  if (converted->loader == loader)
+  {
+    // Same vertex format and the caller guarantees the same raw data, so the loader would produce
+    // the same output again. Restore its side effects as well.
+    std::memcpy(output, converted->data.data(), converted->data.size());
+    std::memcpy(position_cache, converted->position_cache, sizeof(position_cache));
+    std::memcpy(position_matrix_index, converted->position_matrix_index,
+                sizeof(position_matrix_index));
+    loader->m_numLoadedVertices += count;
+    count = converted->count;
+  }
+  else
+  {
+    count = loader->RunVertices(src, dst, count);
+
+    // Indexed attributes are read from the vertex arrays, which can change independently of the
+    // raw data. The zfreeze position cache needs at least three vertices to be fully written.
+    bool cacheable = count >= 3;
+    for (int i = 0; i < 12; i++)
+      cacheable &= !(g_main_cp_state.vtx_desc.GetVertexArrayStatus(i) & MASK_INDEXED);
+
+    if (cacheable)
+    {
+      converted->loader = loader;
+      converted->count = count;
+      converted->data.assign(output, output + count * loader->m_native_vtx_decl.stride);
+      std::memcpy(converted->position_cache, position_cache, sizeof(position_cache));
+      std::memcpy(converted->position_matrix_index, position_matrix_index,
+                  sizeof(position_matrix_index));
+    }
+    else
+    {
+      converted->loader = nullptr;
+      converted->data.clear();
+    }
+  }
+
+  FinishVertices(loader, primitive, count, output);
   return size;
 }
 
@@ -7,11 +7,13 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
 class DataReader;
 class NativeVertexFormat;
+class VertexLoaderBase;
 struct PortableVertexDeclaration;
 
 namespace VertexLoaderManager
@@ -29,6 +31,26 @@ NativeVertexFormatMap* GetNativeVertexFormatMap();
 // Returns -1 if buf_size is insufficient, else the amount of bytes consumed
 int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess);
 
+// Size of a raw vertex in the current format of the given vertex attribute group.
+int GetVertexSize(int vtx_attr_group);
+
+// Output of a previous RunCachedVertices call.
+struct ConvertedVertices
+{
+  VertexLoaderBase* loader = nullptr;
+  int count = 0;
+  std::vector<u8> data;
+  float position_cache[3][4];
+  u32 position_matrix_index[4];
+};
+
+// Like RunVertices, for raw vertex data that is known to be identical to the last call with the
+// same converted object. If the same vertex loader is selected again, the stored output is copied
+// instead of running the loader. src must hold exactly the vertices to be drawn, -1 is returned
+// without loading anything if the current vertex size doesn't match it.
+int RunCachedVertices(int vtx_attr_group, int primitive, int count, DataReader src,
+                      ConvertedVertices* converted);
+
 // For debugging
 std::string VertexLoadersToString();
 
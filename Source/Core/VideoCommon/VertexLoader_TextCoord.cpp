@@ -4,87 +4,8 @@
 
 #include "VideoCommon/VertexLoader_TextCoord.h"
 
-#include <type_traits>
-
 #include "Common/CommonTypes.h"
-#include "Common/Swap.h"
-
-#include "VideoCommon/DataReader.h"
 #include "VideoCommon/VertexLoader.h"
-#include "VideoCommon/VertexLoaderManager.h"
-#include "VideoCommon/VertexLoaderUtils.h"
-
-template <int N>
-void LOG_TEX();
-
-template <>
-void LOG_TEX<1>()
-{
-  // warning: mapping buffer should be disabled to use this
-  // PRIM_LOG("tex: %f, ", ((float*)g_vertex_manager_write_ptr)[-1]);
-}
-
-template <>
-void LOG_TEX<2>()
-{
-  // warning: mapping buffer should be disabled to use this
-  // PRIM_LOG("tex: %f %f, ", ((float*)g_vertex_manager_write_ptr)[-2],
-  // ((float*)g_vertex_manager_write_ptr)[-1]);
-}
-
-static void TexCoord_Read_Dummy(VertexLoader* loader)
-{
-  loader->m_tcIndex++;
-}
-
-template <typename T>
-float TCScale(T val, float scale)
-{
-  return val * scale;
-}
-
-template <>
-float TCScale(float val, float scale)
-{
-  return val;
-}
-
-template <typename T, int N>
-void TexCoord_ReadDirect(VertexLoader* loader)
-{
-  auto const scale = loader->m_tcScale[loader->m_tcIndex];
-  DataReader dst(g_vertex_manager_write_ptr, nullptr);
-  DataReader src(g_video_buffer_read_ptr, nullptr);
-
-  for (int i = 0; i != N; ++i)
-    dst.Write(TCScale(src.Read<T>(), scale));
-
-  g_vertex_manager_write_ptr = dst.GetPointer();
-  g_video_buffer_read_ptr = src.GetPointer();
-  LOG_TEX<N>();
-
-  ++loader->m_tcIndex;
-}
-
-template <typename I, typename T, int N>
-void TexCoord_ReadIndex(VertexLoader* loader)
-{
-  static_assert(std::is_unsigned<I>::value, "Only unsigned I is sane!");
-
-  auto const index = DataRead<I>();
-  auto const data = reinterpret_cast<const T*>(
-      VertexLoaderManager::cached_arraybases[ARRAY_TEXCOORD0 + loader->m_tcIndex] +
-      (index * g_main_cp_state.array_strides[ARRAY_TEXCOORD0 + loader->m_tcIndex]));
-  auto const scale = loader->m_tcScale[loader->m_tcIndex];
-  DataReader dst(g_vertex_manager_write_ptr, nullptr);
-
-  for (int i = 0; i != N; ++i)
-    dst.Write(TCScale(Common::FromBigEndian(data[i]), scale));
-
-  g_vertex_manager_write_ptr = dst.GetPointer();
-  LOG_TEX<N>();
-  ++loader->m_tcIndex;
-}
 
 static TPipelineFunction tableReadTexCoord[4][8][2] = {
     {
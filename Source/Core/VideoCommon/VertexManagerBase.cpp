@@ -11,6 +11,7 @@
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/Tracing.h"
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/BPMemory.h"
@@ -189,6 +190,8 @@ void VertexManagerBase::Flush()
   if (m_is_flushed)
     return;
 
+  TRACE_ZONE("VertexManager::Flush");
+
   // loading a state will invalidate BP, so check for it
   g_video_backend->CheckInvalidState();
 
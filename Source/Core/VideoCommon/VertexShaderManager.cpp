@@ -44,6 +44,17 @@ static float s_fViewRotation[2];
 
 VertexShaderConstants VertexShaderManager::constants;
 bool VertexShaderManager::dirty;
+ConstantUploadTracker VertexShaderManager::upload_tracker(sizeof(VertexShaderConstants));
+
+// Every change to the constants goes through here, so the upload check only needs to compare the
+// parts that were written.
+static void SetConstantsDirty(const void* begin, size_t size)
+{
+  VertexShaderManager::dirty = true;
+  VertexShaderManager::upload_tracker.AddDirtyRange(
+      static_cast<const u8*>(begin) - reinterpret_cast<const u8*>(&VertexShaderManager::constants),
+      size);
+}
 
 struct ProjectionHack
 {
@@ -205,6 +216,7 @@ void VertexShaderManager::Init()
     g_fProjectionMatrix[i * 5] = 1.0f;
 
   dirty = true;
+  upload_tracker.Invalidate();
 }
 
 void VertexShaderManager::Dirty()
@@ -214,6 +226,7 @@ void VertexShaderManager::Dirty()
   bProjectionChanged = true;
 
   dirty = true;
+  upload_tracker.Invalidate();
 }
 
 // Syncs the shader constant buffers with xfmem
@@ -226,7 +239,7 @@ void VertexShaderManager::SetConstants()
     int endn = (nTransformMatricesChanged[1] + 3) / 4;
     memcpy(constants.transformmatrices[startn], &xfmem.posMatrices[startn * 4],
            (endn - startn) * sizeof(float4));
-    dirty = true;
+    SetConstantsDirty(constants.transformmatrices[startn], (endn - startn) * sizeof(float4));
     nTransformMatricesChanged[0] = nTransformMatricesChanged[1] = -1;
   }
 
@@ -238,7 +251,7 @@ void VertexShaderManager::SetConstants()
     {
       memcpy(constants.normalmatrices[i], &xfmem.normalMatrices[3 * i], 12);
     }
-    dirty = true;
+    SetConstantsDirty(constants.normalmatrices[startn], (endn - startn) * sizeof(float4));
     nNormalMatricesChanged[0] = nNormalMatricesChanged[1] = -1;
   }
 
@@ -248,7 +261,7 @@ void VertexShaderManager::SetConstants()
     int endn = (nPostTransformMatricesChanged[1] + 3) / 4;
     memcpy(constants.posttransformmatrices[startn], &xfmem.postMatrices[startn * 4],
            (endn - startn) * sizeof(float4));
-    dirty = true;
+    SetConstantsDirty(constants.posttransformmatrices[startn], (endn - startn) * sizeof(float4));
     nPostTransformMatricesChanged[0] = nPostTransformMatricesChanged[1] = -1;
   }
 
@@ -300,7 +313,8 @@ void VertexShaderManager::SetConstants()
       dstlight.dir[1] = light.ddir[1] * norm_float;
       dstlight.dir[2] = light.ddir[2] * norm_float;
     }
-    dirty = true;
+    SetConstantsDirty(&constants.lights[istart],
+                      (iend - istart) * sizeof(VertexShaderConstants::Light));
 
     nLightsChanged[0] = nLightsChanged[1] = -1;
   }
@@ -312,7 +326,7 @@ void VertexShaderManager::SetConstants()
     constants.materials[i][1] = (data >> 16) & 0xFF;
     constants.materials[i][2] = (data >> 8) & 0xFF;
     constants.materials[i][3] = data & 0xFF;
-    dirty = true;
+    SetConstantsDirty(constants.materials[i], sizeof(constants.materials[i]));
   }
   nMaterialsChanged = BitSet32(0);
 
@@ -328,7 +342,7 @@ void VertexShaderManager::SetConstants()
     memcpy(constants.posnormalmatrix[3], norm, 3 * sizeof(float));
     memcpy(constants.posnormalmatrix[4], norm + 3, 3 * sizeof(float));
     memcpy(constants.posnormalmatrix[5], norm + 6, 3 * sizeof(float));
-    dirty = true;
+    SetConstantsDirty(constants.posnormalmatrix, sizeof(constants.posnormalmatrix));
   }
 
   if (bTexMatricesChanged[0])
@@ -344,7 +358,7 @@ void VertexShaderManager::SetConstants()
     {
       memcpy(constants.texmatrices[3 * i], pos_matrix_ptrs[i], 3 * sizeof(float4));
     }
-    dirty = true;
+    SetConstantsDirty(constants.texmatrices[0], 12 * sizeof(float4));
   }
 
   if (bTexMatricesChanged[1])
@@ -360,7 +374,7 @@ void VertexShaderManager::SetConstants()
     {
       memcpy(constants.texmatrices[3 * i + 12], pos_matrix_ptrs[i], 3 * sizeof(float4));
     }
-    dirty = true;
+    SetConstantsDirty(constants.texmatrices[12], 12 * sizeof(float4));
   }
 
   if (bViewportChanged)
@@ -417,7 +431,8 @@ void VertexShaderManager::SetConstants()
       }
     }
 
-    dirty = true;
+    SetConstantsDirty(constants.pixelcentercorrection, sizeof(constants.pixelcentercorrection));
+    SetConstantsDirty(constants.viewport, sizeof(constants.viewport));
     // This is so implementation-dependent that we can't have it here.
     g_renderer->SetViewport();
 
@@ -559,7 +574,7 @@ void VertexShaderManager::SetConstants()
       memcpy(constants.projection, correctedMtx.data, 4 * sizeof(float4));
     }
 
-    dirty = true;
+    SetConstantsDirty(constants.projection, sizeof(constants.projection));
   }
 }
 
@@ -8,6 +8,7 @@
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/ConstantManager.h"
+#include "VideoCommon/ConstantUploadTracker.h"
 
 class PointerWrap;
 struct ProjectionHackConfig;
@@ -44,4 +45,5 @@ public:
 
   static VertexShaderConstants constants;
   static bool dirty;
+  static ConstantUploadTracker upload_tracker;
 };
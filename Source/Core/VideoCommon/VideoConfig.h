@@ -132,7 +132,9 @@ struct VideoConfig final
   float fAspectRatioHackW, fAspectRatioHackH;
   bool bEnablePixelLighting;
   bool bFastDepthCalc;
+  bool bDeduplicateVertices;
   bool bVertexRounding;
+  bool bDisplayListCache;
   int iLog;           // CONF_ bits
   int iSaveTargetId;  // TODO: Should be dropped
 
@@ -18,6 +18,9 @@ u8 DSP::Host::ReadHostMemory(u32 addr)
 void DSP::Host::WriteHostMemory(u8 value, u32 addr)
 {
 }
+void DSP::Host::MainMemoryWritten(u32 addr, u32 size)
+{
+}
 void DSP::Host::OSD_AddMessage(const std::string& str, u32 ms)
 {
 }
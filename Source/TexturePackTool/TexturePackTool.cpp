@@ -0,0 +1,60 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/HiresTextures.h"
+
+// Builds a custom texture pack from a texture directory:
+//   texturepacktool <texture directory> <output file>
+// Dolphin picks up packs named <game id>.dtp in the Load/Textures directory.
+int main(int argc, const char* argv[])
+{
+  if (argc != 3 || !strcmp(argv[1], "--help") || !strcmp(argv[1], "-?"))
+  {
+    printf("USAGE: TexturePackTool <TEXTURE DIRECTORY> <OUTPUT FILE>\n");
+    printf("Converts a directory of custom textures into a single pack file.\n");
+    printf("Name the output <GAME ID>.dtp and place it next to the texture directories.\n");
+    return argc == 1 ? 0 : 1;
+  }
+
+  const std::string texture_directory = argv[1];
+  const std::string pack_path = argv[2];
+  if (!File::IsDirectory(texture_directory))
+  {
+    fprintf(stderr, "%s is not a directory\n", texture_directory.c_str());
+    return 1;
+  }
+
+  u32 converted = 0;
+  u32 failed = 0;
+  const bool success = HiresTexture::BuildPack(
+      texture_directory, pack_path, [&](const std::string& name, bool loaded) {
+        if (loaded)
+        {
+          converted++;
+        }
+        else
+        {
+          failed++;
+          fprintf(stderr, "Failed to load %s, skipping\n", name.c_str());
+        }
+      });
+
+  if (!success)
+  {
+    fprintf(stderr, "Failed to write %s\n", pack_path.c_str());
+    return 1;
+  }
+
+  printf("Wrote %u textures to %s", converted, pack_path.c_str());
+  if (failed)
+    printf(", %u failed to load", failed);
+  printf("\n");
+  return 0;
+}
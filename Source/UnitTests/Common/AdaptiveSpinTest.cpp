@@ -0,0 +1,49 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Common/AdaptiveSpin.h"
+#include "Common/Event.h"
+
+TEST(AdaptiveSpin, SpinGivesUp)
+{
+  Common::AdaptiveSpin spin;
+  EXPECT_TRUE(spin.Spin([] { return true; }));
+  EXPECT_FALSE(spin.Spin([] { return false; }));
+}
+
+TEST(AdaptiveSpin, HandOff)
+{
+  Common::AdaptiveSpin spin;
+  Common::Event event;
+  std::atomic<int> sent(0);
+
+  std::thread sender([&] {
+    for (int i = 0; i < 1000; i++)
+    {
+      if (i % 100 == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      sent++;
+      spin.Notify();
+      event.Set();
+    }
+  });
+
+  for (int received = 0; received < 1000;)
+  {
+    if (!spin.Spin([&] { return sent.load() > received; }))
+      spin.Block([&] { event.Wait(); });
+    received = sent.load();
+  }
+  sender.join();
+
+  // The sender sleeps for at least 10 ms in total, all of which the receiver waits for.
+  EXPECT_GE(spin.TakeWaitTime(), 9000u);
+  EXPECT_EQ(0u, spin.TakeWaitTime());
+}
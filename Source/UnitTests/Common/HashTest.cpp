@@ -0,0 +1,130 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+
+namespace
+{
+constexpr Hash64Function XXH3_VARIANTS[] = {Hash64Function::XXH3SSE2, Hash64Function::XXH3AVX2,
+                                            Hash64Function::XXH3NEON};
+
+std::vector<u8> MakeTestData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 state = 0x12345678;
+  for (u8& byte : data)
+  {
+    state = state * 1664525 + 1013904223;
+    byte = static_cast<u8>(state >> 24);
+  }
+  return data;
+}
+
+u64 HashWith(Hash64Function function, const u8* src, u32 len, u32 samples)
+{
+  SetHash64Function(function);
+  return GetHash64(src, len, samples);
+}
+}  // Anonymous namespace
+
+TEST(Hash, XXH3VariantsMatchGeneric)
+{
+  const std::vector<u8> data = MakeTestData(70000);
+  const u32 sizes[] = {0,   1,   3,   4,    8,    9,    16,   17,    33,   65,
+                        97,  128, 129, 191, 192, 1000, 1024, 4096, 32768, 65536};
+
+  for (Hash64Function function : XXH3_VARIANTS)
+  {
+    if (!IsHash64FunctionSupported(function))
+      continue;
+
+    for (u32 offset : {0, 1, 3})
+    {
+      for (u32 size : sizes)
+      {
+        for (u32 samples : {0, 1, 128})
+        {
+          const u8* src = data.data() + offset;
+          EXPECT_EQ(HashWith(Hash64Function::XXH3Generic, src, size, samples),
+                    HashWith(function, src, size, samples))
+              << "function " << static_cast<int>(function) << " offset " << offset << " size "
+              << size << " samples " << samples;
+        }
+      }
+    }
+  }
+
+  SetHash64Function();
+}
+
+TEST(Hash, XXH3DistinguishesInputs)
+{
+  SetHash64Function(Hash64Function::XXH3Generic);
+
+  // Zero-filled inputs of different lengths must not collide, whichever code path they take.
+  const std::vector<u8> zeroes(300);
+  for (u32 size = 1; size < zeroes.size(); ++size)
+    EXPECT_NE(GetHash64(zeroes.data(), size - 1, 0), GetHash64(zeroes.data(), size, 0));
+
+  std::vector<u8> data = MakeTestData(4096);
+  const u64 original = GetHash64(data.data(), static_cast<u32>(data.size()), 0);
+  for (size_t i = 0; i < data.size(); i += 61)
+  {
+    data[i] ^= 1;
+    EXPECT_NE(original, GetHash64(data.data(), static_cast<u32>(data.size()), 0)) << i;
+    data[i] ^= 1;
+  }
+
+  SetHash64Function();
+}
+
+TEST(Hash, HiresTextureHashIsStable)
+{
+  // Custom texture packs are named after this hash, so these values must never change.
+  const std::vector<u8> data = MakeTestData(4096);
+  EXPECT_EQ(0xeee605720d14b575ULL, GetHashHiresTexture(data.data(), 4096, 0));
+  EXPECT_EQ(0x26c1980be08d49f1ULL, GetHashHiresTexture(data.data(), 4096, 128));
+  EXPECT_EQ(0xd1e678c25056fae3ULL, GetHashHiresTexture(data.data(), 13, 0));
+}
+
+// Not run by default. Use --gtest_also_run_disabled_tests to print throughput numbers.
+TEST(Hash, DISABLED_Throughput)
+{
+  const std::vector<u8> data = MakeTestData(4 * 1024 * 1024);
+  const std::pair<Hash64Function, const char*> functions[] = {
+      {Hash64Function::MurmurHash3, "MurmurHash3"}, {Hash64Function::CRC32, "CRC32"},
+      {Hash64Function::XXH3Generic, "XXH3Generic"}, {Hash64Function::XXH3SSE2, "XXH3SSE2"},
+      {Hash64Function::XXH3AVX2, "XXH3AVX2"},       {Hash64Function::XXH3NEON, "XXH3NEON"},
+  };
+
+  for (const auto& function : functions)
+  {
+    if (!IsHash64FunctionSupported(function.first))
+      continue;
+    SetHash64Function(function.first);
+
+    for (u32 size = 32; size <= data.size(); size *= 4)
+    {
+      const u32 iterations = std::max<u32>(1, (64 * 1024 * 1024) / size);
+      u64 sink = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (u32 i = 0; i < iterations; ++i)
+        sink += GetHash64(data.data(), size, 0);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      const double mb_per_second = double(size) * iterations / elapsed.count() / (1024 * 1024);
+      std::printf("%-12s %8u bytes: %10.1f MB/s (%016llx)\n", function.second, size, mb_per_second,
+                  static_cast<unsigned long long>(sink));
+    }
+  }
+
+  SetHash64Function();
+}
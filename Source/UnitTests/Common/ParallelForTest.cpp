@@ -0,0 +1,37 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/ParallelFor.h"
+
+TEST(ParallelFor, CoversEveryIndexOnce)
+{
+  for (size_t count : {0, 1, 7, 1000, 12345})
+  {
+    std::vector<std::atomic<int>> visits(count);
+    Common::ParallelFor(count, 10, [&](size_t begin, size_t end) {
+      EXPECT_LT(begin, end);
+      for (size_t i = begin; i < end; i++)
+        visits[i]++;
+    });
+
+    for (size_t i = 0; i < count; i++)
+      EXPECT_EQ(1, visits[i].load()) << "count " << count << ", index " << i;
+  }
+}
+
+TEST(ParallelFor, SmallInputsRunOnCallingThread)
+{
+  const std::thread::id caller = std::this_thread::get_id();
+  Common::ParallelFor(100, 100, [&](size_t begin, size_t end) {
+    EXPECT_EQ(caller, std::this_thread::get_id());
+    EXPECT_EQ(0u, begin);
+    EXPECT_EQ(100u, end);
+  });
+}
@@ -0,0 +1,66 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/SymbolDB.h"
+
+namespace
+{
+class TestSymbolDB : public SymbolDB
+{
+public:
+  Symbol* GetSymbolFromAddr(u32 addr) override { return GetSymbolContaining(addr); }
+
+  void Add(u32 address, int size, const std::string& name, u32 hash = 0)
+  {
+    Symbol symbol;
+    symbol.address = address;
+    symbol.size = size;
+    symbol.name = name;
+    symbol.function_name = name;
+    symbol.hash = hash;
+    symbol.type = Symbol::Type::Function;
+    AddCompleteSymbol(symbol);
+  }
+};
+}
+
+TEST(SymbolDB, LookupByAddress)
+{
+  TestSymbolDB db;
+  db.Add(0x80001000, 0x100, "outer");
+  db.Add(0x80001010, 0x10, "nested");
+  db.Add(0x80002000, 0x20, "after");
+
+  EXPECT_EQ(nullptr, db.GetSymbolFromAddr(0x80000ffc));
+  EXPECT_EQ("outer", db.GetSymbolFromAddr(0x80001000)->name);
+  EXPECT_EQ("outer", db.GetSymbolFromAddr(0x80001014)->name);
+  EXPECT_EQ("outer", db.GetSymbolFromAddr(0x80001080)->name);
+  EXPECT_EQ(nullptr, db.GetSymbolFromAddr(0x80001100));
+  EXPECT_EQ("after", db.GetSymbolFromAddr(0x8000201c)->name);
+  EXPECT_EQ(nullptr, db.GetSymbolFromAddr(0x80002020));
+}
+
+TEST(SymbolDB, LookupByNameAndHash)
+{
+  TestSymbolDB db;
+  db.Add(0x80001000, 0x10, "memcpy", 0x1234);
+  db.Add(0x80002000, 0x10, "memcpy", 0x1234);
+  db.Add(0x80003000, 0x10, "memset", 0x5678);
+
+  EXPECT_EQ(2u, db.GetSymbolsFromName("memcpy").size());
+  EXPECT_EQ(0x80003000u, db.GetSymbolFromName("memset")->address);
+  EXPECT_EQ(nullptr, db.GetSymbolFromName("strlen"));
+  EXPECT_EQ(2u, db.GetSymbolsFromHash(0x1234).size());
+  EXPECT_EQ(nullptr, db.GetSymbolFromHash(0x9abc));
+
+  // Renamed symbols are found under their new name once the database is reindexed.
+  db.GetSymbolFromName("memset")->function_name = "bzero";
+  db.Index();
+  EXPECT_EQ(nullptr, db.GetSymbolFromName("memset"));
+  EXPECT_EQ(0x80003000u, db.GetSymbolFromName("bzero")->address);
+}
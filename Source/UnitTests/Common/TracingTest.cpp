@@ -0,0 +1,53 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Common/FileUtil.h"
+#include "Common/Tracing.h"
+
+TEST(Tracing, ZonesOnlyRecordedWhileRecording)
+{
+  const std::string directory = File::CreateTempDir();
+  const std::string path = directory + "/trace.json";
+
+  {
+    TRACE_ZONE("BeforeStart");
+  }
+
+  Common::Tracing::Start();
+  EXPECT_TRUE(Common::Tracing::IsRecording());
+  {
+    TRACE_ZONE("Outer");
+    {
+      TRACE_ZONE_IF("Skipped", false);
+    }
+  }
+  std::thread thread([] {
+    Common::Tracing::SetThreadName("Worker");
+    TRACE_ZONE("OnWorker");
+  });
+  thread.join();
+  ASSERT_TRUE(Common::Tracing::Stop(path));
+  EXPECT_FALSE(Common::Tracing::IsRecording());
+
+  {
+    TRACE_ZONE("AfterStop");
+  }
+
+  std::string json;
+  ASSERT_TRUE(File::ReadFileToString(path, json));
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"Outer\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"OnWorker\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"name\":\"Worker\"}"));
+  EXPECT_EQ(std::string::npos, json.find("Skipped"));
+  EXPECT_EQ(std::string::npos, json.find("BeforeStart"));
+  EXPECT_EQ(std::string::npos, json.find("AfterStop"));
+
+  File::DeleteDirRecursively(directory);
+}
@@ -0,0 +1,160 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+
+class FifoDataFileTest : public testing::Test
+{
+protected:
+  FifoDataFileTest() : m_directory(File::CreateTempDir()), m_path(m_directory + "/test.dff") {}
+  ~FifoDataFileTest() override { File::DeleteDirRecursively(m_directory); }
+
+  static FifoFrameInfo MakeFrame(u32 index)
+  {
+    FifoFrameInfo frame;
+    frame.fifoData.resize(1000 + index * 100);
+    for (size_t i = 0; i < frame.fifoData.size(); i++)
+      frame.fifoData[i] = static_cast<u8>(i * index);
+    frame.fifoStart = 0x100 * index;
+    frame.fifoEnd = 0x200 * index;
+    frame.cpState.vtxDesc[0] = index;
+    frame.cpState.vtxAttr[7][2] = 0x80000000 | index;
+
+    for (u32 i = 0; i < index; i++)
+    {
+      MemoryUpdate update;
+      update.fifoPosition = 10 * i;
+      update.address = 0x80000000 + i * 0x1000;
+      update.data.assign(64 * (i + 1), static_cast<u8>(index + i));
+      update.type = MemoryUpdate::TEXTURE_MAP;
+      frame.memoryUpdates.push_back(update);
+    }
+    return frame;
+  }
+
+  static void ExpectSameFrame(const FifoFrameInfo& expected, const FifoFrameInfo& actual)
+  {
+    EXPECT_EQ(expected.fifoData, actual.fifoData);
+    EXPECT_EQ(expected.fifoStart, actual.fifoStart);
+    EXPECT_EQ(expected.fifoEnd, actual.fifoEnd);
+    EXPECT_EQ(expected.cpState.vtxDesc[0], actual.cpState.vtxDesc[0]);
+    EXPECT_EQ(expected.cpState.vtxAttr[7][2], actual.cpState.vtxAttr[7][2]);
+    ASSERT_EQ(expected.memoryUpdates.size(), actual.memoryUpdates.size());
+    for (size_t i = 0; i < expected.memoryUpdates.size(); i++)
+    {
+      EXPECT_EQ(expected.memoryUpdates[i].fifoPosition, actual.memoryUpdates[i].fifoPosition);
+      EXPECT_EQ(expected.memoryUpdates[i].address, actual.memoryUpdates[i].address);
+      EXPECT_EQ(expected.memoryUpdates[i].data, actual.memoryUpdates[i].data);
+      EXPECT_EQ(expected.memoryUpdates[i].type, actual.memoryUpdates[i].type);
+    }
+  }
+
+  std::string m_directory;
+  std::string m_path;
+};
+
+TEST_F(FifoDataFileTest, RoundTrip)
+{
+  constexpr u32 FRAME_COUNT = 5;
+  {
+    FifoDataFile file;
+    file.SetIsWii(true);
+    file.GetBPMem()[0x28] = 0x12345678;
+    file.GetTexMem()[1000] = 0x42;
+    for (u32 i = 0; i < FRAME_COUNT; i++)
+      file.AddFrame(MakeFrame(i));
+
+    // Frames can be read back while recording.
+    ASSERT_EQ(FRAME_COUNT, file.GetFrameCount());
+    ExpectSameFrame(MakeFrame(3), file.GetFrame(3));
+    ASSERT_TRUE(file.Save(m_path));
+  }
+
+  std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(m_path, false);
+  ASSERT_NE(nullptr, file);
+  EXPECT_TRUE(file->GetIsWii());
+  EXPECT_FALSE(file->HasBrokenEFBCopies());
+  EXPECT_TRUE(file->HasFrameCPState());
+  EXPECT_EQ(0x12345678u, file->GetBPMem()[0x28]);
+  EXPECT_EQ(0x42, file->GetTexMem()[1000]);
+  ASSERT_EQ(FRAME_COUNT, file->GetFrameCount());
+
+  u64 fifo_size = 0;
+  u64 memory_size = 0;
+  // Out of order on purpose, frames are read from the file when asked for.
+  for (u32 i = FRAME_COUNT; i-- > 0;)
+  {
+    const FifoFrameInfo expected = MakeFrame(i);
+    ExpectSameFrame(expected, file->GetFrame(i));
+    fifo_size += expected.fifoData.size();
+    for (const MemoryUpdate& update : expected.memoryUpdates)
+      memory_size += update.data.size();
+  }
+  EXPECT_EQ(fifo_size, file->GetFifoDataSize());
+  EXPECT_EQ(memory_size, file->GetMemoryUpdateSize());
+}
+
+TEST_F(FifoDataFileTest, FlagsOnly)
+{
+  {
+    FifoDataFile file;
+    file.SetIsWii(true);
+    file.AddFrame(MakeFrame(1));
+    ASSERT_TRUE(file.Save(m_path));
+  }
+
+  std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(m_path, true);
+  ASSERT_NE(nullptr, file);
+  EXPECT_TRUE(file->GetIsWii());
+  EXPECT_EQ(0u, file->GetFrameCount());
+}
+
+TEST_F(FifoDataFileTest, SaveOverLoadedFile)
+{
+  constexpr u32 FRAME_COUNT = 3;
+  {
+    FifoDataFile file;
+    for (u32 i = 0; i < FRAME_COUNT; i++)
+      file.AddFrame(MakeFrame(i));
+    ASSERT_TRUE(file.Save(m_path));
+  }
+
+  // The frames of a loaded file are read from it while it is being saved.
+  std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(m_path, false);
+  ASSERT_NE(nullptr, file);
+  ASSERT_TRUE(file->Save(m_path));
+  for (u32 i = 0; i < FRAME_COUNT; i++)
+    ExpectSameFrame(MakeFrame(i), file->GetFrame(i));
+
+  file = FifoDataFile::Load(m_path, false);
+  ASSERT_NE(nullptr, file);
+  ASSERT_EQ(FRAME_COUNT, file->GetFrameCount());
+  for (u32 i = 0; i < FRAME_COUNT; i++)
+    ExpectSameFrame(MakeFrame(i), file->GetFrame(i));
+}
+
+TEST_F(FifoDataFileTest, RejectsTruncatedFile)
+{
+  {
+    FifoDataFile file;
+    for (u32 i = 0; i < 3; i++)
+      file.AddFrame(MakeFrame(i));
+    ASSERT_TRUE(file.Save(m_path));
+  }
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(m_path, contents));
+  contents.resize(contents.size() - 16);
+  ASSERT_TRUE(File::WriteStringToFile(contents, m_path));
+
+  EXPECT_EQ(nullptr, FifoDataFile::Load(m_path, false));
+}
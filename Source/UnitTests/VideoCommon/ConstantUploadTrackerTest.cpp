@@ -0,0 +1,51 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ConstantUploadTracker.h"
+
+TEST(ConstantUploadTracker, SkipsUnchangedConstants)
+{
+  std::array<u32, 16> constants = {};
+  ConstantUploadTracker tracker(sizeof(constants));
+
+  EXPECT_TRUE(tracker.Update(constants.data()));
+  EXPECT_FALSE(tracker.Update(constants.data()));
+
+  constants[15] = 1;
+  EXPECT_TRUE(tracker.Update(constants.data()));
+  EXPECT_FALSE(tracker.Update(constants.data()));
+
+  tracker.Invalidate();
+  EXPECT_TRUE(tracker.Update(constants.data()));
+}
+
+TEST(ConstantUploadTracker, ComparesOnlyDirtyRanges)
+{
+  std::array<u32, 16> constants = {};
+  ConstantUploadTracker tracker(sizeof(constants));
+  tracker.Update(constants.data());
+
+  constants[2] = 1;
+  tracker.AddDirtyRange(2 * sizeof(u32), sizeof(u32));
+  constants[9] = 1;
+  tracker.AddDirtyRange(9 * sizeof(u32), sizeof(u32));
+  EXPECT_TRUE(tracker.Update(constants.data()));
+
+  // Rewriting the same values isn't a change.
+  tracker.AddDirtyRange(2 * sizeof(u32), 8 * sizeof(u32));
+  EXPECT_FALSE(tracker.Update(constants.data()));
+
+  // A change outside of the reported ranges is missed, the owner has to report all of them.
+  constants[12] = 1;
+  tracker.AddDirtyRange(0, sizeof(u32));
+  EXPECT_FALSE(tracker.Update(constants.data()));
+
+  // Without any range the whole block is compared.
+  EXPECT_TRUE(tracker.Update(constants.data()));
+}
@@ -0,0 +1,155 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Swap.h"
+#include "VideoCommon/HiresTexturePack.h"
+
+class HiresTexturePackTest : public testing::Test
+{
+protected:
+  HiresTexturePackTest()
+      : m_directory(File::CreateTempDir()), m_pack_path(m_directory + "/pack.dtp")
+  {
+  }
+  ~HiresTexturePackTest() override { File::DeleteDirRecursively(m_directory); }
+
+  std::string m_directory;
+  std::string m_pack_path;
+};
+
+TEST_F(HiresTexturePackTest, RoundTrip)
+{
+  std::vector<u8> rgba(16 * 8 * 4);
+  for (size_t i = 0; i < rgba.size(); i++)
+    rgba[i] = static_cast<u8>(i);
+  const std::vector<u8> dxt1(8, 0xab);
+  const std::vector<u8> mip(8 * 4 * 4, 0x11);
+
+  {
+    HiresTexturePack::Writer writer(m_pack_path);
+    ASSERT_TRUE(writer.IsOpen());
+    // Added out of order on purpose, the index has to be sorted by the writer.
+    ASSERT_TRUE(writer.AddTexture(
+        "tex1_4x4_0000000000000002_14", {{AbstractTextureFormat::DXT1, 4, 4, 4, dxt1.data(),
+                                          dxt1.size()}}));
+    ASSERT_TRUE(writer.AddTexture(
+        "tex1_16x8_m_0000000000000001_6",
+        {{AbstractTextureFormat::RGBA8, 16, 8, 16, rgba.data(), rgba.size()},
+         {AbstractTextureFormat::RGBA8, 8, 4, 8, mip.data(), mip.size()}}));
+    ASSERT_TRUE(writer.Finish());
+  }
+
+  std::shared_ptr<HiresTexturePack> pack = HiresTexturePack::Open(m_pack_path);
+  ASSERT_NE(nullptr, pack);
+  ASSERT_EQ(2u, pack->GetTextureCount());
+  EXPECT_EQ("tex1_16x8_m_0000000000000001_6", pack->GetTextureName(0));
+  EXPECT_EQ("tex1_4x4_0000000000000002_14", pack->GetTextureName(1));
+
+  EXPECT_TRUE(pack->Contains("tex1_4x4_0000000000000002_14"));
+  EXPECT_FALSE(pack->Contains("tex1_4x4_0000000000000002_1"));
+  EXPECT_FALSE(pack->Contains("tex1_4x4_0000000000000002_140"));
+  EXPECT_FALSE(pack->Contains(""));
+
+  std::vector<HiresTexturePack::Level> levels;
+  ASSERT_TRUE(pack->GetLevels("tex1_16x8_m_0000000000000001_6", &levels));
+  ASSERT_EQ(2u, levels.size());
+  EXPECT_EQ(AbstractTextureFormat::RGBA8, levels[0].format);
+  EXPECT_EQ(16u, levels[0].width);
+  EXPECT_EQ(8u, levels[0].height);
+  EXPECT_EQ(16u, levels[0].row_length);
+  ASSERT_EQ(rgba.size(), levels[0].data_size);
+  EXPECT_EQ(rgba, std::vector<u8>(levels[0].data, levels[0].data + levels[0].data_size));
+  EXPECT_EQ(8u, levels[1].width);
+  EXPECT_EQ(mip, std::vector<u8>(levels[1].data, levels[1].data + levels[1].data_size));
+
+  ASSERT_TRUE(pack->GetLevels("tex1_4x4_0000000000000002_14", &levels));
+  ASSERT_EQ(1u, levels.size());
+  EXPECT_EQ(AbstractTextureFormat::DXT1, levels[0].format);
+  EXPECT_EQ(dxt1, std::vector<u8>(levels[0].data, levels[0].data + levels[0].data_size));
+}
+
+TEST_F(HiresTexturePackTest, RejectsInvalidFiles)
+{
+  EXPECT_EQ(nullptr, HiresTexturePack::Open(m_directory + "/missing.dtp"));
+
+  const std::vector<u8> rgba(4 * 4 * 4, 0xff);
+  {
+    HiresTexturePack::Writer writer(m_pack_path);
+    ASSERT_TRUE(writer.AddTexture(
+        "tex1_4x4_0000000000000003_6",
+        {{AbstractTextureFormat::RGBA8, 4, 4, 4, rgba.data(), rgba.size()}}));
+    ASSERT_TRUE(writer.Finish());
+  }
+  ASSERT_NE(nullptr, HiresTexturePack::Open(m_pack_path));
+
+  // A pack written on a host with the other byte order can't be used in place.
+  {
+    File::IOFile file(m_pack_path, "r+b");
+    u32 magic;
+    ASSERT_TRUE(file.ReadBytes(&magic, sizeof(magic)));
+    magic = Common::swap32(magic);
+    ASSERT_TRUE(file.Seek(0, SEEK_SET));
+    ASSERT_TRUE(file.WriteBytes(&magic, sizeof(magic)));
+  }
+  EXPECT_EQ(nullptr, HiresTexturePack::Open(m_pack_path));
+  {
+    HiresTexturePack::Writer writer(m_pack_path);
+    ASSERT_TRUE(writer.AddTexture(
+        "tex1_4x4_0000000000000003_6",
+        {{AbstractTextureFormat::RGBA8, 4, 4, 4, rgba.data(), rgba.size()}}));
+    ASSERT_TRUE(writer.Finish());
+  }
+
+  // Truncating the file cuts off the index.
+  const u64 size = File::GetSize(m_pack_path);
+  {
+    File::IOFile file(m_pack_path, "r+b");
+    ASSERT_TRUE(file.Resize(size - 8));
+  }
+  EXPECT_EQ(nullptr, HiresTexturePack::Open(m_pack_path));
+}
+
+TEST_F(HiresTexturePackTest, RejectsUndersizedLevels)
+{
+  const std::vector<u8> rgba(4 * 4 * 4, 0xff);
+  const std::vector<u8> dxt5(2 * 16, 0xff);
+  {
+    HiresTexturePack::Writer writer(m_pack_path);
+    EXPECT_FALSE(writer.AddTexture(
+        "tex1_4x8_0000000000000004_6",
+        {{AbstractTextureFormat::RGBA8, 4, 8, 4, rgba.data(), rgba.size()}}));
+    EXPECT_FALSE(writer.AddTexture(
+        "tex1_8x2_0000000000000005_6",
+        {{AbstractTextureFormat::RGBA8, 8, 2, 4, rgba.data(), rgba.size()}}));
+    EXPECT_FALSE(writer.AddTexture(
+        "tex1_8x8_0000000000000006_14",
+        {{AbstractTextureFormat::DXT5, 8, 8, 8, dxt5.data(), dxt5.size()}}));
+    ASSERT_TRUE(writer.AddTexture(
+        "tex1_4x4_0000000000000003_6",
+        {{AbstractTextureFormat::RGBA8, 4, 4, 4, rgba.data(), rgba.size()}}));
+    ASSERT_TRUE(writer.Finish());
+  }
+  ASSERT_NE(nullptr, HiresTexturePack::Open(m_pack_path));
+
+  // Shrink the level's data size in the index, past what a 4x4 RGBA8 level needs.
+  {
+    File::IOFile file(m_pack_path, "r+b");
+    u64 levels_offset;
+    ASSERT_TRUE(file.Seek(24, SEEK_SET));
+    ASSERT_TRUE(file.ReadBytes(&levels_offset, sizeof(levels_offset)));
+    const u64 data_size = rgba.size() - 1;
+    ASSERT_TRUE(file.Seek(levels_offset + 24, SEEK_SET));
+    ASSERT_TRUE(file.WriteBytes(&data_size, sizeof(data_size)));
+  }
+  EXPECT_EQ(nullptr, HiresTexturePack::Open(m_pack_path));
+}
@@ -0,0 +1,84 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+
+class IndexGeneratorTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_Config.backend_info.bSupportsPrimitiveRestart = false;
+    IndexGenerator::Init();
+    IndexGenerator::Start(m_indices.data());
+  }
+
+  // Vertices of two floats, identified by the first one.
+  void Vertex(float id)
+  {
+    const float vertex[2] = {id, -id};
+    const u8* bytes = reinterpret_cast<const u8*>(vertex);
+    m_vertices.insert(m_vertices.end(), bytes, bytes + sizeof(vertex));
+  }
+
+  float VertexId(u32 index) const
+  {
+    float id;
+    std::memcpy(&id, &m_vertices[index * STRIDE], sizeof(id));
+    return id;
+  }
+
+  std::vector<u16> Indices() const
+  {
+    return std::vector<u16>(m_indices.begin(), m_indices.begin() + IndexGenerator::GetIndexLen());
+  }
+
+  static constexpr u32 STRIDE = 2 * sizeof(float);
+  std::array<u16, 64> m_indices{};
+  std::vector<u8> m_vertices;
+};
+
+TEST_F(IndexGeneratorTest, DeduplicatesTriangleList)
+{
+  // Two triangles sharing an edge, and a third one repeating the first.
+  for (float id : {0, 1, 2, 2, 1, 3, 0, 1, 2})
+    Vertex(id);
+
+  EXPECT_EQ(4u, IndexGenerator::AddDeduplicatedIndices(OpcodeDecoder::GX_DRAW_TRIANGLES, 9,
+                                                       m_vertices.data(), STRIDE));
+  EXPECT_EQ(4u, IndexGenerator::GetNumVerts());
+  EXPECT_EQ(std::vector<u16>({0, 1, 2, 2, 1, 3, 0, 1, 2}), Indices());
+  for (u32 i = 0; i < 4; i++)
+    EXPECT_EQ(static_cast<float>(i), VertexId(i));
+}
+
+TEST_F(IndexGeneratorTest, DeduplicatedIndicesFollowEarlierDraws)
+{
+  for (float id : {5, 6, 7})
+    Vertex(id);
+  IndexGenerator::AddIndices(OpcodeDecoder::GX_DRAW_TRIANGLES, 3);
+
+  // A quad whose last vertex repeats its first, which is also in the previous draw. Only the
+  // current draw is deduplicated.
+  const size_t quad = m_vertices.size();
+  for (float id : {5, 8, 9, 5})
+    Vertex(id);
+
+  EXPECT_EQ(3u, IndexGenerator::AddDeduplicatedIndices(OpcodeDecoder::GX_DRAW_QUADS, 4,
+                                                       m_vertices.data() + quad, STRIDE));
+  EXPECT_EQ(6u, IndexGenerator::GetNumVerts());
+  EXPECT_EQ(std::vector<u16>({0, 1, 2, 3, 4, 5, 3, 5, 3}), Indices());
+  EXPECT_EQ(5.f, VertexId(3));
+  EXPECT_EQ(8.f, VertexId(4));
+  EXPECT_EQ(9.f, VertexId(5));
+}
@@ -0,0 +1,189 @@
+// Copyright 2017 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/OpcodeDecoding.h"
+
+// Only the preprocessing variant of the decoder is used here, as it doesn't need a video backend.
+// It goes through the same command loop, but skips XF loads and ignores most BP loads.
+class OpcodeDecoderTest : public testing::Test
+{
+protected:
+  void CP(u8 sub_cmd, u32 value)
+  {
+    m_fifo.push_back(OpcodeDecoder::GX_LOAD_CP_REG);
+    m_fifo.push_back(sub_cmd);
+    U32(value);
+    m_commands++;
+  }
+
+  void BP(u8 reg, u32 value)
+  {
+    m_fifo.push_back(OpcodeDecoder::GX_LOAD_BP_REG);
+    U32(u32(reg) << 24 | (value & 0xFFFFFF));
+    m_commands++;
+  }
+
+  void XF(u16 address, u32 count)
+  {
+    m_fifo.push_back(OpcodeDecoder::GX_LOAD_XF_REG);
+    U32((count - 1) << 16 | address);
+    for (u32 i = 0; i < count; i++)
+      U32(i);
+    m_commands++;
+  }
+
+  void Draw(u16 vertices, u32 vertex_size)
+  {
+    m_fifo.push_back(0x80 | OpcodeDecoder::GX_DRAW_TRIANGLES << OpcodeDecoder::GX_PRIMITIVE_SHIFT);
+    m_fifo.push_back(vertices >> 8);
+    m_fifo.push_back(vertices & 0xFF);
+    m_fifo.insert(m_fifo.end(), vertices * vertex_size, 0);
+    m_commands++;
+  }
+
+  void U32(u32 value)
+  {
+    for (int shift = 24; shift >= 0; shift -= 8)
+      m_fifo.push_back(static_cast<u8>(value >> shift));
+  }
+
+  // Returns the number of bytes consumed.
+  size_t Run(size_t size, u32* cycles)
+  {
+    u8* start = m_fifo.data();
+    return OpcodeDecoder::Run<true>(DataReader(start, start + size), cycles, false) - start;
+  }
+
+  std::vector<u8> m_fifo;
+  u64 m_commands = 0;
+};
+
+TEST_F(OpcodeDecoderTest, RegisterLoadRuns)
+{
+  for (int i = 0; i < 10; i++)
+    BP(BPMEM_TEV_COLOR_RA + 2 * (i % 4), i);
+  XF(0x1000, 1);
+  XF(0x0000, 16);
+  XF(0x0400, 3);
+  m_fifo.push_back(OpcodeDecoder::GX_NOP);
+  BP(BPMEM_TEV_KSEL, 0);
+  XF(0x1008, 2);
+
+  u32 cycles = 0;
+  EXPECT_EQ(m_fifo.size(), Run(m_fifo.size(), &cycles));
+  EXPECT_EQ(10u * 12 + (18 + 6 * 1) + (18 + 6 * 16) + (18 + 6 * 3) + 6 + 12 + (18 + 6 * 2),
+            cycles);
+}
+
+TEST_F(OpcodeDecoderTest, TruncatedRuns)
+{
+  BP(BPMEM_TEV_COLOR_RA, 1);
+  BP(BPMEM_TEV_COLOR_RA, 2);
+  const size_t first_xf = m_fifo.size();
+  XF(0x0000, 4);
+  const size_t second_xf = m_fifo.size();
+  XF(0x0010, 8);
+  const size_t end = m_fifo.size();
+  BP(BPMEM_TEV_COLOR_RA, 3);
+
+  // A partial command stops the run at its start, and everything before it is executed.
+  for (size_t size = second_xf; size < end; size++)
+  {
+    u32 cycles = 0;
+    EXPECT_EQ(second_xf, Run(size, &cycles));
+    EXPECT_EQ(2u * 12 + 18 + 6 * 4, cycles);
+  }
+
+  u32 cycles = 0;
+  EXPECT_EQ(first_xf, Run(first_xf + 3, &cycles));
+  EXPECT_EQ(2u * 12, cycles);
+
+  EXPECT_EQ(first_xf - 5, Run(first_xf - 1, &cycles));
+  EXPECT_EQ(12u, cycles);
+}
+
+static void RunBenchmark(const std::vector<std::vector<u8>>& frames, u64 commands_per_pass)
+{
+  size_t bytes = 0;
+  for (const auto& frame : frames)
+    bytes += frame.size();
+
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed;
+  u64 passes = 0;
+  do
+  {
+    for (const auto& frame : frames)
+    {
+      u8* data = const_cast<u8*>(frame.data());
+      OpcodeDecoder::Run<true>(DataReader(data, data + frame.size()), nullptr, false);
+    }
+    passes++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed.count() < 2.0);
+
+  std::printf("%.1f MB/s", passes * bytes / elapsed.count() / (1024 * 1024));
+  if (commands_per_pass)
+    std::printf(", %.1f M commands/s", passes * commands_per_pass / elapsed.count() / 1000000);
+  std::printf("\n");
+}
+
+// Run with --gtest_also_run_disabled_tests. Set DOLPHIN_FIFO_LOG to a .dff file to replay a real
+// FIFO log instead of the synthetic stream.
+TEST_F(OpcodeDecoderTest, DISABLED_Benchmark)
+{
+  const char* path = std::getenv("DOLPHIN_FIFO_LOG");
+  if (path)
+  {
+    std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(path, false);
+    ASSERT_NE(nullptr, file);
+
+    const u32* cp_mem = file->GetCPMem();
+    LoadCPReg(0x50, cp_mem[0x50], true);
+    LoadCPReg(0x60, cp_mem[0x60], true);
+    for (u8 i = 0; i < 8; i++)
+    {
+      LoadCPReg(0x70 + i, cp_mem[0x70 + i], true);
+      LoadCPReg(0x80 + i, cp_mem[0x80 + i], true);
+      LoadCPReg(0x90 + i, cp_mem[0x90 + i], true);
+    }
+
+    std::vector<std::vector<u8>> frames;
+    for (u32 i = 0; i < file->GetFrameCount(); i++)
+      frames.push_back(file->GetFrame(i).fifoData);
+    RunBenchmark(frames, 0);
+    return;
+  }
+
+  // Direct float positions, 12 bytes per vertex.
+  CP(0x50, DIRECT << 9);
+  CP(0x70, 1 | FORMAT_FLOAT << 1);
+
+  // Roughly what games send per object: a burst of TEV and matrix state, then a small draw.
+  for (int object = 0; object < 10000; object++)
+  {
+    for (int i = 0; i < 16; i++)
+      BP(BPMEM_TEV_COLOR_ENV + i, object + i);
+    XF(0x0000, 12);
+    XF(0x0400, 9);
+    XF(0x1018, 1);
+    BP(BPMEM_GENMODE, 0);
+    Draw(36, 12);
+  }
+
+  RunBenchmark({m_fifo}, m_commands);
+}
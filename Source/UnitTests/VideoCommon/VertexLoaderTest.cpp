@@ -12,9 +12,11 @@
 
 #include "Common/Common.h"
 #include "Common/MathUtil.h"
+#include "Common/Swap.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VertexLoader.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 
@@ -245,6 +247,84 @@ TEST_F(VertexLoaderTest, PositionIndex16FloatXY)
   ExpectOut(2);
 }
 
+TEST_F(VertexLoaderTest, SpecializedDirect)
+{
+  m_vtx_desc.Position = DIRECT;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_FLOAT;
+  m_vtx_desc.Color0 = DIRECT;
+  m_vtx_attr.g0.Color0Elements = 1;  // Has Alpha
+  m_vtx_attr.g0.Color0Comp = FORMAT_32B_8888;
+  m_vtx_desc.Tex0Coord = DIRECT;
+  m_vtx_attr.g0.Tex0CoordElements = 1;  // ST
+  m_vtx_attr.g0.Tex0CoordFormat = FORMAT_FLOAT;
+
+  VertexLoader loader(m_vtx_desc, m_vtx_attr);
+  ASSERT_TRUE(loader.IsSpecialized());
+  ASSERT_EQ(3 * 4 + 4 + 2 * 4, loader.m_VertexSize);
+  ASSERT_EQ(3 * 4 + 4 + 2 * 4, loader.m_native_vtx_decl.stride);
+
+  for (int i = 0; i < 2; i++)
+  {
+    Input(1.f + i);
+    Input(2.f + i);
+    Input(3.f + i);
+    Input<u32>(0x11223344 + i);
+    Input(4.f + i);
+    Input(5.f + i);
+  }
+
+  ResetPointers();
+  EXPECT_EQ(2, loader.RunVertices(m_src, m_dst, 2));
+  for (int i = 0; i < 2; i++)
+  {
+    ExpectOut(1.f + i);
+    ExpectOut(2.f + i);
+    ExpectOut(3.f + i);
+    // Colors are copied as bytes, so they end up swapped compared to the input.
+    EXPECT_EQ(Common::swap32(0x11223344 + i), (m_dst.Read<u32, false>()));
+    ExpectOut(4.f + i);
+    ExpectOut(5.f + i);
+  }
+}
+
+TEST_F(VertexLoaderTest, SpecializedIndexedSkipsVertices)
+{
+  m_vtx_desc.Position = INDEX16;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_SHORT;
+  m_vtx_attr.g0.PosFrac = 1;
+  m_vtx_desc.Tex0Coord = INDEX16;
+  m_vtx_attr.g0.Tex0CoordElements = 1;  // ST
+  m_vtx_attr.g0.Tex0CoordFormat = FORMAT_SHORT;
+  m_vtx_attr.g0.Tex0Frac = 2;
+
+  VertexLoader loader(m_vtx_desc, m_vtx_attr);
+  ASSERT_TRUE(loader.IsSpecialized());
+  ASSERT_EQ(2 * 2, loader.m_VertexSize);
+
+  // The middle vertex has the position index 0xFFFF, so it's dropped.
+  Input<u16>(1);
+  Input<u16>(0);
+  Input<u16>(0xFFFF);
+  Input<u16>(0);
+  Input<u16>(0);
+  Input<u16>(1);
+  VertexLoaderManager::cached_arraybases[ARRAY_POSITION] = m_src.GetPointer();
+  g_main_cp_state.array_strides[ARRAY_POSITION] = 3 * sizeof(s16);
+  for (s16 value : {2, 4, 6, -2, -4, -6})
+    Input(value);
+  VertexLoaderManager::cached_arraybases[ARRAY_TEXCOORD0] = m_src.GetPointer();
+  g_main_cp_state.array_strides[ARRAY_TEXCOORD0] = 2 * sizeof(s16);
+  for (s16 value : {4, 8, -4, -8})
+    Input(value);
+
+  ResetPointers();
+  EXPECT_EQ(2, loader.RunVertices(m_src, m_dst, 3));
+  for (float value : {-1.f, -2.f, -3.f, 1.f, 2.f, 1.f, 2.f, 3.f, -1.f, -2.f})
+    ExpectOut(value);
+}
+
 class VertexLoaderSpeedTest : public VertexLoaderTest,
                               public ::testing::WithParamInterface<std::tuple<int, int>>
 {